@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+#define PL_BENCHMARK(name) \
+void name(::std::size_t iterations); \
+::pl_bench::BenchmarkRegistration const name##_registration(#name, name); \
+void name(::std::size_t iterations)
+
+// A benchmark run once per argument from 1 to maxArgument(), where maxArgument is a function.
+#define PL_BENCHMARK_RANGE(name, maxArgument) \
+void name(::std::size_t iterations, ::std::size_t argument); \
+::pl_bench::BenchmarkRegistration const name##_registration(#name, name, maxArgument); \
+void name(::std::size_t iterations, ::std::size_t argument)
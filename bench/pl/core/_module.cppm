@@ -0,0 +1,4 @@
+export module pl.core.bench;
+
+export import :fixtures;
+export import :harness;
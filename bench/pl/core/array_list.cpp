@@ -0,0 +1,112 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numElements       = 4096;
+constexpr std::size_t numInsertElements = 512;
+constexpr std::size_t capacityStep      = 64;
+
+PL_BENCHMARK(bench_arrayListPushBack)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        ArrayList<std::uint64_t> arr;
+        for (std::size_t k = 0; k < numElements; ++k) (void) arr.push_back(k);
+        doNotOptimize(arr.data());
+    }
+}
+
+PL_BENCHMARK(bench_vectorPushBack)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::uint64_t> vec;
+        for (std::size_t k = 0; k < numElements; ++k) vec.push_back(k);
+        doNotOptimize(vec.data());
+    }
+}
+
+// Every insertion shifts all the elements already inserted.
+PL_BENCHMARK(bench_arrayListInsertFront)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        ArrayList<std::uint64_t> arr;
+        for (std::uint64_t k = 0; k < numInsertElements; ++k) (void) arr.insert(arr.begin(), &k, &k + 1);
+        doNotOptimize(arr.data());
+    }
+}
+
+PL_BENCHMARK(bench_vectorInsertFront)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::uint64_t> vec;
+        for (std::uint64_t k = 0; k < numInsertElements; ++k) vec.insert(vec.begin(), k);
+        doNotOptimize(vec.data());
+    }
+}
+
+PL_BENCHMARK(bench_arrayListResize)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        ArrayList<std::uint64_t> arr;
+        (void) arr.resize(numElements);
+        doNotOptimize(arr.data());
+    }
+}
+
+PL_BENCHMARK(bench_vectorResize)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::uint64_t> vec;
+        vec.resize(numElements);
+        doNotOptimize(vec.data());
+    }
+}
+
+// Grows the capacity in small exact steps, so that every step reallocates a full list.
+// ArrayList relocates trivially relocatable elements with realloc, which can often extend in place.
+PL_BENCHMARK(bench_arrayListReallocate)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        ArrayList<std::uint64_t> arr;
+        (void) arr.resize(numElements / 4);
+        while (arr.capacity() < numElements)
+        {
+            (void) arr.reserve_capacity_exact(arr.capacity() + capacityStep);
+            doNotOptimize(arr.data());
+        }
+    }
+}
+
+PL_BENCHMARK(bench_vectorReallocate)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::uint64_t> vec;
+        vec.resize(numElements / 4);
+        while (vec.capacity() < numElements)
+        {
+            vec.reserve(vec.capacity() + capacityStep);
+            doNotOptimize(vec.data());
+        }
+    }
+}
+} // namespace
+} // namespace pl_bench
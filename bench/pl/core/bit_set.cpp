@@ -0,0 +1,105 @@
+module;
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numBits = 1 << 20;
+
+// Roughly one bit in eight is set, scattered so that most words are neither empty nor full.
+DynamicBitSet<> makeBits(std::uint64_t seed) noexcept
+{
+    DynamicBitSet<> bits;
+    (void) bits.resize(numBits);
+    std::uint64_t x = seed;
+    for (std::size_t i = 0; i < numBits / 8; ++i)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        bits.set(std::size_t(x >> 44));
+    }
+    return bits;
+}
+
+template<class Body>
+void withIsa(simd::Isa isa, Body &&body) noexcept
+{
+    simd::Isa previous = simd::activeIsa();
+    (void) simd::setIsa(isa);
+    body();
+    (void) simd::setIsa(previous);
+}
+
+PL_BENCHMARK(bench_bitSetCountLoop)
+{
+    DynamicBitSet<> bits = makeBits(1);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t count = 0;
+        for (std::uint64_t word : bits.words()) count += std::size_t(std::popcount(word));
+        doNotOptimize(count);
+    }
+}
+
+PL_BENCHMARK(bench_bitSetCountSse2)
+{
+    DynamicBitSet<> bits = makeBits(1);
+    withIsa(simd::Isa::sse2, [&]
+    {
+        for (std::size_t i = 0; i < iterations; ++i) doNotOptimize(bits.count());
+    });
+}
+
+PL_BENCHMARK(bench_bitSetCountAvx2)
+{
+    DynamicBitSet<> bits = makeBits(1);
+    withIsa(simd::Isa::avx2, [&]
+    {
+        for (std::size_t i = 0; i < iterations; ++i) doNotOptimize(bits.count());
+    });
+}
+
+PL_BENCHMARK(bench_bitSetSetBits)
+{
+    DynamicBitSet<> bits = makeBits(1);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t sum = 0;
+        for (std::size_t bit : bits.set_bits()) sum += bit;
+        doNotOptimize(sum);
+    }
+}
+
+PL_BENCHMARK(bench_bitSetFindNext)
+{
+    DynamicBitSet<> bits = makeBits(1);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t sum = 0;
+        for (std::size_t bit = bits.find_first(); bit != bits.npos; bit = bits.find_next(bit + 1)) sum += bit;
+        doNotOptimize(sum);
+    }
+}
+
+PL_BENCHMARK(bench_bitSetAnd)
+{
+    DynamicBitSet<> a = makeBits(1);
+    DynamicBitSet<> b = makeBits(2);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        a &= b;
+        a |= b;
+        doNotOptimize(a.words().data());
+    }
+}
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,121 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t queueCapacity     = 1024;
+constexpr std::size_t itemsPerIteration = 4096;
+constexpr unsigned    maxThreadPairs    = 4;
+
+// Throughput: one thread pushes while another pops, spinning whenever the queue is full or empty.
+PL_BENCHMARK(bench_spscQueueThroughput)
+{
+    SPSCQueue<std::uint64_t> queue;
+    (void) queue.init(queueCapacity);
+    std::size_t const count = iterations * itemsPerIteration;
+
+    std::thread consumer([&]
+    {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < count;)
+        {
+            if (Opt<std::uint64_t> value = queue.try_pop(); value)
+            {
+                sum += *value;
+                ++i;
+            }
+        }
+        doNotOptimize(sum);
+    });
+
+    for (std::size_t i = 0; i < count;)
+    {
+        if (queue.try_push(i)) ++i;
+    }
+    consumer.join();
+}
+
+// Latency: a message bounces between two threads through a pair of queues, one round trip per item.
+PL_BENCHMARK(bench_spscQueueRoundTrip)
+{
+    SPSCQueue<std::uint64_t> ping;
+    SPSCQueue<std::uint64_t> pong;
+    (void) ping.init(queueCapacity);
+    (void) pong.init(queueCapacity);
+    std::size_t const count = iterations * 64;
+
+    std::thread echo([&]
+    {
+        for (std::size_t i = 0; i < count;)
+        {
+            if (Opt<std::uint64_t> value = ping.try_pop(); value)
+            {
+                while (!pong.try_push(*value));
+                ++i;
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        while (!ping.try_push(i));
+        Opt<std::uint64_t> value;
+        do value = pong.try_pop();
+        while (!value);
+        doNotOptimize(*value);
+    }
+    echo.join();
+}
+
+// Throughput under contention: numPairs producers and numPairs consumers share one queue.
+// Every producer pushes the same number of items, so the total work grows with the number of threads.
+void mpmcThroughput(std::size_t iterations, unsigned numPairs)
+{
+    MPMCQueue<std::uint64_t> queue;
+    (void) queue.init(queueCapacity);
+    std::size_t const count = iterations * itemsPerIteration;
+
+    std::thread threads[2 * maxThreadPairs];
+    for (unsigned t = 0; t < numPairs; ++t)
+    {
+        threads[2 * t] = std::thread([&]
+        {
+            for (std::size_t i = 0; i < count;)
+            {
+                if (queue.try_push(i)) ++i;
+            }
+        });
+        threads[2 * t + 1] = std::thread([&]
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < count;)
+            {
+                if (Opt<std::uint64_t> value = queue.try_pop(); value)
+                {
+                    sum += *value;
+                    ++i;
+                }
+            }
+            doNotOptimize(sum);
+        });
+    }
+    for (unsigned t = 0; t < 2 * numPairs; ++t)
+        threads[t].join();
+}
+
+PL_BENCHMARK(bench_mpmcQueueThroughput1Pair)  { mpmcThroughput(iterations, 1); }
+PL_BENCHMARK(bench_mpmcQueueThroughput2Pairs) { mpmcThroughput(iterations, 2); }
+PL_BENCHMARK(bench_mpmcQueueThroughput4Pairs) { mpmcThroughput(iterations, 4); }
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,22 @@
+module;
+#include <cstddef>
+
+export module pl.core.bench:fixtures;
+
+import pl.core;
+
+export namespace pl_bench
+{
+// Starting threads costs far more than an iteration, so the job system is kept across runs,
+// and only restarted when the number of threads changes, which the untimed first run of a benchmark does.
+inline pl::JobSystem &jobSystem(std::size_t numThreads)
+{
+    static pl::JobSystem jobs;
+    if (jobs.numWorkers() != numThreads)
+    {
+        jobs.deinit();
+        (void) jobs.init(numThreads);
+    }
+    return jobs;
+}
+} // export namespace pl_bench
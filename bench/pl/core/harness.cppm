@@ -0,0 +1,295 @@
+module;
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#endif
+
+export module pl.core.bench:harness;
+
+namespace pl_bench_
+{
+using Clock = std::chrono::steady_clock;
+
+#if defined(__x86_64__) || defined(__i386__)
+constexpr char const *cycleCounterName = "rdtsc";
+#elif defined(__aarch64__)
+constexpr char const *cycleCounterName = "cntvct_el0";
+#else
+constexpr char const *cycleCounterName = "steady_clock";
+#endif
+
+// Reads the cheapest monotonic tick counter of the CPU.
+// On x86 it counts reference cycles, which tick at a constant rate regardless of frequency scaling.
+[[nodiscard]]
+inline std::uint64_t readCycleCounter() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<std::uint64_t>(Clock::now().time_since_epoch().count());
+#endif
+}
+
+struct Statistics
+{
+    double median;
+    double p99;
+    double min;
+};
+
+// Sorts samples in place.
+[[nodiscard]]
+inline Statistics summarize(double *samples, std::size_t count) noexcept
+{
+    std::sort(samples, samples + count);
+    double median = count % 2
+        ? samples[count / 2]
+        : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+    // Nearest rank.
+    std::size_t p99Rank = (99 * count + 99) / 100;
+    return {median, samples[p99Rank - 1], samples[0]};
+}
+
+inline void writeJson(std::ostream &os, Statistics const &s)
+{
+    os << "{\"median\": " << s.median << ", \"p99\": " << s.p99 << ", \"min\": " << s.min << '}';
+}
+
+// What the running benchmark spent between pauseTiming and resumeTiming, which is not measured.
+struct PausedTime
+{
+    Clock::duration   duration;
+    std::uint64_t     cycles;
+    Clock::time_point pausedAt;
+    std::uint64_t     pausedAtCycle;
+};
+
+inline constinit PausedTime pausedTime = {};
+} // namespace pl_bench_
+
+export namespace pl_bench
+{
+// Prevents the compiler from optimizing away the computation of value.
+template<class T>
+inline void doNotOptimize(T const &value) noexcept
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Stops measuring the running benchmark until resumeTiming, so that the body can build the state it measures
+// without timing it, or reset it between iterations:
+//
+//     pauseTiming();
+//     HashMap<K, V> map = filledMap();
+//     resumeTiming();
+//
+// Each pause reads the clocks twice, which is not free, so it should surround setup that takes
+// well over a microsecond. Timing must be resumed before the body returns.
+inline void pauseTiming() noexcept
+{
+    pl_bench_::pausedTime.pausedAt      = pl_bench_::Clock::now();
+    pl_bench_::pausedTime.pausedAtCycle = pl_bench_::readCycleCounter();
+}
+
+inline void resumeTiming() noexcept
+{
+    std::uint64_t cycle = pl_bench_::readCycleCounter();
+    auto          now   = pl_bench_::Clock::now();
+    pl_bench_::pausedTime.duration += now - pl_bench_::pausedTime.pausedAt;
+    pl_bench_::pausedTime.cycles   += cycle - pl_bench_::pausedTime.pausedAtCycle;
+}
+
+class BenchmarkRegistration
+{
+public:
+    using Function      = void (*)(std::size_t iterations);
+    // Runs once per argument from 1 to maxArgument(), which is only called when benchmarks run,
+    // so it may depend on the machine.
+    using RangeFunction = void (*)(std::size_t iterations, std::size_t argument);
+    using MaxArgument   = std::size_t (*)();
+
+    BenchmarkRegistration(char const *name, Function function) noexcept
+    :
+        _name(name),
+        _function(function),
+        _next(std::exchange(head(), this))
+    {}
+
+    BenchmarkRegistration(char const *name, RangeFunction function, MaxArgument maxArgument) noexcept
+    :
+        _name(name),
+        _rangeFunction(function),
+        _maxArgument(maxArgument),
+        _next(std::exchange(head(), this))
+    {}
+
+    BenchmarkRegistration           (BenchmarkRegistration const &) = delete;
+    BenchmarkRegistration &operator=(BenchmarkRegistration const &) = delete;
+
+    [[nodiscard]] char const            *name()          const noexcept { return _name;          }
+    // Null for range benchmarks.
+    [[nodiscard]] Function               function()      const noexcept { return _function;      }
+    [[nodiscard]] RangeFunction          rangeFunction() const noexcept { return _rangeFunction; }
+    [[nodiscard]] MaxArgument            maxArgument()   const noexcept { return _maxArgument;   }
+    [[nodiscard]] BenchmarkRegistration *next()          const noexcept { return _next;          }
+
+    // Registrations are linked intrusively, so registering a benchmark never allocates.
+    [[nodiscard]]
+    static BenchmarkRegistration *&head() noexcept
+    {
+        static BenchmarkRegistration *head = nullptr;
+        return head;
+    }
+
+private:
+    char const            *_name;
+    Function               _function      = nullptr;
+    RangeFunction          _rangeFunction = nullptr;
+    MaxArgument            _maxArgument   = nullptr;
+    BenchmarkRegistration *_next;
+};
+
+constexpr std::size_t maxRepetitions = 101;
+
+struct Options
+{
+    // Only benchmarks whose name contains filter are run.
+    std::string_view         filter;
+    // Iterations are calibrated so that a single repetition takes at least this long.
+    std::chrono::nanoseconds minRepetitionTime = std::chrono::milliseconds(5);
+    std::size_t              maxIterations     = std::size_t(1) << 24;
+    // At most maxRepetitions.
+    std::size_t              repetitions       = 15;
+};
+
+} // export namespace pl_bench
+
+namespace pl_bench_
+{
+// Runs a single benchmark, where run(iterations) runs its body, and appends its results to out.
+template<class F>
+void runBenchmark(
+    std::string_view name, F run, std::size_t repetitions,
+    pl_bench::Options const &options, bool &first, std::ostream &out, std::ostream &log)
+{
+    // Untimed, so that state the benchmark builds lazily, like a pool of threads, is never measured.
+    run(0);
+
+    std::size_t iterations = 1;
+    while (true)
+    {
+        pausedTime = {};
+        auto start = Clock::now();
+        run(iterations);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start - pausedTime.duration);
+        if (elapsed >= options.minRepetitionTime || iterations >= options.maxIterations) break;
+
+        // Aim slightly past the target, so that noise rarely needs another round.
+        double scale = elapsed.count() > 0
+            ? 1.2 * double(options.minRepetitionTime.count()) / double(elapsed.count())
+            : 10.0;
+        auto next = static_cast<std::size_t>(double(iterations) * std::clamp(scale, 1.5, 10.0));
+        iterations = std::min(next, options.maxIterations);
+    }
+
+    double nanoseconds[pl_bench::maxRepetitions];
+    double cycles[pl_bench::maxRepetitions];
+    for (std::size_t r = 0; r < repetitions; ++r)
+    {
+        pausedTime = {};
+        auto          start      = Clock::now();
+        std::uint64_t startCycle = readCycleCounter();
+        run(iterations);
+        std::uint64_t endCycle   = readCycleCounter();
+        auto          elapsed    = std::chrono::duration<double, std::nano>(Clock::now() - start - pausedTime.duration);
+
+        nanoseconds[r] = elapsed.count() / double(iterations);
+        cycles[r]      = double(endCycle - startCycle - pausedTime.cycles) / double(iterations);
+    }
+
+    Statistics ns = summarize(nanoseconds, repetitions);
+    Statistics cy = summarize(cycles,      repetitions);
+
+    out << (first ? "\n" : ",\n")
+        << "    {\n"
+        << "      \"name\": \"" << name << "\", "
+        << "\"iterations\": " << iterations << ", "
+        << "\"repetitions\": " << repetitions << ",\n"
+        << "      \"ns_per_iteration\": ";
+    writeJson(out, ns);
+    out << ",\n      \"cycles_per_iteration\": ";
+    writeJson(out, cy);
+    out << "\n    }";
+    first = false;
+
+    log << name << ": " << ns.median << " ns/iteration (p99 " << ns.p99 << "), "
+        << cy.median << " cycles/iteration\n";
+}
+} // namespace pl_bench_
+
+export namespace pl_bench
+{
+// Runs every registered benchmark, and writes the results to out as JSON:
+//
+//     {
+//       "cycle_counter": "rdtsc",
+//       "benchmarks": [
+//         {
+//           "name": "bench_x", "iterations": 4096, "repetitions": 15,
+//           "ns_per_iteration":     {"median": ..., "p99": ..., "min": ...},
+//           "cycles_per_iteration": {"median": ..., "p99": ..., "min": ...}
+//         }
+//       ]
+//     }
+//
+// Each benchmark is first run once without iterations and untimed, then with growing iteration counts,
+// which both warms up caches and lazily initialized state, and calibrates the iteration count to
+// minRepetitionTime. Time spent between pauseTiming and resumeTiming counts towards neither. The calibrated count is then timed repetitions times. Progress is reported to log.
+//
+// Range benchmarks run once per argument, and are named like bench_x/4.
+// Benchmark names are C++ identifiers, so names never need escaping.
+inline void runBenchmarks(Options const &options, std::ostream &out, std::ostream &log)
+{
+    using namespace pl_bench_;
+
+    std::size_t repetitions = std::clamp(options.repetitions, std::size_t(1), maxRepetitions);
+
+    out << "{\n  \"cycle_counter\": \"" << cycleCounterName << "\",\n  \"benchmarks\": [";
+    bool first = true;
+    for (auto *b = BenchmarkRegistration::head(); b; b = b->next())
+    {
+        if (auto function = b->function())
+        {
+            if (std::string_view(b->name()).find(options.filter) == std::string_view::npos) continue;
+            runBenchmark(b->name(), function, repetitions, options, first, out, log);
+            continue;
+        }
+
+        std::size_t maxArgument = b->maxArgument()();
+        for (std::size_t argument = 1; argument <= maxArgument; ++argument)
+        {
+            std::string name = std::string(b->name()) + '/' + std::to_string(argument);
+            if (name.find(options.filter) == std::string::npos) continue;
+
+            auto run = [function = b->rangeFunction(), argument](std::size_t iterations)
+            {
+                function(iterations, argument);
+            };
+            runBenchmark(name, run, repetitions, options, first, out, log);
+        }
+    }
+    out << "\n  ]\n}\n";
+}
+} // export namespace pl_bench
@@ -0,0 +1,134 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numKeys = 16 * 1024;
+
+[[nodiscard]]
+std::uint64_t keyOf(std::size_t i) noexcept
+{
+    return i * 0x9e3779b97f4a7c15ull;
+}
+
+PL_BENCHMARK(bench_hashMapInsert)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        HashMap<std::uint64_t, std::uint64_t> map;
+        for (std::size_t k = 0; k < numKeys; ++k) (void) map.try_emplace(keyOf(k), k);
+        doNotOptimize(map.size());
+    }
+}
+
+PL_BENCHMARK(bench_unorderedMapInsert)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::unordered_map<std::uint64_t, std::uint64_t> map;
+        for (std::size_t k = 0; k < numKeys; ++k) map.try_emplace(keyOf(k), k);
+        doNotOptimize(map.size());
+    }
+}
+
+// The benchmarks below only read the map, so it is filled, and destroyed, with timing paused.
+
+// Half of the lookups hit, and half miss.
+PL_BENCHMARK(bench_hashMapFind)
+{
+    pauseTiming();
+    {
+        HashMap<std::uint64_t, std::uint64_t> map;
+        for (std::size_t k = 0; k < numKeys; k += 2) (void) map.try_emplace(keyOf(k), k);
+        resumeTiming();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t k = 0; k < numKeys; ++k)
+            {
+                if (auto value = map.get(keyOf(k))) sum += **value;
+            }
+            doNotOptimize(sum);
+        }
+
+        pauseTiming();
+    }
+    resumeTiming();
+}
+
+PL_BENCHMARK(bench_unorderedMapFind)
+{
+    pauseTiming();
+    {
+        std::unordered_map<std::uint64_t, std::uint64_t> map;
+        for (std::size_t k = 0; k < numKeys; k += 2) map.try_emplace(keyOf(k), k);
+        resumeTiming();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t k = 0; k < numKeys; ++k)
+            {
+                if (auto it = map.find(keyOf(k)); it != map.end()) sum += it->second;
+            }
+            doNotOptimize(sum);
+        }
+
+        pauseTiming();
+    }
+    resumeTiming();
+}
+
+PL_BENCHMARK(bench_hashMapIterate)
+{
+    pauseTiming();
+    {
+        HashMap<std::uint64_t, std::uint64_t> map;
+        for (std::size_t k = 0; k < numKeys; ++k) (void) map.try_emplace(keyOf(k), k);
+        resumeTiming();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::uint64_t sum = 0;
+            for (auto &[key, value] : map) sum += value;
+            doNotOptimize(sum);
+        }
+
+        pauseTiming();
+    }
+    resumeTiming();
+}
+
+PL_BENCHMARK(bench_unorderedMapIterate)
+{
+    pauseTiming();
+    {
+        std::unordered_map<std::uint64_t, std::uint64_t> map;
+        for (std::size_t k = 0; k < numKeys; ++k) map.try_emplace(keyOf(k), k);
+        resumeTiming();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::uint64_t sum = 0;
+            for (auto &[key, value] : map) sum += value;
+            doNotOptimize(sum);
+        }
+
+        pauseTiming();
+    }
+    resumeTiming();
+}
+} // namespace
+} // namespace pl_bench
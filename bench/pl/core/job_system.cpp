@@ -0,0 +1,59 @@
+module;
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numElements = 256 * 1024;
+
+// Every benchmark runs with 1 up to one thread per hardware thread.
+std::size_t maxThreads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// The same amount of work split across the workers,
+// so perfect scaling divides the time per iteration by the number of threads.
+PL_BENCHMARK_RANGE(bench_parallelFor, maxThreads)
+{
+    JobSystem &jobs = jobSystem(argument);
+
+    ArrayList<float> values;
+    (void) values.resize(numElements);
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        (void) jobs.parallel_for(Span<float>(values.data(), values.size()), [](float &v)
+        {
+            v = std::sqrt(v * v + 1.0f) * 0.5f;
+        });
+        doNotOptimize(values.data());
+    }
+}
+
+// Many tiny jobs, which measures the overhead of submitting, stealing and waiting.
+PL_BENCHMARK_RANGE(bench_tinyJobs, maxThreads)
+{
+    JobSystem &jobs = jobSystem(argument);
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        JobCounter counter;
+        for (std::size_t j = 0; j < 256; ++j)
+            (void) jobs.submit(counter, [j] { doNotOptimize(j); });
+        (void) jobs.wait(counter);
+    }
+}
+} // namespace
+} // namespace pl_bench
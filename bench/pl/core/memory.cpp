@@ -0,0 +1,195 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numAllocsPerIteration = 256;
+constexpr std::size_t allocSize = 48;
+
+template<allocator A>
+void allocFree(A a, void (*afterFree)(A &))
+{
+    auto size      = makeNonZero_Unchecked(allocSize);
+    auto alignment = makeNonZero_Unchecked(alignof(std::max_align_t));
+
+    void *memory[numAllocsPerIteration];
+    for (auto &m : memory)
+    {
+        m = *a.alloc(size, alignment);
+        doNotOptimize(m);
+    }
+    // Free in FIFO order, so that the arena cannot reclaim anything before reset.
+    for (auto m : memory)
+        a.free(makeNonNull_Unchecked(m), size, alignment);
+    afterFree(a);
+}
+
+PL_BENCHMARK(bench_mallocatorAllocFree)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+        allocFree(Mallocator(), +[](Mallocator &) {});
+}
+
+PL_BENCHMARK(bench_arenaAllocReset)
+{
+    Arena<> arena(numAllocsPerIteration * allocSize * 2);
+    for (std::size_t i = 0; i < iterations; ++i)
+        allocFree(ArenaAllocator(arena), +[](ArenaAllocator<> &a) { a.arena().reset(); });
+}
+
+template<allocator A>
+void pushBack(A a)
+{
+    ArrayList<std::size_t, A> arr(a);
+    for (std::size_t i = 0; i < numAllocsPerIteration; ++i)
+        (void) arr.push_back(i);
+    doNotOptimize(arr.data());
+}
+
+PL_BENCHMARK(bench_mallocatorArrayListPushBack)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+        pushBack(Mallocator());
+}
+
+struct BenchmarkAllocations
+{
+    static constexpr char const name[] = "benchmark";
+};
+
+PL_BENCHMARK(bench_trackingArrayListPushBack)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+        pushBack(TrackingAllocator<Mallocator, BenchmarkAllocations>());
+}
+
+PL_BENCHMARK(bench_arenaArrayListPushBack)
+{
+    Arena<> arena(numAllocsPerIteration * sizeof(std::size_t) * 4);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        pushBack(ArenaAllocator(arena));
+        arena.reset();
+    }
+}
+
+// A short list, as is typical of most lists in the renderer.
+PL_BENCHMARK(bench_arrayListPushBackFew)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        ArrayList<std::size_t> arr;
+        for (std::size_t j = 0; j < 4; ++j) (void) arr.push_back(j);
+        doNotOptimize(arr.data());
+    }
+}
+
+PL_BENCHMARK(bench_smallArrayListPushBackFew)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        SmallArrayList<std::size_t, 4> arr;
+        for (std::size_t j = 0; j < 4; ++j) (void) arr.push_back(j);
+        doNotOptimize(arr.data());
+    }
+}
+
+// Grows a buffer one byte at a time, which is dominated by relocation cost.
+template<allocator A>
+void growBytes(A a)
+{
+    ArrayList<std::byte, A> arr(a);
+    for (std::size_t i = 0; i < 64 * 1024; ++i)
+        (void) arr.push_back(std::byte(i));
+    doNotOptimize(arr.data());
+}
+
+PL_BENCHMARK(bench_mallocatorArrayListGrowBytes)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+        growBytes(Mallocator());
+}
+
+PL_BENCHMARK(bench_arenaArrayListGrowBytes)
+{
+    Arena<> arena(256 * 1024);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        growBytes(ArenaAllocator(arena));
+        arena.reset();
+    }
+}
+
+struct Record
+{
+    std::size_t id;
+    float       values[6];
+};
+
+template<allocator A>
+void newDelete(A a)
+{
+    Record *records[numAllocsPerIteration];
+    for (std::size_t i = 0; i < numAllocsPerIteration; ++i)
+    {
+        records[i] = *new_<Record>(a, i);
+        doNotOptimize(records[i]);
+    }
+    for (Record *r : records)
+        delete_(a, makeNonNull_Unchecked(r));
+}
+
+PL_BENCHMARK(bench_mallocatorNewDelete)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+        newDelete(Mallocator());
+}
+
+PL_BENCHMARK(bench_poolNewDelete)
+{
+    Pool<sizeof(Record), alignof(Record)> pool(numAllocsPerIteration);
+    for (std::size_t i = 0; i < iterations; ++i)
+        newDelete(PoolAllocator(pool));
+}
+
+// Random reads over a buffer much larger than what the TLB covers with regular pages.
+template<allocator A>
+void randomReads(std::size_t iterations)
+{
+    constexpr std::size_t count = 64 * 1024 * 1024 / sizeof(std::uint64_t);
+    A a;
+    Span<std::uint64_t> buffer = *alloc<std::uint64_t>(a, count);
+    for (std::size_t i = 0; i < count; ++i) buffer[i] = i;
+
+    std::uint64_t sum = 0;
+    std::uint64_t index = 0;
+    for (std::size_t i = 0; i < iterations * 1024; ++i)
+    {
+        index = (index * 6364136223846793005u + 1442695040888963407u) % count;
+        sum += buffer[index];
+    }
+    doNotOptimize(sum);
+    free(a, buffer);
+}
+
+PL_BENCHMARK(bench_mallocatorRandomReads)
+{
+    randomReads<Mallocator>(iterations);
+}
+
+PL_BENCHMARK(bench_hugePageAllocatorRandomReads)
+{
+    randomReads<HugePageAllocator>(iterations);
+}
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,85 @@
+module;
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+using namespace pl::literals;
+
+constexpr std::size_t numNames = 256;
+
+// Names shaped like Vulkan extension names, which share long prefixes.
+struct Strings
+{
+    char data[numNames][48];
+
+    Strings() noexcept
+    {
+        for (std::size_t i = 0; i < numNames; ++i)
+            std::snprintf(data[i], sizeof(data[i]), "VK_KHR_benchmark_extension_%zu", i);
+    }
+};
+
+Strings const strings;
+
+PL_BENCHMARK(bench_nameFind)
+{
+    for (std::size_t k = 0; k < numNames; ++k) (void) Name::intern(strings.data[k]);
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t found = 0;
+        for (std::size_t k = 0; k < numNames; ++k) found += Name::find(strings.data[k]).has_value();
+        doNotOptimize(found);
+    }
+}
+
+PL_BENCHMARK(bench_nameFindLiteral)
+{
+    (void) Name::intern("VK_KHR_benchmark_extension_0"_name);
+
+    for (std::size_t i = 0; i < iterations; ++i)
+        doNotOptimize(Name::find("VK_KHR_benchmark_extension_0"_name));
+}
+
+PL_BENCHMARK(bench_nameSetContains)
+{
+    HashSet<Name> set;
+    Name names[numNames];
+    for (std::size_t k = 0; k < numNames; ++k)
+    {
+        names[k] = *Name::intern(strings.data[k]);
+        if (k % 2 == 0) (void) set.insert(names[k]);
+    }
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t found = 0;
+        for (Name name : names) found += set.contains(name);
+        doNotOptimize(found);
+    }
+}
+
+PL_BENCHMARK(bench_stringSetContains)
+{
+    HashSet<std::string_view> set;
+    for (std::size_t k = 0; k < numNames; k += 2) (void) set.insert(std::string_view(strings.data[k]));
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t found = 0;
+        for (auto &string : strings.data) found += set.contains(std::string_view(string));
+        doNotOptimize(found);
+    }
+}
+} // namespace
+} // namespace pl_bench
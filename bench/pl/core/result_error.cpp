@@ -0,0 +1,209 @@
+module;
+#include <cstddef>
+#include <pl/bench_macro.hpp>
+#include <pl/macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+class BenchError : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "BenchError";
+    }
+};
+
+// Three levels of calls that cannot be inlined, the deepest of which fails for negative inputs.
+
+[[gnu::noinline]]
+RE<int, SimpleError> leaf(int x) noexcept
+{
+    if (x < 0) return {tags::error, getSingleton<BenchError>()};
+    return x + 1;
+}
+
+[[gnu::noinline]]
+RE<int, SimpleError> middle(int x) noexcept
+{
+    PL_TRY_ASSIGN(int y, leaf(x));
+    return y * 2;
+}
+
+[[gnu::noinline]]
+RE<int, SimpleError> outer(int x) noexcept
+{
+    PL_TRY_ASSIGN(int y, middle(x));
+    PL_TRY_DISCARD(leaf(y));
+    return y;
+}
+
+// The same calls, reporting errors through a status code and an out parameter.
+
+[[gnu::noinline]]
+bool leafCode(int x, int &out) noexcept
+{
+    if (x < 0) return false;
+    out = x + 1;
+    return true;
+}
+
+[[gnu::noinline]]
+bool middleCode(int x, int &out) noexcept
+{
+    int y;
+    if (!leafCode(x, y)) return false;
+    out = y * 2;
+    return true;
+}
+
+[[gnu::noinline]]
+bool outerCode(int x, int &out) noexcept
+{
+    int y;
+    if (!middleCode(x, y)) return false;
+    int z;
+    if (!leafCode(y, z)) return false;
+    out = y;
+    return true;
+}
+
+// The same calls through the niche-packed layouts: a pointer result, which comes back in two registers,
+// and a void result, which is just the error pointer.
+
+int values[2] = {};
+
+[[gnu::noinline]]
+RE<Ptr<int>, SimpleError> leafPtr(int x) noexcept
+{
+    if (x < 0) return {tags::error, getSingleton<BenchError>()};
+    return addr(values[x & 1]);
+}
+
+[[gnu::noinline]]
+RE<void, SimpleError> checkPtr(Ptr<int> p) noexcept
+{
+    if (*p < 0) return {tags::error, getSingleton<BenchError>()};
+    return {};
+}
+
+[[gnu::noinline]]
+RE<Ptr<int>, SimpleError> middlePtr(int x) noexcept
+{
+    PL_TRY_ASSIGN(Ptr<int> p, leafPtr(x));
+    PL_TRY_DISCARD(checkPtr(p));
+    return p;
+}
+
+[[gnu::noinline]]
+RE<void, SimpleError> outerVoid(int x) noexcept
+{
+    PL_TRY_ASSIGN(Ptr<int> p, middlePtr(x));
+    PL_TRY_DISCARD(checkPtr(p));
+    return {};
+}
+
+// The same calls as leaf, middle and outer, with errors that capture their stack and propagation sites.
+
+[[gnu::noinline]]
+RE<int, StacktracedError> leafTraced(int x) noexcept
+{
+    if (x < 0) return {tags::error, errorSite<BenchError>()};
+    return x + 1;
+}
+
+[[gnu::noinline]]
+RE<int, StacktracedError> middleTraced(int x) noexcept
+{
+    PL_TRY_ASSIGN(int y, leafTraced(x));
+    return y * 2;
+}
+
+[[gnu::noinline]]
+RE<int, StacktracedError> outerTraced(int x) noexcept
+{
+    PL_TRY_ASSIGN(int y, middleTraced(x));
+    PL_TRY_DISCARD(leafTraced(y));
+    return y;
+}
+
+constexpr int numCalls = 1024;
+
+PL_BENCHMARK(bench_resultErrorSuccess)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k) doNotOptimize(outer(k));
+    }
+}
+
+PL_BENCHMARK(bench_resultErrorFailure)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k) doNotOptimize(outer(-k - 1));
+    }
+}
+
+PL_BENCHMARK(bench_resultErrorTracedFailure)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k) doNotOptimize(outerTraced(-k - 1));
+    }
+}
+
+PL_BENCHMARK(bench_resultErrorPtrSuccess)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k) doNotOptimize(outerVoid(k));
+    }
+}
+
+PL_BENCHMARK(bench_resultErrorPtrFailure)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k) doNotOptimize(outerVoid(-k - 1));
+    }
+}
+
+PL_BENCHMARK(bench_statusCodeSuccess)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k)
+        {
+            int out = 0;
+            doNotOptimize(outerCode(k, out));
+            doNotOptimize(out);
+        }
+    }
+}
+
+PL_BENCHMARK(bench_statusCodeFailure)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (int k = 0; k < numCalls; ++k)
+        {
+            int out = 0;
+            doNotOptimize(outerCode(-k - 1, out));
+            doNotOptimize(out);
+        }
+    }
+}
+} // namespace
+} // namespace pl_bench
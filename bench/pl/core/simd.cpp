@@ -0,0 +1,133 @@
+module;
+#include <cstddef>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numValues = 64 * 1024;
+
+struct Values
+{
+    ArrayList<float> a;
+    ArrayList<float> b;
+    ArrayList<float> out;
+
+    Values() noexcept
+    {
+        (void) a  .resize(numValues);
+        (void) b  .resize(numValues);
+        (void) out.resize(numValues);
+        for (std::size_t i = 0; i < numValues; ++i)
+        {
+            a[i] = float(i % 97) * 0.25f;
+            b[i] = float(i % 13) - 6.0f;
+        }
+    }
+};
+
+// Runs body with the kernels dispatching to isa, or the fastest supported instruction set below it.
+template<class Body>
+void withIsa(simd::Isa isa, Body &&body) noexcept
+{
+    simd::Isa previous = simd::activeIsa();
+    (void) simd::setIsa(isa);
+    body();
+    (void) simd::setIsa(previous);
+}
+
+PL_BENCHMARK(bench_sumLoop)
+{
+    Values v;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        float sum = 0.0f;
+        for (float x : v.a) sum += x;
+        doNotOptimize(sum);
+    }
+}
+
+PL_BENCHMARK(bench_sumSse2)
+{
+    Values v;
+    withIsa(simd::Isa::sse2, [&]
+    {
+        for (std::size_t i = 0; i < iterations; ++i) doNotOptimize(simd::sum(Span<float const>(v.a)));
+    });
+}
+
+PL_BENCHMARK(bench_sumAvx2)
+{
+    Values v;
+    withIsa(simd::Isa::avx2, [&]
+    {
+        for (std::size_t i = 0; i < iterations; ++i) doNotOptimize(simd::sum(Span<float const>(v.a)));
+    });
+}
+
+PL_BENCHMARK(bench_sumAvx512)
+{
+    Values v;
+    withIsa(simd::Isa::avx512, [&]
+    {
+        for (std::size_t i = 0; i < iterations; ++i) doNotOptimize(simd::sum(Span<float const>(v.a)));
+    });
+}
+
+PL_BENCHMARK(bench_dotLoop)
+{
+    Values v;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        float sum = 0.0f;
+        for (std::size_t j = 0; j < numValues; ++j) sum += v.a[j] * v.b[j];
+        doNotOptimize(sum);
+    }
+}
+
+PL_BENCHMARK(bench_dot)
+{
+    Values v;
+    for (std::size_t i = 0; i < iterations; ++i)
+        doNotOptimize(simd::dot(Span<float const>(v.a), Span<float const>(v.b)));
+}
+
+PL_BENCHMARK(bench_minMax)
+{
+    Values v;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        doNotOptimize(simd::min(Span<float const>(v.b)));
+        doNotOptimize(simd::max(Span<float const>(v.b)));
+    }
+}
+
+PL_BENCHMARK(bench_inclusiveScanLoop)
+{
+    Values v;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        float sum = 0.0f;
+        for (std::size_t j = 0; j < numValues; ++j) v.out[j] = sum += v.a[j];
+        doNotOptimize(v.out.data());
+    }
+}
+
+PL_BENCHMARK(bench_inclusiveScan)
+{
+    Values v;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        simd::inclusive_scan(Span<float const>(v.a), Span<float>(v.out));
+        doNotOptimize(v.out.data());
+    }
+}
+} // namespace
+} // namespace pl_bench
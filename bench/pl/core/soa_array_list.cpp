@@ -0,0 +1,65 @@
+module;
+#include <cstddef>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numParticles = 64 * 1024;
+
+struct Color
+{
+    float rgba[4];
+};
+
+// A particle as it would be laid out in an array of structures.
+// The update only touches position and velocity, but every cache line also carries the rest.
+struct Particle
+{
+    float position[3];
+    float velocity[3];
+    Color color;
+    float lifetime;
+    float size;
+};
+
+PL_BENCHMARK(bench_aosParticleUpdate)
+{
+    ArrayList<Particle> particles;
+    (void) particles.resize(numParticles);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (Particle &p : particles)
+        {
+            for (std::size_t d = 0; d < 3; ++d) p.position[d] += p.velocity[d] * 0.016f;
+        }
+        doNotOptimize(particles.data());
+    }
+}
+
+PL_BENCHMARK(bench_soaParticleUpdate)
+{
+    // Position x, y, z, velocity x, y, z, color, lifetime and size, each in its own column.
+    SoAArrayList<float, float, float, float, float, float, Color, float, float> particles;
+    (void) particles.resize(numParticles);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        auto update = [&](Span<float> position, Span<float const> velocity)
+        {
+            for (std::size_t j = 0; j < position.size(); ++j) position[j] += velocity[j] * 0.016f;
+        };
+        update(particles.column<0>(), particles.column<3>());
+        update(particles.column<1>(), particles.column<4>());
+        update(particles.column<2>(), particles.column<5>());
+        doNotOptimize(particles.column<0>().data());
+    }
+}
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,62 @@
+module;
+#include <cstddef>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numElements = 1 << 20;
+
+PL_BENCHMARK(bench_stableArrayListPushBack)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        StableArrayList<float> list;
+        for (std::size_t k = 0; k < numElements; ++k) (void) list.push_back(float(k));
+        doNotOptimize(&list.back());
+    }
+}
+
+PL_BENCHMARK(bench_arrayListPushBackLarge)
+{
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        ArrayList<float> list;
+        for (std::size_t k = 0; k < numElements; ++k) (void) list.push_back(float(k));
+        doNotOptimize(list.data());
+    }
+}
+
+PL_BENCHMARK(bench_stableArrayListIndex)
+{
+    StableArrayList<float> list;
+    (void) list.resize(numElements);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        float sum = 0.0f;
+        for (std::size_t k = 0; k < list.size(); ++k) sum += list[k];
+        doNotOptimize(sum);
+    }
+}
+
+// Sums a chunk at a time with the SIMD kernels.
+PL_BENCHMARK(bench_stableArrayListChunkSum)
+{
+    StableArrayList<float> list;
+    (void) list.resize(numElements);
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        float sum = 0.0f;
+        list.for_each_chunk([&](Span<float> chunk) { sum += simd::sum(Span<float const>(chunk)); });
+        doNotOptimize(sum);
+    }
+}
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,92 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <pl/bench_macro.hpp>
+
+module pl.core.bench;
+
+import pl.core;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+
+constexpr std::size_t numLiveAllocs = 64;
+constexpr unsigned    maxThreads    = 8;
+
+template<allocator A>
+void churn(std::size_t iterations, std::uint32_t seed)
+{
+    A a;
+    auto alignment = makeNonZero_Unchecked(alignof(std::max_align_t));
+    void        *live[numLiveAllocs]  = {};
+    std::size_t  sizes[numLiveAllocs] = {};
+
+    std::uint32_t state = seed * 2654435761u + 1;
+    for (std::size_t i = 0; i < iterations * numLiveAllocs; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        std::size_t slot = state >> 26;
+        if (live[slot])
+            a.free(makeNonNull_Unchecked(live[slot]), makeNonZero_Unchecked(sizes[slot]), alignment);
+
+        sizes[slot] = 8 + (state >> 8) % 1024;
+        live[slot] = *a.alloc(makeNonZero_Unchecked(sizes[slot]), alignment);
+        doNotOptimize(live[slot]);
+    }
+
+    for (std::size_t slot = 0; slot < numLiveAllocs; ++slot)
+    {
+        if (live[slot])
+            a.free(makeNonNull_Unchecked(live[slot]), makeNonZero_Unchecked(sizes[slot]), alignment);
+    }
+}
+
+// Every thread performs the same amount of work,
+// so perfect scaling keeps the time per iteration constant as the number of threads grows.
+template<allocator A>
+void stress(std::size_t iterations, unsigned numThreads)
+{
+    std::thread threads[maxThreads];
+    for (unsigned t = 0; t < numThreads; ++t)
+        threads[t] = std::thread([=] { churn<A>(iterations, t); });
+    for (unsigned t = 0; t < numThreads; ++t)
+        threads[t].join();
+}
+
+PL_BENCHMARK(bench_mallocatorStress1Thread)  { stress<Mallocator>(iterations, 1); }
+PL_BENCHMARK(bench_mallocatorStress2Threads) { stress<Mallocator>(iterations, 2); }
+PL_BENCHMARK(bench_mallocatorStress4Threads) { stress<Mallocator>(iterations, 4); }
+PL_BENCHMARK(bench_mallocatorStress8Threads) { stress<Mallocator>(iterations, 8); }
+
+PL_BENCHMARK(bench_threadCachingAllocatorStress1Thread)  { stress<ThreadCachingAllocator>(iterations, 1); }
+PL_BENCHMARK(bench_threadCachingAllocatorStress2Threads) { stress<ThreadCachingAllocator>(iterations, 2); }
+PL_BENCHMARK(bench_threadCachingAllocatorStress4Threads) { stress<ThreadCachingAllocator>(iterations, 4); }
+PL_BENCHMARK(bench_threadCachingAllocatorStress8Threads) { stress<ThreadCachingAllocator>(iterations, 8); }
+
+// Allocates on the calling thread, and frees everything on another one.
+template<allocator A>
+void crossThreadFree(std::size_t iterations)
+{
+    A a;
+    auto size      = makeNonZero_Unchecked(std::size_t(64));
+    auto alignment = makeNonZero_Unchecked(alignof(std::max_align_t));
+    void *memory[numLiveAllocs];
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        for (auto &m : memory) m = *a.alloc(size, alignment);
+        std::thread([&]
+        {
+            for (auto m : memory) a.free(makeNonNull_Unchecked(m), size, alignment);
+        }).join();
+    }
+}
+
+PL_BENCHMARK(bench_mallocatorCrossThreadFree)             { crossThreadFree<Mallocator>(iterations); }
+PL_BENCHMARK(bench_threadCachingAllocatorCrossThreadFree) { crossThreadFree<ThreadCachingAllocator>(iterations); }
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,165 @@
+#include <cstddef>
+#include <pl/bench_macro.hpp>
+
+import pl.core;
+import pl.core.bench;
+import pl.ecs;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+using namespace pl::ecs;
+
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+struct Health   { float value;   };
+struct Frozen   {};
+
+using BenchWorld = World<Position, Velocity, Health, Frozen>;
+
+// Spreads the entities over four archetypes, three of which have both Position and Velocity.
+void populate(BenchWorld &world, std::size_t numEntities) noexcept
+{
+    for (std::size_t i = 0; i < numEntities; ++i)
+    {
+        Position p{float(i), 0.0f, 0.0f};
+        Velocity v{1.0f, 0.5f, 0.25f};
+        switch (i % 4)
+        {
+        case 0:  (void) world.create(p, v);                   break;
+        case 1:  (void) world.create(p, v, Health{100.0f});   break;
+        case 2:  (void) world.create(p, v, Frozen{});         break;
+        default: (void) world.create(p, Health{100.0f});      break;
+        }
+    }
+}
+
+// Filling a world of a million entities takes longer than a whole timed run,
+// so every size of world is only filled once, with timing paused, and then shared.
+// Benchmarks may change the components of a shared world, but must leave its entities as they found them.
+template<std::size_t numEntities>
+BenchWorld &populatedWorld() noexcept
+{
+    static BenchWorld world;
+    if (world.size() == 0) populate(world, numEntities);
+    return world;
+}
+
+template<std::size_t numEntities>
+void forEach(std::size_t iterations)
+{
+    pauseTiming();
+    BenchWorld &world = populatedWorld<numEntities>();
+    auto query = world.query<Position, Velocity const>();
+    resumeTiming();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        (void) query.for_each([](Position &p, Velocity const &v)
+        {
+            p.x += v.x;
+            p.y += v.y;
+            p.z += v.z;
+        });
+        doNotOptimize(&world);
+    }
+}
+
+PL_BENCHMARK(bench_worldForEach10k)  { forEach<10'000>(iterations);    }
+PL_BENCHMARK(bench_worldForEach100k) { forEach<100'000>(iterations);   }
+PL_BENCHMARK(bench_worldForEach1M)   { forEach<1'000'000>(iterations); }
+
+// The same update over the Spans of each chunk, which the compiler can vectorize.
+template<std::size_t numEntities>
+void forEachChunk(std::size_t iterations)
+{
+    pauseTiming();
+    BenchWorld &world = populatedWorld<numEntities>();
+    auto query = world.query<Position, Velocity const>();
+    resumeTiming();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        (void) query.for_each_chunk([](Span<Entity const> entities, Span<Position> p, Span<Velocity const> v)
+        {
+            for (std::size_t k = 0; k < entities.size(); ++k)
+            {
+                p[k].x += v[k].x;
+                p[k].y += v[k].y;
+                p[k].z += v[k].z;
+            }
+        });
+        doNotOptimize(&world);
+    }
+}
+
+PL_BENCHMARK(bench_worldForEachChunk10k)  { forEachChunk<10'000>(iterations);    }
+PL_BENCHMARK(bench_worldForEachChunk100k) { forEachChunk<100'000>(iterations);   }
+PL_BENCHMARK(bench_worldForEachChunk1M)   { forEachChunk<1'000'000>(iterations); }
+
+template<std::size_t numEntities>
+void parallelForEachChunk(std::size_t iterations, std::size_t numThreads)
+{
+    pauseTiming();
+    JobSystem  &jobs  = jobSystem(numThreads);
+    BenchWorld &world = populatedWorld<numEntities>();
+    auto query = world.query<Position, Velocity const>();
+    resumeTiming();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        (void) query.parallel_for_each_chunk(jobs, [](Span<Entity const> entities, Span<Position> p, Span<Velocity const> v)
+        {
+            for (std::size_t k = 0; k < entities.size(); ++k)
+            {
+                p[k].x += v[k].x;
+                p[k].y += v[k].y;
+                p[k].z += v[k].z;
+            }
+        });
+        doNotOptimize(&world);
+    }
+}
+
+PL_BENCHMARK(bench_worldParallel100k4Threads) { parallelForEachChunk<100'000>(iterations,   4); }
+PL_BENCHMARK(bench_worldParallel1M4Threads)   { parallelForEachChunk<1'000'000>(iterations, 4); }
+
+// Creates and destroys entities, which swap-removes rows.
+PL_BENCHMARK(bench_worldCreateDestroy)
+{
+    pauseTiming();
+    BenchWorld &world = populatedWorld<10'000>();
+    resumeTiming();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        Entity e = *world.create(Position{}, Velocity{});
+        (void) world.destroy(e);
+    }
+    doNotOptimize(&world);
+}
+
+// Adds and removes a component, which moves the entity between two archetypes through the cached edges.
+PL_BENCHMARK(bench_worldAddRemove)
+{
+    pauseTiming();
+    // Its own world, since it keeps an extra entity in it.
+    static BenchWorld world;
+    static Entity const e = []
+    {
+        populate(world, 10'000);
+        return *world.create(Position{}, Velocity{});
+    }();
+    resumeTiming();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        (void) world.add<Frozen>(e);
+        (void) world.remove<Frozen>(e);
+    }
+    doNotOptimize(&world);
+}
+} // namespace
+} // namespace pl_bench
@@ -0,0 +1,12 @@
+#include <iostream>
+
+import pl.core.bench;
+
+// Usage: libpl_bench [filter]
+// Writes the results of every benchmark whose name contains filter to stdout as JSON.
+int main(int argc, char **argv)
+{
+    pl_bench::Options options;
+    if (argc > 1) options.filter = argv[1];
+    pl_bench::runBenchmarks(options, std::cout, std::clog);
+}
@@ -0,0 +1,83 @@
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include <pl/bench_macro.hpp>
+
+import pl.core;
+import pl.core.bench;
+import pl.vulkan;
+
+namespace pl_bench
+{
+namespace
+{
+using namespace pl;
+using namespace pl::vulkan;
+
+// Same shape as the placeholder scene of the renderer: 100k instances, in rows alternating between meshes.
+constexpr std::size_t sceneInstanceCount = 100'000;
+constexpr std::size_t sceneRowLength     = 317;
+constexpr std::size_t numSceneMeshes     = 2;
+
+Mesh sceneMesh(std::size_t i) noexcept
+{
+    std::uint64_t k = (i / sceneRowLength) % numSceneMeshes;
+    return {
+        .vertices = {.offset = k * 4, .size = 4, .node = std::uint32_t(k)},
+        .indices  = {.offset = k * 6, .size = 6, .node = std::uint32_t(k)},
+    };
+}
+
+void fill(DrawList &drawList) noexcept
+{
+    for (std::size_t i = 0; i < sceneInstanceCount; ++i)
+    {
+        Instance instance = {
+            .offset = {float(i % sceneRowLength), float(i / sceneRowLength)},
+            .scale  = 1.0f,
+            .tint   = {1.0f, 1.0f, 1.0f},
+        };
+        (void) drawList.add(sceneMesh(i), instance);
+    }
+}
+
+// Refilling the list every frame, as a fully dynamic scene would.
+PL_BENCHMARK(bench_drawListAdd100k)
+{
+    DrawList drawList;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        drawList.clear();
+        fill(drawList);
+        doNotOptimize(&drawList);
+    }
+}
+
+// Writing the instances and indirect draws of a frame, which is all a changed scene costs the renderer.
+// The list and the buffers are built, and destroyed, with timing paused.
+PL_BENCHMARK(bench_drawListWrite100k)
+{
+    pauseTiming();
+    {
+        DrawList drawList;
+        fill(drawList);
+
+        ArrayList<Instance>                     instances;
+        ArrayList<VkDrawIndexedIndirectCommand> commands;
+        (void) instances.resize_for_overwrite(drawList.numInstances());
+        (void) commands.resize_for_overwrite(drawList.numBatches());
+        resumeTiming();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::uint32_t numCommands = drawList.write(instances, commands);
+            doNotOptimize(&numCommands);
+            doNotOptimize(instances.data());
+        }
+
+        pauseTiming();
+    }
+    resumeTiming();
+}
+} // namespace
+} // namespace pl_bench
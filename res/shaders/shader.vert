@@ -1,19 +1,16 @@
 #version 450
 
-vec2 positions[3] = vec2[](
-    vec2( 0.0, -0.5),
-    vec2( 0.5,  0.5),
-    vec2(-0.5,  0.5));
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
 
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0));
+layout(location = 2) in vec2  inOffset;
+layout(location = 3) in float inScale;
+layout(location = 4) in vec3  inTint;
 
 layout(location = 0) out vec3 fragColor;
 
 void main()
 {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    gl_Position = vec4(inPosition * inScale + inOffset, 0.0, 1.0);
+    fragColor = inColor * inTint;
 }
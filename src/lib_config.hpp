@@ -1 +1,10 @@
 #pragma once
+
+// Records allocation statistics in every TrackingAllocator, see pl.core:tracking_allocator.
+#ifndef PL_TRACK_ALLOCATIONS
+#   ifdef NDEBUG
+#       define PL_TRACK_ALLOCATIONS 0
+#   else
+#       define PL_TRACK_ALLOCATIONS 1
+#   endif
+#endif
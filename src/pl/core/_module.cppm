@@ -2,18 +2,34 @@ export module pl.core;
 
 export import :array;
 export import :array_list;
+export import :bit_set;
 export import :concepts;
+export import :concurrent_queue;
 export import :defer;
 export import :error;
+export import :error_trace;
 export import :handle;
+export import :hash;
+export import :hash_map;
 export import :iterator;
+export import :job_system;
 export import :memory;
+export import :name;
 export import :null;
+export import :null_trait;
 export import :numeric;
 export import :optional;
+export import :range_allocator;
 export import :result_error;
+export import :simd;
 export import :singleton;
+export import :slot_map;
+export import :small_array_list;
+export import :soa_array_list;
 export import :span;
+export import :stable_array_list;
 export import :tags;
+export import :thread_caching_allocator;
+export import :tracking_allocator;
 export import :traits;
 export import :utility;
@@ -2,6 +2,7 @@ module;
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <type_traits>
@@ -41,13 +42,13 @@ public:
     ArrayListIterator &operator=(ArrayListIterator const &) = default;
 
 #ifndef NDEBUG
-    template<class A>
+    template<class Container>
 #endif
     constexpr ArrayListIterator(
         T *p
 #ifndef NDEBUG
         ,
-        ArrayList<T, A> &arr
+        Container &arr
 #endif
     ) noexcept
     :
@@ -155,10 +156,13 @@ private:
 };
 } // namespace pl
 
-export namespace pl
+namespace pl::array_list_
 {
-template<class T, allocator A = Mallocator>
-class ArrayList
+// Everything ArrayList and SmallArrayList have in common, which is all but where the elements are stored.
+// Derived provides list_begin(), list_end() as a reference to its end pointer, capacity() and reallocate(),
+// the latter moving the elements to storage of the given capacity, and dropping any that do not fit.
+template<class Derived, class T, allocator A>
+class ListBase
 {
 public:
     using value_type             = T;
@@ -170,37 +174,9 @@ public:
     using pointer                = value_type       *;
     using const_pointer          = value_type const *;
     using iterator               = ArrayListIterator<T>;
-    using const_iterator         = const_iterator<iterator>;
+    using const_iterator         = pl::const_iterator<iterator>;
     using reverse_iterator       = std::reverse_iterator<      iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-    
-
-    [[nodiscard]] ArrayList() = default;
-
-    [[nodiscard]] explicit constexpr ArrayList(allocator_type const &a) noexcept
-    : _allocator(a) {}
-
-    [[nodiscard]] constexpr ArrayList(ArrayList &&other) noexcept
-    : 
-        _arr(std::exchange(other._arr, {})),
-        _end(std::exchange(other._end, {})),
-        _allocator(other._allocator)
-    {}
-
-    constexpr ArrayList &operator=(ArrayList &&other)
-    noexcept(std::is_nothrow_copy_assignable_v<A>)
-    {
-        _arr = std::exchange(other._arr, {});
-        _end = std::exchange(other._end, {});
-        _allocator = other._allocator;
-        return *this;
-    }
-
-    constexpr ~ArrayList()
-    {
-        std::ranges::destroy(_arr.data(), _end);
-        free(_allocator, _arr);
-    }
 
     template<std::input_iterator I, std::sentinel_for<I> S>
     [[nodiscard]] constexpr RE<void, SimpleError> assign(I first, S last)
@@ -208,62 +184,57 @@ public:
         return assign_elements(first, last);
     }
 
-    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
-    {
-        return _allocator;
-    }
-
     [[nodiscard]] constexpr reference operator[](size_type idx) noexcept
     {
         PL_ASSERT(idx < size());
-        return _arr.data()[idx];
+        return data()[idx];
     }
 
     [[nodiscard]] constexpr const_reference operator[](size_type idx) const noexcept
     {
         PL_ASSERT(idx < size());
-        return _arr.data()[idx];
+        return data()[idx];
     }
 
     [[nodiscard]] constexpr reference front() noexcept
     {
         PL_ASSERT(!empty());
-        return *_arr.data();
+        return *data();
     }
 
     [[nodiscard]] constexpr const_reference front() const noexcept
     {
         PL_ASSERT(!empty());
-        return *_arr.data();
+        return *data();
     }
 
     [[nodiscard]] constexpr reference back() noexcept
     {
         PL_ASSERT(!empty());
-        return _end[-1];
+        return end_ptr()[-1];
     }
 
     [[nodiscard]] constexpr const_reference back() const noexcept
     {
         PL_ASSERT(!empty());
-        return _end[-1];
+        return end_ptr()[-1];
     }
 
     [[nodiscard]] constexpr T *data() noexcept
     {
-        return _arr.data();
+        return derived().list_begin();
     }
 
     [[nodiscard]] constexpr T const *data() const noexcept
     {
-        return _arr.data();
+        return derived().list_begin();
     }
 
     [[nodiscard]] constexpr iterator begin() noexcept
     {
         return
         {
-            _arr.data(),
+            data(),
 #ifndef NDEBUG
             *this,
 #endif
@@ -272,7 +243,7 @@ public:
 
     [[nodiscard]] constexpr const_iterator begin() const noexcept
     {
-        return const_iterator(const_cast<ArrayList *>(this)->begin());
+        return const_iterator(const_cast<ListBase *>(this)->begin());
     }
 
     [[nodiscard]] constexpr const_iterator cbegin() const noexcept
@@ -284,7 +255,7 @@ public:
     {
         return
         {
-            _end,
+            end_ptr(),
 #ifndef NDEBUG
             *this,
 #endif
@@ -293,7 +264,7 @@ public:
 
     [[nodiscard]] constexpr const_iterator end() const noexcept
     {
-        return const_iterator(const_cast<ArrayList *>(this)->end());
+        return const_iterator(const_cast<ListBase *>(this)->end());
     }
 
     [[nodiscard]] constexpr const_iterator cend() const noexcept
@@ -338,7 +309,7 @@ public:
 
     [[nodiscard]] constexpr size_type size() const noexcept
     {
-        return size_type(_end - _arr.data());
+        return size_type(end_ptr() - data());
     }
 
     // Reserve capacity enough for extra elements.
@@ -354,32 +325,27 @@ public:
 
     [[nodiscard]] constexpr RE<void, SimpleError> reserve_capacity(size_type required_capacity)
     {
-        if (required_capacity <= capacity()) return {};
-        return reallocate(get_new_geometric_capacity(required_capacity - capacity()));
+        if (required_capacity <= derived().capacity()) return {};
+        return derived().reallocate(get_new_geometric_capacity(required_capacity - derived().capacity()));
     }
 
     [[nodiscard]] constexpr RE<void, SimpleError> reserve_capacity_exact(size_type required_capacity)
     {
-        if (required_capacity <= capacity()) return {};
-        return reallocate(required_capacity);
-    }
-
-    [[nodiscard]] constexpr size_type capacity() const noexcept
-    {
-        return _arr.size();
+        if (required_capacity <= derived().capacity()) return {};
+        return derived().reallocate(required_capacity);
     }
 
     [[nodiscard]] constexpr RE<void, SimpleError> shrink_to_fit()
     {
-        return reallocate(size());
+        return derived().reallocate(size());
     }
 
     constexpr void clear() noexcept
     {
         // Must leave capacity at the same value
         // So only destroy elements, but don't deallocate.
-        std::ranges::destroy(_arr.data(), _end);
-        _end = _arr.data();
+        std::ranges::destroy(data(), end_ptr());
+        end_ptr() = data();
     }
 
     template<std::input_iterator I, std::sentinel_for<I> S>
@@ -393,7 +359,7 @@ public:
     [[nodiscard]]
     constexpr RE<iterator, SimpleError> insert(const_iterator pos, I first, S last)
     {
-        if (end() == pos.base()) 
+        if (end() == pos.base())
             return append_elements(first, last);
         else
             return insert_elements(std::move(pos).base(), first, last);
@@ -422,14 +388,14 @@ public:
     requires std::is_constructible_v<T, Args...>
     {
         PL_TRY_DISCARD(reserve(1));
-        std::construct_at(_end++, std::forward<Args>(args)...);
+        std::construct_at(end_ptr()++, std::forward<Args>(args)...);
         return {};
     }
 
     constexpr void pop_back() noexcept
     {
         PL_ASSERT(!empty());
-        std::destroy_at(--_end);
+        std::destroy_at(--end_ptr());
     }
 
     constexpr RE<void, SimpleError> resize(size_type count) noexcept
@@ -443,7 +409,7 @@ public:
         {
             iterator new_end = old_end - static_cast<difference_type>(old_size - count);
             rng::destroy(new_end, old_end);
-            _end = std::to_address(new_end);
+            end_ptr() = std::to_address(new_end);
         }
         else
         {
@@ -457,49 +423,86 @@ public:
             {
                 rng::uninitialized_default_construct(old_end, new_end);
             }
-            _end = std::to_address(new_end);
+            end_ptr() = std::to_address(new_end);
         }
 
         return {};
     }
 
-    constexpr void swap(ArrayList &other)
-    {
-        using std::swap;
-        swap(_arr      , other._arr      );
-        swap(_end      , other._end      );
-        swap(_allocator, other._allocator);
-    }
-
-private:
-    [[nodiscard]] constexpr RE<void, SimpleError> reallocate(size_type const new_capacity)
+    // Same as resize, except that new elements of trivial types are left uninitialized,
+    // for when they are about to be overwritten anyway, e.g. by a read or a Vulkan query.
+    constexpr RE<void, SimpleError> resize_for_overwrite(size_type count) noexcept
     {
-        namespace rng = std::ranges;
-
-        const size_type new_size = std::min(size(), new_capacity);
-        RE<Span<T>, SimpleError> alloc_result = alloc<T>(_allocator, new_capacity);
-        if (!alloc_result) return {tags::error, std::move(alloc_result).error()};
-        Span<T> &new_arr = *alloc_result;
-        if consteval
+        if constexpr (std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>)
         {
-            auto ifirst =         begin(); auto ilast  =         end();
-            auto ofirst = new_arr.begin(); auto olast  = new_arr.end();
-            for (; ifirst != ilast && ofirst != olast; ++ifirst, ++ofirst)
+            if !consteval
             {
-                rng::construct_at(std::to_address(ofirst), rng::iter_move(ifirst));
+                PL_TRY_DISCARD(reserve_capacity(count));
+                end_ptr() = data() + count;
+                return {};
             }
         }
-        else
+        return resize(count);
+    }
+
+    // Extends the list by count uninitialized elements, and returns them to be written.
+    [[nodiscard]]
+    constexpr RE<Span<T>, SimpleError> append_uninitialized(size_type count) noexcept
+    requires (std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>)
+    {
+        size_type old_size = size();
+        PL_TRY_DISCARD(resize_for_overwrite(old_size + count));
+        return Span<T>(data() + old_size, count);
+    }
+
+    // Extends the list by up to max_count elements, which are filled in by op.
+    // op is passed the uninitialized elements as Span<T>, and returns how many of the leading ones
+    // it has written, as size_type or RE<size_type, SimpleError>.
+    // Elements that were not written are removed again, and so is every new element on error.
+    template<class Op>
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> append_and_overwrite(size_type max_count, Op &&op)
+    requires (std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>)
+    {
+        size_type old_size = size();
+        PL_TRY_ASSIGN(Span<T> tail, append_uninitialized(max_count));
+
+        RE<size_type, SimpleError> written = std::invoke(std::forward<Op>(op), tail);
+        if (!written)
         {
-            rng::uninitialized_move(*this, new_arr);
+            end_ptr() = data() + old_size;
+            return {tags::error, std::move(written).error()};
         }
-        rng::destroy(*this);
-        free(_allocator, _arr);
-        _arr = new_arr;
-        _end = _arr.data() + new_size;
+
+        PL_ASSERT(*written <= max_count);
+        end_ptr() = data() + old_size + *written;
         return {};
     }
 
+protected:
+    ListBase() = default;
+
+private:
+    [[nodiscard]] constexpr Derived &derived() noexcept
+    {
+        return static_cast<Derived &>(*this);
+    }
+
+    [[nodiscard]] constexpr Derived const &derived() const noexcept
+    {
+        return static_cast<Derived const &>(*this);
+    }
+
+    [[nodiscard]] constexpr T *&end_ptr() noexcept
+    {
+        return derived().list_end();
+    }
+
+    [[nodiscard]] constexpr T *end_ptr() const noexcept
+    {
+        return const_cast<Derived &>(derived()).list_end();
+    }
+
     // Returns the equivalent of std::distance(first, last) as the first element,
     // and the equivalent of std::next(first, std::min(std::distance(first, last), max_distance))
     // as the second element.
@@ -539,7 +542,7 @@ private:
             *ofirst = *first;
         }
         std::ranges::destroy(ofirst, olast);
-        _end = std::to_address(ofirst);
+        end_ptr() = std::to_address(ofirst);
 
         PL_TRY_DISCARD(append(first, last));
 
@@ -553,7 +556,6 @@ private:
         namespace rng = std::ranges;
 
         auto [new_size, mid] = distance_and_advance(first, last, static_cast<difference_type>(size()));
-        // auto new_size = size_type(std::distance(first, last));
         PL_TRY_DISCARD(reserve_capacity(static_cast<size_type>(new_size)));
 
         iterator it_begin = begin();
@@ -569,7 +571,7 @@ private:
             it_end = rng::uninitialized_copy(mid, last, it_end, it_begin + new_size).out;
         }
 
-        _end = std::to_address(it_begin + new_size);
+        end_ptr() = std::to_address(it_begin + new_size);
         return {};
     }
 
@@ -592,7 +594,7 @@ private:
         namespace rng = std::ranges;
         auto num_extra = std::distance(first, last);
         PL_TRY_DISCARD(reserve(size_type(num_extra)));
-        
+
         auto ofirst = end();
         auto olast = ofirst + num_extra;
         if consteval
@@ -605,7 +607,7 @@ private:
             rng::uninitialized_copy(first, last, ofirst, olast);
         }
 
-        _end = std::to_address(olast);
+        end_ptr() = std::to_address(olast);
         return ofirst;
     }
 
@@ -613,7 +615,7 @@ private:
     [[nodiscard]]
     constexpr RE<iterator, SimpleError> insert_elements(iterator pos, I first, S last)
     {
-        ArrayList tmp(_allocator);
+        ArrayList<T, A> tmp(derived().get_allocator());
         PL_TRY_DISCARD(tmp.append(first, last));
         return insert_elements(pos, tmp.begin(), tmp.end());
     }
@@ -647,7 +649,7 @@ private:
         iterator ifirst = std::max(
             pos,
             ilast - std::min(num_extra, static_cast<difference_type>(size())));
-        
+
         if consteval
         {
             iterator olast = ilast + num_extra;
@@ -663,31 +665,166 @@ private:
         ifirst = pos;
         rng::move_backward(ifirst, ilast, ilast + num_extra);
         rng::copy(first, mid, pos);
-        
+
         iterator new_end = pos + num_extra;
 
         if consteval
         {
             for (; mid != last && it_end != new_end; ++mid, ++it_end)
                 rng::construct_at(std::to_address(it_end), *mid);
-            
         }
         else
         {
             rng::uninitialized_copy(mid, last, it_end, pos + num_extra);
         }
-        _end += num_extra;
+        end_ptr() += num_extra;
         return pos;
     }
 
     [[nodiscard]] constexpr size_type get_new_geometric_capacity(size_type extra_capacity) noexcept
     {
-        size_type current_capacity = capacity();
+        size_type current_capacity = derived().capacity();
         return current_capacity + std::max(current_capacity / 2, extra_capacity);
     }
+};
+} // namespace pl::array_list_
+
+export namespace pl
+{
+template<class T, allocator A = default_allocator_t<T>>
+class ArrayList : public array_list_::ListBase<ArrayList<T, A>, T, A>
+{
+private:
+    using Base = array_list_::ListBase<ArrayList<T, A>, T, A>;
+    friend Base;
+
+public:
+    using typename Base::value_type;
+    using typename Base::allocator_type;
+    using typename Base::size_type;
+    using typename Base::difference_type;
+    using typename Base::reference;
+    using typename Base::const_reference;
+    using typename Base::pointer;
+    using typename Base::const_pointer;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using typename Base::reverse_iterator;
+    using typename Base::const_reverse_iterator;
+
+    [[nodiscard]] ArrayList() = default;
+
+    [[nodiscard]] explicit constexpr ArrayList(allocator_type const &a) noexcept
+    : _allocator(a) {}
+
+    [[nodiscard]] constexpr ArrayList(ArrayList &&other) noexcept
+    : 
+        _arr(std::exchange(other._arr, {})),
+        _end(std::exchange(other._end, {})),
+        _allocator(other._allocator)
+    {}
+
+    constexpr ArrayList &operator=(ArrayList &&other)
+    noexcept(std::is_nothrow_copy_assignable_v<A>)
+    {
+        _arr = std::exchange(other._arr, {});
+        _end = std::exchange(other._end, {});
+        _allocator = other._allocator;
+        return *this;
+    }
+
+    constexpr ~ArrayList()
+    {
+        std::ranges::destroy(_arr.data(), _end);
+        free(_allocator, _arr);
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _allocator;
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return _arr.size();
+    }
+
+    constexpr void swap(ArrayList &other)
+    {
+        using std::swap;
+        swap(_arr      , other._arr      );
+        swap(_end      , other._end      );
+        swap(_allocator, other._allocator);
+    }
+
+private:
+    [[nodiscard]] constexpr T *list_begin() const noexcept
+    {
+        return _arr.data();
+    }
+
+    [[nodiscard]] constexpr T *&list_end() noexcept
+    {
+        return _end;
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> reallocate(size_type const new_capacity)
+    {
+        namespace rng = std::ranges;
+
+        const size_type new_size = std::min(this->size(), new_capacity);
+        if !consteval
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                // Expands in place or reallocates, and the elements are relocated in bulk if moved.
+                // The tail is gone even if realloc fails, so the list must no longer cover it.
+                rng::destroy(_arr.data() + new_size, _end);
+                _end = _arr.data() + new_size;
+                PL_TRY_ASSIGN(_arr, realloc<T>(_allocator, _arr, new_capacity, new_size));
+                _end = _arr.data() + new_size;
+                return {};
+            }
+            else
+            {
+                if (new_size == this->size() && expand(_allocator, _arr, new_capacity))
+                {
+                    _arr = Span<T>(_arr.data(), new_capacity);
+                    return {};
+                }
+            }
+        }
+
+        RE<Span<T>, SimpleError> alloc_result = alloc<T>(_allocator, new_capacity);
+        if (!alloc_result) return {tags::error, std::move(alloc_result).error()};
+        Span<T> &new_arr = *alloc_result;
+        if consteval
+        {
+            auto ifirst = this->begin(); auto ilast  = this->end();
+            auto ofirst = new_arr.begin(); auto olast  = new_arr.end();
+            for (; ifirst != ilast && ofirst != olast; ++ifirst, ++ofirst)
+            {
+                rng::construct_at(std::to_address(ofirst), rng::iter_move(ifirst));
+            }
+        }
+        else
+        {
+            rng::uninitialized_move(*this, new_arr);
+        }
+        rng::destroy(*this);
+        free(_allocator, _arr);
+        _arr = new_arr;
+        _end = _arr.data() + new_size;
+        return {};
+    }
 
     Span<T> _arr = {};
     T *_end = {};
     [[no_unique_address]] A _allocator = {};
 };
+
+// ArrayList only refers to its elements through pointers, so it can be relocated
+// whenever its allocator can.
+template<class T, allocator A>
+struct is_trivially_relocatable<ArrayList<T, A>> : is_trivially_relocatable<A> {};
 } // export namespace pl
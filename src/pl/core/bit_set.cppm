@@ -0,0 +1,523 @@
+module;
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:bit_set;
+
+import :error;
+import :memory;
+import :null;
+import :result_error;
+import :simd;
+import :span;
+
+namespace pl::bit_set_
+{
+using word_type = std::uint64_t;
+
+constexpr std::size_t bitsPerWord = 64;
+constexpr std::size_t npos        = std::size_t(-1);
+
+[[nodiscard]]
+constexpr std::size_t numWordsFor(std::size_t numBits) noexcept
+{
+    return (numBits + bitsPerWord - 1) / bitsPerWord;
+}
+
+[[nodiscard]]
+constexpr word_type bitOf(std::size_t pos) noexcept
+{
+    return word_type(1) << (pos % bitsPerWord);
+}
+
+// The bits of the last word that are in use. Bits past the size are always kept clear,
+// so that whole words can be counted, compared and scanned.
+[[nodiscard]]
+constexpr word_type lastWordMask(std::size_t numBits) noexcept
+{
+    std::size_t used = numBits % bitsPerWord;
+    return used == 0 ? ~word_type(0) : bitOf(used) - 1;
+}
+
+// Index of the first set bit at or after pos, or npos.
+[[nodiscard]]
+constexpr std::size_t findFrom(Span<word_type const> words, std::size_t pos) noexcept
+{
+    std::size_t w = pos / bitsPerWord;
+    if (w >= words.size()) return npos;
+
+    word_type word = words[w] & (~word_type(0) << (pos % bitsPerWord));
+    while (!word)
+    {
+        if (++w == words.size()) return npos;
+        word = words[w];
+    }
+    return w * bitsPerWord + static_cast<std::size_t>(std::countr_zero(word));
+}
+
+[[nodiscard]]
+constexpr bool allSet(Span<word_type const> words, std::size_t numBits) noexcept
+{
+    if (words.empty()) return true;
+    for (std::size_t w = 0; w + 1 < words.size(); ++w)
+    {
+        if (words[w] != ~word_type(0)) return false;
+    }
+    return words[words.size() - 1] == lastWordMask(numBits);
+}
+
+[[nodiscard]]
+constexpr bool anySet(Span<word_type const> words) noexcept
+{
+    for (word_type word : words)
+    {
+        if (word) return true;
+    }
+    return false;
+}
+
+// Sets or clears the bits in [first, last).
+constexpr void assignRange(Span<word_type> words, std::size_t first, std::size_t last, bool value) noexcept
+{
+    if (first >= last) return;
+    std::size_t firstWord = first / bitsPerWord;
+    std::size_t lastWord  = (last - 1) / bitsPerWord;
+    for (std::size_t w = firstWord; w <= lastWord; ++w)
+    {
+        word_type mask = ~word_type(0);
+        if (w == firstWord) mask &= ~(bitOf(first) - 1);
+        if (w == lastWord)  mask &= lastWordMask(last);
+        words[w] = value ? words[w] | mask : words[w] & ~mask;
+    }
+}
+
+// Iterates over the indices of the set bits, a word at a time.
+class SetBitIterator
+{
+public:
+    using iterator_concept = std::forward_iterator_tag;
+    using difference_type  = std::ptrdiff_t;
+    using value_type       = std::size_t;
+
+    [[nodiscard]] SetBitIterator() = default;
+
+    [[nodiscard]] explicit constexpr SetBitIterator(Span<word_type const> words) noexcept
+    : _words(words.data()), _numWords(words.size()), _index(0), _word(words.empty() ? 0 : words[0])
+    {
+        skipEmpty();
+    }
+
+    [[nodiscard]]
+    constexpr std::size_t operator*() const noexcept
+    {
+        return _index * bitsPerWord + static_cast<std::size_t>(std::countr_zero(_word));
+    }
+
+    constexpr SetBitIterator &operator++() noexcept
+    {
+        _word &= _word - 1;
+        skipEmpty();
+        return *this;
+    }
+
+    constexpr SetBitIterator operator++(int) noexcept
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    [[nodiscard]] constexpr bool operator==(SetBitIterator const &) const noexcept = default;
+
+    [[nodiscard]]
+    constexpr bool operator==(std::default_sentinel_t) const noexcept
+    {
+        return _index == _numWords;
+    }
+
+private:
+    constexpr void skipEmpty() noexcept
+    {
+        while (!_word && _index < _numWords)
+        {
+            if (++_index < _numWords) _word = _words[_index];
+        }
+    }
+
+    word_type const *_words    = nullptr;
+    std::size_t      _numWords = 0;
+    std::size_t      _index    = 0;
+    word_type        _word     = 0;
+};
+
+class SetBits
+{
+public:
+    [[nodiscard]] explicit constexpr SetBits(Span<word_type const> words) noexcept : _words(words) {}
+
+    [[nodiscard]] constexpr SetBitIterator          begin() const noexcept { return SetBitIterator(_words); }
+    [[nodiscard]] constexpr std::default_sentinel_t end()   const noexcept { return {}; }
+
+private:
+    Span<word_type const> _words;
+};
+} // namespace pl::bit_set_
+
+export namespace pl
+{
+// Fixed-size set of bits, stored inline.
+//
+// Bits are packed into 64-bit words, which the bitwise operators process a whole word at a time,
+// and which are exposed as a Span for custom word-parallel code. Bits past size() are always clear.
+template<std::size_t N>
+requires (N != 0)
+class BitSet
+{
+public:
+    using word_type = bit_set_::word_type;
+    using size_type = std::size_t;
+
+    static constexpr size_type npos     = bit_set_::npos;
+    static constexpr size_type numWords = bit_set_::numWordsFor(N);
+
+    [[nodiscard]] constexpr BitSet() noexcept = default;
+
+    [[nodiscard]] static constexpr size_type size() noexcept { return N; }
+
+    [[nodiscard]]
+    constexpr bool test(size_type pos) const noexcept
+    {
+        PL_ASSERT(pos < N);
+        return _words[pos / bit_set_::bitsPerWord] & bit_set_::bitOf(pos);
+    }
+
+    constexpr BitSet &set(size_type pos) noexcept
+    {
+        PL_ASSERT(pos < N);
+        _words[pos / bit_set_::bitsPerWord] |= bit_set_::bitOf(pos);
+        return *this;
+    }
+
+    constexpr BitSet &set(size_type pos, bool value) noexcept
+    {
+        return value ? set(pos) : reset(pos);
+    }
+
+    constexpr BitSet &reset(size_type pos) noexcept
+    {
+        PL_ASSERT(pos < N);
+        _words[pos / bit_set_::bitsPerWord] &= ~bit_set_::bitOf(pos);
+        return *this;
+    }
+
+    constexpr BitSet &flip(size_type pos) noexcept
+    {
+        PL_ASSERT(pos < N);
+        _words[pos / bit_set_::bitsPerWord] ^= bit_set_::bitOf(pos);
+        return *this;
+    }
+
+    constexpr BitSet &set() noexcept
+    {
+        simd::fill(words(), ~word_type(0));
+        _words[numWords - 1] = bit_set_::lastWordMask(N);
+        return *this;
+    }
+
+    constexpr BitSet &reset() noexcept
+    {
+        simd::fill(words(), word_type(0));
+        return *this;
+    }
+
+    constexpr BitSet &flip() noexcept
+    {
+        simd::transform(words(), words(), std::bit_not<>());
+        _words[numWords - 1] &= bit_set_::lastWordMask(N);
+        return *this;
+    }
+
+    [[nodiscard]] constexpr size_type count() const noexcept { return simd::popcount(words()); }
+
+    [[nodiscard]] constexpr bool any()  const noexcept { return bit_set_::anySet(words());     }
+    [[nodiscard]] constexpr bool none() const noexcept { return !any();                        }
+    [[nodiscard]] constexpr bool all()  const noexcept { return bit_set_::allSet(words(), N);  }
+
+    // Index of the first set bit, or npos.
+    [[nodiscard]] constexpr size_type find_first() const noexcept { return bit_set_::findFrom(words(), 0); }
+
+    // Index of the first set bit at or after pos, or npos.
+    [[nodiscard]] constexpr size_type find_next(size_type pos) const noexcept { return bit_set_::findFrom(words(), pos); }
+
+    // Range over the indices of the set bits, in increasing order.
+    [[nodiscard]] constexpr bit_set_::SetBits set_bits() const noexcept { return bit_set_::SetBits(words()); }
+
+    // Bits past size() in the last word must be left clear.
+    [[nodiscard]] constexpr Span<word_type,       numWords> words()       noexcept { return Span<word_type,       numWords>(_words); }
+    [[nodiscard]] constexpr Span<word_type const, numWords> words() const noexcept { return Span<word_type const, numWords>(_words); }
+
+    constexpr BitSet &operator&=(BitSet const &other) noexcept
+    {
+        simd::transform(words(), other.words(), words(), std::bit_and<>());
+        return *this;
+    }
+
+    constexpr BitSet &operator|=(BitSet const &other) noexcept
+    {
+        simd::transform(words(), other.words(), words(), std::bit_or<>());
+        return *this;
+    }
+
+    constexpr BitSet &operator^=(BitSet const &other) noexcept
+    {
+        simd::transform(words(), other.words(), words(), std::bit_xor<>());
+        return *this;
+    }
+
+    // Clears the bits that are set in other.
+    constexpr BitSet &and_not(BitSet const &other) noexcept
+    {
+        simd::transform(words(), other.words(), words(), [](word_type a, word_type b) { return a & ~b; });
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr BitSet operator&(BitSet a, BitSet const &b) noexcept { return a &= b; }
+    [[nodiscard]] friend constexpr BitSet operator|(BitSet a, BitSet const &b) noexcept { return a |= b; }
+    [[nodiscard]] friend constexpr BitSet operator^(BitSet a, BitSet const &b) noexcept { return a ^= b; }
+    [[nodiscard]] friend constexpr BitSet operator~(BitSet a)                  noexcept { return a.flip(); }
+
+    [[nodiscard]] friend constexpr bool operator==(BitSet const &, BitSet const &) noexcept = default;
+
+private:
+    word_type _words[numWords] = {};
+};
+
+// Set of bits whose size is chosen at runtime, with words allocated from A.
+//
+// Supports the same operations as BitSet. The bitwise operators require both sets to have the same size.
+template<allocator A = default_allocator_t<bit_set_::word_type>>
+class DynamicBitSet
+{
+public:
+    using word_type      = bit_set_::word_type;
+    using size_type      = std::size_t;
+    using allocator_type = A;
+
+    static constexpr size_type npos = bit_set_::npos;
+
+    [[nodiscard]] DynamicBitSet() = default;
+
+    [[nodiscard]] explicit constexpr DynamicBitSet(allocator_type const &a) noexcept
+    : _allocator(a) {}
+
+    [[nodiscard]] constexpr DynamicBitSet(DynamicBitSet &&other) noexcept
+    :
+        _words(std::exchange(other._words, {})),
+        _size(std::exchange(other._size, 0)),
+        _allocator(other._allocator)
+    {}
+
+    constexpr DynamicBitSet &operator=(DynamicBitSet &&other) noexcept
+    {
+        free(_allocator, _words);
+        _words     = std::exchange(other._words, {});
+        _size      = std::exchange(other._size, 0);
+        _allocator = other._allocator;
+        return *this;
+    }
+
+    constexpr ~DynamicBitSet()
+    {
+        free(_allocator, _words);
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return _allocator; }
+
+    [[nodiscard]] constexpr size_type size()     const noexcept { return _size;                                   }
+    [[nodiscard]] constexpr bool      empty()    const noexcept { return _size == 0;                              }
+    [[nodiscard]] constexpr size_type capacity() const noexcept { return _words.size() * bit_set_::bitsPerWord;  }
+    [[nodiscard]] constexpr size_type numWords() const noexcept { return bit_set_::numWordsFor(_size);           }
+
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> reserve(size_type numBits) noexcept
+    {
+        if (numBits <= capacity()) return {};
+        return reallocate(bit_set_::numWordsFor(numBits));
+    }
+
+    // New bits are set to value.
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> resize(size_type numBits, bool value = false) noexcept
+    {
+        size_type oldWords = numWords();
+        size_type newWords = bit_set_::numWordsFor(numBits);
+        if (newWords > _words.size())
+        {
+            PL_TRY_DISCARD(reallocate(std::max(newWords, 2 * _words.size())));
+        }
+
+        if (numBits > _size)
+        {
+            // Words past the old size were never written.
+            std::fill(_words.data() + oldWords, _words.data() + newWords, word_type(0));
+            if (value) bit_set_::assignRange(_words, _size, numBits, true);
+        }
+        else if (newWords != 0)
+        {
+            _words[newWords - 1] &= bit_set_::lastWordMask(numBits);
+        }
+        _size = numBits;
+        return {};
+    }
+
+    // Keeps the capacity.
+    constexpr void clear() noexcept
+    {
+        _size = 0;
+    }
+
+    [[nodiscard]]
+    constexpr bool test(size_type pos) const noexcept
+    {
+        PL_ASSERT(pos < _size);
+        return _words[pos / bit_set_::bitsPerWord] & bit_set_::bitOf(pos);
+    }
+
+    constexpr DynamicBitSet &set(size_type pos) noexcept
+    {
+        PL_ASSERT(pos < _size);
+        _words[pos / bit_set_::bitsPerWord] |= bit_set_::bitOf(pos);
+        return *this;
+    }
+
+    constexpr DynamicBitSet &set(size_type pos, bool value) noexcept
+    {
+        return value ? set(pos) : reset(pos);
+    }
+
+    constexpr DynamicBitSet &reset(size_type pos) noexcept
+    {
+        PL_ASSERT(pos < _size);
+        _words[pos / bit_set_::bitsPerWord] &= ~bit_set_::bitOf(pos);
+        return *this;
+    }
+
+    constexpr DynamicBitSet &flip(size_type pos) noexcept
+    {
+        PL_ASSERT(pos < _size);
+        _words[pos / bit_set_::bitsPerWord] ^= bit_set_::bitOf(pos);
+        return *this;
+    }
+
+    constexpr DynamicBitSet &set() noexcept
+    {
+        bit_set_::assignRange(words(), 0, _size, true);
+        return *this;
+    }
+
+    constexpr DynamicBitSet &reset() noexcept
+    {
+        simd::fill(words(), word_type(0));
+        return *this;
+    }
+
+    constexpr DynamicBitSet &flip() noexcept
+    {
+        if (empty()) return *this;
+        simd::transform(words(), words(), std::bit_not<>());
+        _words[numWords() - 1] &= bit_set_::lastWordMask(_size);
+        return *this;
+    }
+
+    [[nodiscard]] constexpr size_type count() const noexcept { return simd::popcount(words()); }
+
+    [[nodiscard]] constexpr bool any()  const noexcept { return bit_set_::anySet(words());        }
+    [[nodiscard]] constexpr bool none() const noexcept { return !any();                           }
+    [[nodiscard]] constexpr bool all()  const noexcept { return bit_set_::allSet(words(), _size); }
+
+    [[nodiscard]] constexpr size_type find_first()              const noexcept { return bit_set_::findFrom(words(), 0);   }
+    [[nodiscard]] constexpr size_type find_next(size_type pos)  const noexcept { return bit_set_::findFrom(words(), pos); }
+
+    [[nodiscard]] constexpr bit_set_::SetBits set_bits() const noexcept { return bit_set_::SetBits(words()); }
+
+    // Bits past size() in the last word must be left clear.
+    [[nodiscard]] constexpr Span<word_type>       words()       noexcept { return {_words.data(), numWords()}; }
+    [[nodiscard]] constexpr Span<word_type const> words() const noexcept { return {_words.data(), numWords()}; }
+
+    constexpr DynamicBitSet &operator&=(DynamicBitSet const &other) noexcept
+    {
+        PL_ASSERT(_size == other._size);
+        simd::transform(words(), other.words(), words(), std::bit_and<>());
+        return *this;
+    }
+
+    constexpr DynamicBitSet &operator|=(DynamicBitSet const &other) noexcept
+    {
+        PL_ASSERT(_size == other._size);
+        simd::transform(words(), other.words(), words(), std::bit_or<>());
+        return *this;
+    }
+
+    constexpr DynamicBitSet &operator^=(DynamicBitSet const &other) noexcept
+    {
+        PL_ASSERT(_size == other._size);
+        simd::transform(words(), other.words(), words(), std::bit_xor<>());
+        return *this;
+    }
+
+    // Clears the bits that are set in other.
+    constexpr DynamicBitSet &and_not(DynamicBitSet const &other) noexcept
+    {
+        PL_ASSERT(_size == other._size);
+        simd::transform(words(), other.words(), words(), [](word_type a, word_type b) { return a & ~b; });
+        return *this;
+    }
+
+    [[nodiscard]]
+    friend constexpr bool operator==(DynamicBitSet const &a, DynamicBitSet const &b) noexcept
+    {
+        return a._size == b._size && std::ranges::equal(a.words(), b.words());
+    }
+
+    constexpr void swap(DynamicBitSet &other) noexcept
+    {
+        using std::swap;
+        swap(_words    , other._words    );
+        swap(_size     , other._size     );
+        swap(_allocator, other._allocator);
+    }
+
+private:
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> reallocate(size_type const new_capacity) noexcept
+    {
+        if !consteval
+        {
+            PL_TRY_ASSIGN(_words, realloc<word_type>(_allocator, _words, new_capacity, numWords()));
+            return {};
+        }
+
+        // Constant evaluation needs every word to be constructed before it is written.
+        PL_TRY_ASSIGN(Span<word_type> new_words, alloc<word_type>(_allocator, new_capacity));
+        for (size_type w = 0; w < new_capacity; ++w)
+        {
+            std::construct_at(new_words.data() + w, w < numWords() ? _words[w] : word_type(0));
+        }
+        free(_allocator, _words);
+        _words = new_words;
+        return {};
+    }
+
+                          Span<word_type> _words;
+                          size_type       _size = 0;
+    [[no_unique_address]] allocator_type  _allocator = {};
+};
+} // export namespace pl
@@ -0,0 +1,349 @@
+module;
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:concurrent_queue;
+
+import :error;
+import :memory;
+import :null;
+import :optional;
+import :result_error;
+import :span;
+
+export namespace pl
+{
+class QueueFull : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "QueueFull";
+    }
+};
+} // export namespace pl
+
+namespace pl::concurrent_queue_
+{
+template<class T>
+struct Storage
+{
+    alignas(T) std::byte bytes[sizeof(T)];
+
+    [[nodiscard]] T *get() noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(bytes));
+    }
+};
+
+// Capacities are rounded up to a power of two, so that positions wrap around with a mask.
+[[nodiscard]]
+constexpr std::size_t roundCapacity(std::size_t capacity) noexcept
+{
+    return std::bit_ceil(capacity < 2 ? std::size_t(2) : capacity);
+}
+} // namespace pl::concurrent_queue_
+
+export namespace pl
+{
+// Bounded, lock-free queue between exactly one producer thread and one consumer thread.
+//
+// The producer only writes _tail and the consumer only writes _head, each on its own cache line.
+// Each side also keeps a private copy of the other side's index, and only reloads it when the copy
+// says the queue is full or empty, so that the two cache lines rarely bounce between cores.
+//
+// Neither side ever blocks: try_push reports a full queue as a QueueFull error,
+// and try_pop reports an empty queue as an empty Opt.
+template<class T, allocator A = AlignedAllocator>
+requires std::is_nothrow_move_constructible_v<T>
+class SPSCQueue
+{
+public:
+    using value_type     = T;
+    using allocator_type = A;
+    using size_type      = std::size_t;
+
+    [[nodiscard]] SPSCQueue() = default;
+
+    [[nodiscard]] explicit SPSCQueue(allocator_type const &a) noexcept
+    : _allocator(a) {}
+
+    SPSCQueue           (SPSCQueue const &) = delete;
+    SPSCQueue &operator=(SPSCQueue const &) = delete;
+
+    ~SPSCQueue()
+    {
+        release();
+    }
+
+    // Allocates room for at least capacity elements, discarding any element still queued.
+    // Must not be called while either side is using the queue.
+    [[nodiscard]] RE<void, SimpleError> init(size_type capacity) noexcept
+    {
+        release();
+        size_type rounded = concurrent_queue_::roundCapacity(capacity);
+        PL_TRY_ASSIGN(_slots, alloc<concurrent_queue_::Storage<T>>(_allocator, rounded));
+        _mask = rounded - 1;
+        return {};
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return _slots.size();
+    }
+
+    // Only exact while neither side is using the queue.
+    [[nodiscard]] size_type size_approx() const noexcept
+    {
+        return
+            _tail.value.load(std::memory_order_acquire)
+          - _head.value.load(std::memory_order_acquire);
+    }
+
+    // Producer only.
+    template<class ...Args>
+    [[nodiscard]]
+    RE<void, SimpleError> try_emplace(Args &&...args)
+    noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    requires std::is_constructible_v<T, Args...>
+    {
+        size_type tail = _tail.value.load(std::memory_order_relaxed);
+        if (tail - _tail.cachedOther == capacity())
+        {
+            _tail.cachedOther = _head.value.load(std::memory_order_acquire);
+            if (tail - _tail.cachedOther == capacity())
+                return {tags::error, getSingleton<QueueFull>()};
+        }
+
+        std::construct_at(_slots[tail & _mask].get(), std::forward<Args>(args)...);
+        _tail.value.store(tail + 1, std::memory_order_release);
+        return {};
+    }
+
+    // Producer only.
+    [[nodiscard]] RE<void, SimpleError> try_push(T value) noexcept
+    {
+        return try_emplace(std::move(value));
+    }
+
+    // Consumer only.
+    [[nodiscard]] Opt<T> try_pop() noexcept
+    {
+        size_type head = _head.value.load(std::memory_order_relaxed);
+        if (head == _head.cachedOther)
+        {
+            _head.cachedOther = _tail.value.load(std::memory_order_acquire);
+            if (head == _head.cachedOther)
+                return {};
+        }
+
+        T *slot = _slots[head & _mask].get();
+        Opt<T> value(std::move(*slot));
+        std::destroy_at(slot);
+        _head.value.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+private:
+    struct alignas(cacheLineSize) Index
+    {
+        std::atomic<size_type> value       = 0;
+        size_type              cachedOther = 0;
+    };
+
+    void release() noexcept
+    {
+        if (_slots.empty()) return;
+
+        for (size_type i = _head.value.load(std::memory_order_relaxed); i != _tail.value.load(std::memory_order_relaxed); ++i)
+            std::destroy_at(_slots[i & _mask].get());
+
+        free(_allocator, _slots);
+        _slots = {};
+        _mask  = 0;
+        _head  .value.store(0, std::memory_order_relaxed);
+        _tail  .value.store(0, std::memory_order_relaxed);
+        _head  .cachedOther = 0;
+        _tail  .cachedOther = 0;
+    }
+
+    // Written by the consumer, cachedOther caches _tail.
+    Index _head;
+    // Written by the producer, cachedOther caches _head.
+    Index _tail;
+
+    alignas(cacheLineSize)
+    Span<concurrent_queue_::Storage<T>> _slots;
+    size_type                           _mask = 0;
+    [[no_unique_address]] A             _allocator = {};
+};
+
+// Bounded, lock-free queue between any number of producer and consumer threads,
+// after Dmitry Vyukov's bounded MPMC queue.
+//
+// Each cell carries a sequence number that tells producers and consumers whose turn it is,
+// so the only contended writes are the compare-exchanges on _enqueuePos and _dequeuePos,
+// which live on separate cache lines.
+//
+// Like SPSCQueue, it never blocks: a full queue is reported as a QueueFull error,
+// and an empty queue as an empty Opt.
+template<class T, allocator A = AlignedAllocator>
+requires std::is_nothrow_move_constructible_v<T>
+class MPMCQueue
+{
+public:
+    using value_type     = T;
+    using allocator_type = A;
+    using size_type      = std::size_t;
+
+    [[nodiscard]] MPMCQueue() = default;
+
+    [[nodiscard]] explicit MPMCQueue(allocator_type const &a) noexcept
+    : _allocator(a) {}
+
+    MPMCQueue           (MPMCQueue const &) = delete;
+    MPMCQueue &operator=(MPMCQueue const &) = delete;
+
+    ~MPMCQueue()
+    {
+        release();
+    }
+
+    // Allocates room for at least capacity elements, discarding any element still queued.
+    // Must not be called while any thread is using the queue.
+    [[nodiscard]] RE<void, SimpleError> init(size_type capacity) noexcept
+    {
+        release();
+        size_type rounded = concurrent_queue_::roundCapacity(capacity);
+        PL_TRY_ASSIGN(_cells, alloc<Cell>(_allocator, rounded));
+        for (size_type i = 0; i < rounded; ++i)
+            std::construct_at(&_cells[i].sequence, i);
+        _mask = rounded - 1;
+        return {};
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return _cells.size();
+    }
+
+    // Only exact while no thread is using the queue.
+    [[nodiscard]] size_type size_approx() const noexcept
+    {
+        size_type enqueued = _enqueuePos.load(std::memory_order_acquire);
+        size_type dequeued = _dequeuePos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    template<class ...Args>
+    [[nodiscard]]
+    RE<void, SimpleError> try_emplace(Args &&...args)
+    noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    requires std::is_constructible_v<T, Args...>
+    {
+        assert(!_cells.empty() && "init must succeed before the queue is used");
+        size_type pos = _enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &_cells[pos & _mask];
+            size_type sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return {tags::error, getSingleton<QueueFull>()};
+            else
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+
+        std::construct_at(cell->storage.get(), std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return {};
+    }
+
+    [[nodiscard]] RE<void, SimpleError> try_push(T value) noexcept
+    {
+        return try_emplace(std::move(value));
+    }
+
+    [[nodiscard]] Opt<T> try_pop() noexcept
+    {
+        assert(!_cells.empty() && "init must succeed before the queue is used");
+        size_type pos = _dequeuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &_cells[pos & _mask];
+            size_type sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0)
+            {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return {};
+            else
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+        }
+
+        T *slot = cell->storage.get();
+        Opt<T> value(std::move(*slot));
+        std::destroy_at(slot);
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return value;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_type>         sequence;
+        concurrent_queue_::Storage<T>  storage;
+    };
+
+    void release() noexcept
+    {
+        if (_cells.empty()) return;
+
+        while (try_pop());
+        for (Cell &cell : _cells)
+            std::destroy_at(&cell.sequence);
+
+        free(_allocator, _cells);
+        _cells = {};
+        _mask  = 0;
+        _enqueuePos.store(0, std::memory_order_relaxed);
+        _dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    alignas(cacheLineSize) std::atomic<size_type> _enqueuePos = 0;
+    alignas(cacheLineSize) std::atomic<size_type> _dequeuePos = 0;
+
+    alignas(cacheLineSize)
+    Span<Cell>              _cells;
+    size_type               _mask = 0;
+    [[no_unique_address]] A _allocator = {};
+};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(concurrent_queue_::roundCapacity(0) == 2);
+static_assert(concurrent_queue_::roundCapacity(5) == 8);
+static_assert(concurrent_queue_::roundCapacity(8) == 8);
+} // namespace pl
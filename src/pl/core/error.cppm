@@ -1,6 +1,8 @@
 module;
 #include <concepts>
+#include <cstddef>
 #include <initializer_list>
+#include <ostream>
 #include <source_location>
 #include <type_traits>
 #include <utility>
@@ -10,6 +12,8 @@ export module pl.core:error;
 export import :tags;
 export import :singleton;
 
+import :error_trace;
+import :null_trait;
 import :traits;
 
 import :result_error;
@@ -206,40 +210,205 @@ private:
 template<class T>
 Error(T) -> Error<T>;
 
+// An error type together with the place it is raised at.
+class ErrorSite
+{
+public:
+    [[nodiscard]] constexpr ErrorSite(ErrorType const &type, std::source_location where) noexcept
+    : _type(&type), _where(where) {}
+
+    [[nodiscard]] constexpr ErrorType const     &errorType() const noexcept { return *_type; }
+    [[nodiscard]] constexpr std::source_location where()     const noexcept { return _where; }
+
+private:
+    ErrorType const      *_type;
+    std::source_location  _where;
+};
+
+// Raises an error of type T at the call site:
+//
+//     return {tags::error, errorSite<VulkanError>()};
+//
+// Error infos that keep no context just take the type.
+template<std::derived_from<ErrorType> T>
+[[nodiscard]]
+constexpr ErrorSite errorSite(std::source_location where = std::source_location::current()) noexcept
+{
+    return {getSingleton<T>(), where};
+}
+
 class SimpleErrorInfo
 {
 public:
     [[nodiscard]] constexpr SimpleErrorInfo(ErrorType const &type) noexcept : _type(&type) {}
+    [[nodiscard]] constexpr SimpleErrorInfo(ErrorSite const &site) noexcept : _type(&site.errorType()) {}
     [[nodiscard]] constexpr ErrorType const &errorType() const noexcept { return *_type; }
 
 private:
+    friend struct SimpleErrorInfoHiddenNullTrait;
+
+    [[nodiscard]] explicit constexpr SimpleErrorInfo(std::nullptr_t) noexcept : _type(nullptr) {}
+
     ErrorType const *_type;
 };
 
+// A SimpleErrorInfo always refers to an error type, which leaves the null pointer free
+// for Optional and ResultError to mark the absence of an error.
+struct SimpleErrorInfoHiddenNullTrait
+{
+    [[nodiscard]]
+    static constexpr bool isNull(SimpleErrorInfo const &info) noexcept
+    {
+        return info._type == nullptr;
+    }
+
+    [[nodiscard]]
+    static constexpr SimpleErrorInfo null() noexcept
+    {
+        return SimpleErrorInfo(nullptr);
+    }
+
+    static constexpr void assignNull(SimpleErrorInfo &info) noexcept
+    {
+        info._type = nullptr;
+    }
+};
+
+SimpleErrorInfoHiddenNullTrait plHiddenNullable(SimpleErrorInfo const &);
+
+template<class ErrorInfo>
+requires hidden_nullable<ErrorInfo>
+struct ErrorHiddenNullTrait
+{
+    using info_null_trait = decltype(plHiddenNullable(std::declval<ErrorInfo const &>()));
+
+    [[nodiscard]]
+    static constexpr bool isNull(Error<ErrorInfo> const &error) noexcept
+    {
+        return info_null_trait::isNull(error.info());
+    }
+
+    [[nodiscard]]
+    static constexpr Error<ErrorInfo> null() noexcept
+    {
+        return Error<ErrorInfo>(info_null_trait::null());
+    }
+
+    static constexpr void assignNull(Error<ErrorInfo> &error) noexcept
+    {
+        info_null_trait::assignNull(error.info());
+    }
+};
+
+template<class ErrorInfo>
+requires hidden_nullable<ErrorInfo>
+ErrorHiddenNullTrait<ErrorInfo> plHiddenNullable(Error<ErrorInfo> const &);
+
 using SimpleError = Error<SimpleErrorInfo>;
 
-// TODO: StacktracedErrorInfo
-
-// class ErrorInfo {
-// public:
-//     constexpr ErrorInfo(
-//         ErrorType const &errorType,
-//         std::source_location &&srcLoc = std::source_location::current())
-//     noexcept
-//     :
-//         _errorType(&errorType), _srcLoc(std::move(srcLoc))
-//     {}
-// 
-//     ErrorInfo(ErrorInfo &&) = default;
-//     ErrorInfo &operator=(ErrorInfo &&) = default;
-// 
-// private:
-//     ErrorType const *_errorType;
-//     std::source_location _srcLoc;
-// };
+// Error info that also remembers where the error was raised, the call stack at that point,
+// and every PL_TRY that propagated it on the raising thread.
+//
+// Raising an error walks the frame pointers into a record of a per-thread ring, and each PL_TRY adds
+// one site to it, so the error path never allocates or locks. Symbolization waits until the error is written
+// out. The ring is reused as errors are raised, so a trace should be written out soon after it is raised,
+// and while the raising thread is still alive. An older trace reads as expired.
+class StacktracedErrorInfo
+{
+public:
+    // Without an ErrorSite only the stack is known, not the line that raised the error.
+    [[nodiscard]] StacktracedErrorInfo(ErrorType const &type) noexcept
+    : _type(&type), _where(), _trace(error_trace_::capture()) {}
+
+    [[nodiscard]] StacktracedErrorInfo(ErrorSite const &site) noexcept
+    : _type(&site.errorType()), _where(site.where()), _trace(error_trace_::capture()) {}
+
+    [[nodiscard]] constexpr ErrorType const     &errorType() const noexcept { return *_type;  }
+    [[nodiscard]] constexpr std::source_location where()     const noexcept { return _where;  }
+
+    // Called by PL_TRY_ASSIGN and PL_TRY_DISCARD for every function the error is returned through.
+    void propagate(std::source_location site) noexcept
+    {
+        error_trace_::notePropagation(_trace, site);
+    }
+
+    [[nodiscard]] ErrorTrace trace() const noexcept
+    {
+        ErrorTrace trace;
+        error_trace_::read(_trace, trace);
+        return trace;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, StacktracedErrorInfo const &info)
+    {
+        os << info.errorType().name();
+        if (info._where.line() != 0)
+        {
+            os << " raised at " << info._where.file_name() << ':' << info._where.line()
+               << " in " << info._where.function_name();
+        }
+        return os << '\n' << info.trace();
+    }
+
+private:
+    friend struct StacktracedErrorInfoHiddenNullTrait;
+
+    [[nodiscard]] explicit constexpr StacktracedErrorInfo(std::nullptr_t) noexcept
+    : _type(nullptr), _where(), _trace{nullptr, 0} {}
+
+    ErrorType const       *_type;
+    std::source_location   _where;
+    error_trace_::Handle   _trace;
+};
+
+struct StacktracedErrorInfoHiddenNullTrait
+{
+    [[nodiscard]]
+    static constexpr bool isNull(StacktracedErrorInfo const &info) noexcept
+    {
+        return info._type == nullptr;
+    }
+
+    [[nodiscard]]
+    static constexpr StacktracedErrorInfo null() noexcept
+    {
+        return StacktracedErrorInfo(nullptr);
+    }
+
+    static constexpr void assignNull(StacktracedErrorInfo &info) noexcept
+    {
+        info._type = nullptr;
+    }
+};
+
+StacktracedErrorInfoHiddenNullTrait plHiddenNullable(StacktracedErrorInfo const &);
+
+using StacktracedError = Error<StacktracedErrorInfo>;
+
+// Used by PL_TRY_ASSIGN and PL_TRY_DISCARD on their error path, lets error infos that keep a trace
+// record the function the error is being returned from.
+template<class E>
+[[nodiscard]]
+constexpr E &&propagateError(E &&error, std::source_location site = std::source_location::current()) noexcept
+{
+    if constexpr (requires { error.info().propagate(site); })
+    {
+        if !consteval
+        {
+            error.info().propagate(site);
+        }
+    }
+    return std::forward<E>(error);
+}
 } // export namespace pl
 
 namespace pl
 {
 static_assert(error_info<SimpleErrorInfo>, "SimpleErrorInfo must satisfy error_info constraint");
+static_assert(hidden_nullable<SimpleError>);
+static_assert(sizeof(RE<void, SimpleError>) == sizeof(void *));
+static_assert(std::is_trivially_copyable_v<RE<void, SimpleError>>);
+static_assert(error_info<StacktracedErrorInfo>);
+static_assert(hidden_nullable<StacktracedError>);
+static_assert(sizeof(RE<void, StacktracedError>) == sizeof(StacktracedError));
 }
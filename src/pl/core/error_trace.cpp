@@ -0,0 +1,210 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+#include <source_location>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+#if defined(__linux__)
+#   include <pthread.h>
+#endif
+
+module pl.core;
+
+import :error_trace;
+
+namespace pl::error_trace_
+{
+struct Record
+{
+    // 0 while the record is being written.
+    std::atomic<std::uint32_t>        sequence;
+    std::atomic<std::uint32_t>        numFrames;
+    std::atomic<std::uint32_t>        numSites;
+    std::atomic<void *>               frames[ErrorTrace::maxFrames];
+    std::atomic<std::source_location> sites[ErrorTrace::maxSites];
+};
+
+namespace
+{
+constexpr std::uint32_t  ringSize     = 32;
+// A frame pointer that jumps further than this is not a frame pointer, but whatever a function
+// compiled without frame pointers left in the register.
+constexpr std::uintptr_t maxFrameSize = std::uintptr_t(1) << 20;
+
+struct Ring
+{
+    Record         records[ringSize];
+    std::uint32_t  next;
+    // Frame pointers outside of the stack of the thread are never followed.
+    std::uintptr_t stackLow;
+    std::uintptr_t stackHigh;
+};
+
+constinit thread_local Ring          ring  = {};
+constinit std::atomic<std::uint32_t> depth = ErrorTrace::maxFrames;
+
+void initStackBounds(Ring &r, std::uintptr_t fp) noexcept
+{
+#if defined(__linux__)
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0)
+    {
+        void        *low;
+        std::size_t  size;
+        bool const   ok = pthread_attr_getstack(&attr, &low, &size) == 0;
+        pthread_attr_destroy(&attr);
+        if (ok)
+        {
+            r.stackLow  = reinterpret_cast<std::uintptr_t>(low);
+            r.stackHigh = r.stackLow + size;
+            return;
+        }
+    }
+#endif
+    // Without the real bounds, only frames close above the current one are followed.
+    r.stackLow  = fp;
+    r.stackHigh = fp + 64 * maxFrameSize;
+}
+
+[[nodiscard]]
+bool owns(Ring const &r, Record const *record) noexcept
+{
+    auto const address = reinterpret_cast<std::uintptr_t>(record);
+    auto const begin   = reinterpret_cast<std::uintptr_t>(r.records);
+    return address >= begin && address < begin + sizeof(r.records);
+}
+} // namespace
+
+[[gnu::noinline]]
+Handle capture() noexcept
+{
+    Ring &r  = ring;
+    auto  fp = reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+    if (r.stackHigh == 0) initStackBounds(r, fp);
+
+    std::uint32_t sequence = ++r.next;
+    if (sequence == 0) sequence = ++r.next;
+
+    Record &record = r.records[sequence % ringSize];
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Every frame starts with the caller's frame pointer, followed by the return address.
+    std::uint32_t const maxDepth  = depth.load(std::memory_order_relaxed);
+    std::uint32_t       numFrames = 0;
+    while (numFrames < maxDepth
+        && fp >= r.stackLow
+        && fp + 2 * sizeof(void *) <= r.stackHigh
+        && fp % alignof(void *) == 0)
+    {
+        void *const *frame = reinterpret_cast<void *const *>(fp);
+        if (!frame[1]) break;
+        record.frames[numFrames++].store(frame[1], std::memory_order_relaxed);
+
+        // Stacks grow downwards, so callers always have higher frame pointers.
+        auto const next = reinterpret_cast<std::uintptr_t>(frame[0]);
+        if (next <= fp || next - fp > maxFrameSize) break;
+        fp = next;
+    }
+
+    record.numFrames.store(numFrames, std::memory_order_relaxed);
+    record.numSites .store(0,         std::memory_order_relaxed);
+    record.sequence .store(sequence,  std::memory_order_release);
+    return {&record, sequence};
+}
+
+void notePropagation(Handle handle, std::source_location site) noexcept
+{
+    Record *record = handle.record;
+    if (!record || !owns(ring, record)) return;
+    if (record->sequence.load(std::memory_order_relaxed) != handle.sequence) return;
+
+    std::uint32_t const numSites = record->numSites.load(std::memory_order_relaxed);
+    if (numSites < ErrorTrace::maxSites) record->sites[numSites].store(site, std::memory_order_relaxed);
+    record->numSites.store(numSites + 1, std::memory_order_release);
+}
+
+void read(Handle handle, ErrorTrace &trace) noexcept
+{
+    trace = {};
+    Record const *record = handle.record;
+    if (!record) return;
+
+    // The owning thread may reuse the record at any time, so the copy is only kept if the sequence
+    // number is unchanged after it.
+    trace.expired = true;
+    if (record->sequence.load(std::memory_order_acquire) != handle.sequence) return;
+
+    trace.numFrames = record->numFrames.load(std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < trace.numFrames; ++i)
+        trace.frames[i] = record->frames[i].load(std::memory_order_relaxed);
+
+    trace.numSites = record->numSites.load(std::memory_order_acquire);
+    for (std::uint32_t i = 0; i < std::min(trace.numSites, ErrorTrace::maxSites); ++i)
+        trace.sites[i] = record->sites[i].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (record->sequence.load(std::memory_order_relaxed) != handle.sequence)
+    {
+        trace = {};
+        trace.expired = true;
+        return;
+    }
+    trace.expired = false;
+}
+} // namespace pl::error_trace_
+
+namespace pl
+{
+std::ostream &operator<<(std::ostream &os, ErrorTrace const &trace)
+{
+    if (trace.expired) return os << "  (trace expired)\n";
+
+    for (std::uint32_t i = 0; i < trace.numFrames; ++i)
+    {
+        os << "  #" << i << ' ' << trace.frames[i];
+
+        // Return addresses point past the call, which may already be the next function.
+        auto const address = reinterpret_cast<std::uintptr_t>(trace.frames[i]);
+        Dl_info    info;
+        if (dladdr(reinterpret_cast<void const *>(address - 1), &info))
+        {
+            if (info.dli_sname)
+            {
+                int   status;
+                char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                os << ' ' << (status == 0 ? demangled : info.dli_sname)
+                   << "+0x" << std::hex << address - reinterpret_cast<std::uintptr_t>(info.dli_saddr) << std::dec;
+                std::free(demangled);
+            }
+            else if (info.dli_fname)
+            {
+                os << ' ' << info.dli_fname
+                   << "+0x" << std::hex << address - reinterpret_cast<std::uintptr_t>(info.dli_fbase) << std::dec;
+            }
+        }
+        os << '\n';
+    }
+
+    for (std::uint32_t i = 0; i < std::min(trace.numSites, ErrorTrace::maxSites); ++i)
+    {
+        std::source_location const &site = trace.sites[i];
+        os << "  propagated at " << site.file_name() << ':' << site.line()
+           << " in " << site.function_name() << '\n';
+    }
+    if (trace.numSites > ErrorTrace::maxSites)
+        os << "  propagated " << trace.numSites - ErrorTrace::maxSites << " more times\n";
+    return os;
+}
+
+void setErrorTraceDepth(std::uint32_t depth) noexcept
+{
+    error_trace_::depth.store(std::min(depth, ErrorTrace::maxFrames), std::memory_order_relaxed);
+}
+} // namespace pl
@@ -0,0 +1,57 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <source_location>
+
+export module pl.core:error_trace;
+
+export namespace pl
+{
+// What an error went through after it was raised: the call stack at the point it was raised,
+// innermost frame first, and every PL_TRY that propagated it, in order.
+struct ErrorTrace
+{
+    static constexpr std::uint32_t maxFrames = 16;
+    static constexpr std::uint32_t maxSites  = 8;
+
+    void                 *frames[maxFrames];
+    std::uint32_t         numFrames;
+    std::source_location  sites[maxSites];
+    // May exceed maxSites, only the first maxSites sites are kept.
+    std::uint32_t         numSites;
+    // The record was reused by a later error before it was read, frames and sites are empty.
+    bool                  expired;
+};
+
+// Writes the frames symbolized with the dynamic symbol table, followed by the propagation sites.
+// Frames without an exported symbol are written as module+offset, for addr2line or llvm-symbolizer.
+std::ostream &operator<<(std::ostream &os, ErrorTrace const &trace);
+
+// Sets how many frames are captured when an error is raised, at most ErrorTrace::maxFrames.
+// 0 turns off stack capture, while propagation sites are still recorded.
+void setErrorTraceDepth(std::uint32_t depth) noexcept;
+} // export namespace pl
+
+namespace pl::error_trace_
+{
+struct Record;
+
+// Refers to a record in the ring of the thread that raised the error.
+// The sequence number tells whether the record still belongs to that error.
+struct Handle
+{
+    Record        *record;
+    std::uint32_t  sequence;
+};
+
+// Claims the next record of this thread's ring, and walks the frame pointers into it.
+// The ring is a zero-initialized thread_local, so this only costs a few stores per frame.
+[[nodiscard]] Handle capture() noexcept;
+
+// Only the thread that raised the error records sites, propagation on other threads is ignored.
+void notePropagation(Handle handle, std::source_location site) noexcept;
+
+// May be called from any thread, as long as the thread that raised the error is alive.
+void read(Handle handle, ErrorTrace &trace) noexcept;
+} // namespace pl::error_trace_
@@ -1,4 +1,5 @@
 module;
+#include <concepts>
 #include <type_traits>
 #include <utility>
 
@@ -15,11 +16,19 @@ concept deleter = requires (T del, Deleted obj)
     { del(obj) };
 };
 
-// TODO
+// Uniquely owns a handle, and releases it through D on destruction.
+// A moved-from or released UHandle owns nothing.
 template<class T, deleter<T> D>
 class UHandle
 {
 public:
+    [[nodiscard]]
+    constexpr UHandle()
+    noexcept(std::is_nothrow_default_constructible_v<D>)
+    requires std::default_initializable<D>
+    : _handle(), _deleter()
+    {}
+
     [[nodiscard]]
     explicit constexpr UHandle(T &&handle, D &&deleter = D())
     noexcept(
@@ -33,10 +42,19 @@ public:
         _deleter(std::move(deleter))
     {}
 
-    // TODO
     template<class U, class E>
     [[nodiscard]]
-    explicit constexpr UHandle(U &&u, E &&e);
+    explicit constexpr UHandle(U &&u, E &&e)
+    noexcept(
+        std::is_nothrow_constructible_v<T, U>
+     && std::is_nothrow_constructible_v<D, E>)
+    requires(
+        std::is_constructible_v<T, U>
+     && std::is_constructible_v<D, E>)
+    :
+        _handle(std::forward<U>(u)),
+        _deleter(std::forward<E>(e))
+    {}
 
     [[nodiscard]]
     explicit(
@@ -59,7 +77,17 @@ public:
     explicit(
         !std::is_convertible_v<U, T>
      || !std::is_convertible_v<E, D>)
-    constexpr UHandle(UHandle<U, E> &&other);
+    constexpr UHandle(UHandle<U, E> &&other)
+    noexcept(
+        std::is_nothrow_constructible_v<T, U>
+     && std::is_nothrow_constructible_v<D, E>)
+    requires(
+        std::is_constructible_v<T, U>
+     && std::is_constructible_v<D, E>)
+    :
+        _handle(std::exchange(other._handle, {})),
+        _deleter(std::move(other._deleter))
+    {}
 
     constexpr UHandle &operator=(UHandle &&other)
     noexcept(
@@ -67,6 +95,7 @@ public:
      && std::is_nothrow_move_assignable_v<T>
      && std::is_nothrow_move_assignable_v<D>)
     {
+        if (this == &other) return *this;
         if (_handle) _deleter(*_handle);
 
         _handle = std::exchange(other._handle, {});
@@ -88,6 +117,33 @@ public:
     {
         return *std::move(_handle);
     }
+
+    [[nodiscard]] explicit constexpr operator bool() const noexcept
+    {
+        return _handle.has_value();
+    }
+
+    [[nodiscard]] constexpr T const &get() const noexcept
+    {
+        return *_handle;
+    }
+
+    [[nodiscard]] constexpr D const &get_deleter() const noexcept
+    {
+        return _deleter;
+    }
+
+    // Gives up ownership without releasing the handle.
+    [[nodiscard]] constexpr Opt<T> release() noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        return std::exchange(_handle, {});
+    }
+
+    // Releases the owned handle, if any.
+    constexpr void reset() noexcept
+    {
+        if (_handle) _deleter(*std::exchange(_handle, {}));
+    }
 private:
     template<class U, deleter<U> E>
     friend class UHandle;
@@ -0,0 +1,123 @@
+module;
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+export module pl.core:hash;
+
+namespace pl::hash_
+{
+constexpr std::uint64_t k0 = 0xa0761d6478bd642full;
+constexpr std::uint64_t k1 = 0xe7037ed1a0b428dbull;
+constexpr std::uint64_t k2 = 0x8ebc6af09c88c6e3ull;
+
+// Loads size bytes, at most 8, as a little-endian integer, so that hashes are the same
+// whether they are computed at compile time or at runtime, and on every platform.
+[[nodiscard]]
+constexpr std::uint64_t load(char const *p, std::size_t size) noexcept
+{
+    if !consteval
+    {
+        if (size == 8)
+        {
+            std::uint64_t value;
+            std::memcpy(&value, p, 8);
+            if constexpr (std::endian::native == std::endian::big)
+                value = std::byteswap(value);
+            return value;
+        }
+    }
+
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < size; ++i)
+        value |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+    return value;
+}
+} // namespace pl::hash_
+
+export namespace pl
+{
+// Multiplies a and b into 128 bits, and folds the halves together.
+// Every bit of the result depends on every bit of both inputs.
+[[nodiscard]]
+constexpr std::uint64_t hashMix(std::uint64_t a, std::uint64_t b) noexcept
+{
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+}
+
+// Fast non-cryptographic hash of a byte string, in the style of wyhash.
+// Gives the same result at compile time and at runtime.
+[[nodiscard]]
+constexpr std::uint64_t hashBytes(char const *data, std::size_t size, std::uint64_t seed = 0) noexcept
+{
+    using namespace hash_;
+
+    std::uint64_t h = seed ^ k0;
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+        h = hashMix(load(data + i, 8) ^ k1, load(data + i + 8, 8) ^ h);
+
+    std::size_t rest = size - i;
+    std::uint64_t a = rest >= 8 ? load(data + i, 8)             : load(data + i, rest);
+    std::uint64_t b = rest >= 8 ? load(data + i + 8, rest - 8) : 0;
+    return hashMix(a ^ k1 ^ size, b ^ h ^ k2);
+}
+
+// Hash functor used by HashMap and HashSet.
+// Specializations are transparent wherever a type has cheaper views,
+// e.g. Hash<std::string> also hashes std::string_view and char const *, with the same result.
+template<class T>
+struct Hash;
+
+template<class T>
+requires std::integral<T> || std::is_enum_v<T>
+struct Hash<T>
+{
+    [[nodiscard]]
+    static constexpr std::uint64_t operator()(T value) noexcept
+    {
+        return hashMix(static_cast<std::uint64_t>(value) ^ hash_::k0, hash_::k1);
+    }
+};
+
+template<class T>
+struct Hash<T *>
+{
+    [[nodiscard]]
+    static std::uint64_t operator()(T const *value) noexcept
+    {
+        return hashMix(std::bit_cast<std::uintptr_t>(value) ^ hash_::k0, hash_::k1);
+    }
+};
+
+struct StringHash
+{
+    using is_transparent = void;
+
+    [[nodiscard]]
+    static constexpr std::uint64_t operator()(std::string_view s) noexcept
+    {
+        return hashBytes(s.data(), s.size());
+    }
+};
+
+template<>
+struct Hash<std::string_view> : StringHash {};
+
+template<>
+struct Hash<std::string> : StringHash {};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(hashBytes("", 0) != hashBytes("a", 1));
+static_assert(hashBytes("0123456789abcdef", 16) != hashBytes("0123456789abcdeF", 16));
+static_assert(Hash<std::string_view>()("VK_KHR_swapchain") == StringHash()("VK_KHR_swapchain"));
+static_assert(Hash<int>()(1) != Hash<int>()(2));
+} // namespace pl
@@ -0,0 +1,645 @@
+module;
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <pl/macro.hpp>
+
+export module pl.core:hash_map;
+
+import :error;
+import :hash;
+import :memory;
+import :null;
+import :optional;
+import :result_error;
+import :span;
+
+namespace pl::hash_map_
+{
+// Every slot has a control byte, which is either ctrlEmpty, ctrlDeleted, or the low 7 bits of the hash
+// of the key in the slot. Only full slots have their sign bit clear.
+using ctrl_t = std::int8_t;
+
+constexpr ctrl_t ctrlEmpty   = -128;
+constexpr ctrl_t ctrlDeleted = -2;
+
+// Slots are probed a group at a time, and groups are aligned,
+// so a group never wraps around the end of the table.
+constexpr std::size_t groupWidth = 16;
+
+// Bit i of a mask is set if slot i of the group matches.
+using GroupMask = std::uint32_t;
+
+class Group
+{
+public:
+    [[nodiscard]] explicit constexpr Group(ctrl_t const *ctrl) noexcept : _ctrl(ctrl) {}
+
+    [[nodiscard]] constexpr GroupMask match(ctrl_t h2) const noexcept
+    {
+        if !consteval
+        {
+#if defined(__SSE2__)
+            return GroupMask(_mm_movemask_epi8(_mm_cmpeq_epi8(load(), _mm_set1_epi8(h2))));
+#endif
+        }
+
+        GroupMask mask = 0;
+        for (std::size_t i = 0; i < groupWidth; ++i)
+            mask |= GroupMask(_ctrl[i] == h2) << i;
+        return mask;
+    }
+
+    [[nodiscard]] constexpr GroupMask matchEmpty() const noexcept
+    {
+        return match(ctrlEmpty);
+    }
+
+    [[nodiscard]] constexpr GroupMask matchEmptyOrDeleted() const noexcept
+    {
+        if !consteval
+        {
+#if defined(__SSE2__)
+            return GroupMask(_mm_movemask_epi8(load()));
+#endif
+        }
+
+        GroupMask mask = 0;
+        for (std::size_t i = 0; i < groupWidth; ++i)
+            mask |= GroupMask(_ctrl[i] < 0) << i;
+        return mask;
+    }
+
+private:
+#if defined(__SSE2__)
+    [[nodiscard]] __m128i load() const noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const *>(_ctrl));
+    }
+#endif
+
+    ctrl_t const *_ctrl;
+};
+
+// Up to 7/8 of the slots are filled before the table grows,
+// which keeps probe sequences short and guarantees that every probe sequence ends at an empty slot.
+[[nodiscard]]
+constexpr std::size_t maxLoadOf(std::size_t capacity) noexcept
+{
+    return capacity - capacity / 8;
+}
+
+template<class T>
+concept transparent = requires { typename T::is_transparent; };
+
+// Lookups take either a key_type, or anything that both the hasher and key_equal accept if both are transparent.
+template<class K, class Table>
+concept lookup_key =
+    (std::is_same_v<K, typename Table::key_type>
+  || (transparent<typename Table::hasher> && transparent<typename Table::key_equal>))
+ && !std::is_convertible_v<K const &, typename Table::const_iterator>;
+
+template<class Policy, class H, class Eq, allocator A>
+class RawTable;
+
+template<class Slot, bool Const>
+class Iterator
+{
+public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = Slot;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::conditional_t<Const, Slot const &, Slot &>;
+    using pointer           = std::conditional_t<Const, Slot const *, Slot *>;
+
+    [[nodiscard]] Iterator() = default;
+
+    [[nodiscard]] constexpr Iterator(ctrl_t const *ctrl, ctrl_t const *end, pointer slot) noexcept
+    : _ctrl(ctrl), _end(end), _slot(slot)
+    {
+        skipEmpty();
+    }
+
+    template<bool C = Const>
+    requires C
+    [[nodiscard]] constexpr Iterator(Iterator<Slot, false> const &other) noexcept
+    : _ctrl(other._ctrl), _end(other._end), _slot(other._slot) {}
+
+    [[nodiscard]] constexpr reference operator*()  const noexcept { return *_slot; }
+    [[nodiscard]] constexpr pointer   operator->() const noexcept { return  _slot; }
+
+    constexpr Iterator &operator++() noexcept
+    {
+        ++_ctrl;
+        ++_slot;
+        skipEmpty();
+        return *this;
+    }
+
+    constexpr Iterator operator++(int) noexcept
+    {
+        Iterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    [[nodiscard]] constexpr bool operator==(Iterator const &other) const noexcept
+    {
+        return _slot == other._slot;
+    }
+
+private:
+    template<class, bool>
+    friend class Iterator;
+
+    template<class, class, class, allocator>
+    friend class RawTable;
+
+    constexpr void skipEmpty() noexcept
+    {
+        while (_ctrl != _end && *_ctrl < 0)
+        {
+            ++_ctrl;
+            ++_slot;
+        }
+    }
+
+    ctrl_t const *_ctrl = {};
+    ctrl_t const *_end  = {};
+    pointer       _slot = {};
+};
+
+// Open-addressing hash table in the style of Swiss tables, shared by HashMap and HashSet.
+// Policy tells how to get the key of a slot.
+//
+// Lookups compare the 7 hash bits stored in the control bytes of a whole group of slots at once,
+// with SSE2 when available, and only compare keys of slots whose bits match.
+// Erased slots become tombstones unless their group still has an empty slot,
+// and tombstones are dropped whenever the table is rehashed.
+template<class Policy, class H, class Eq, allocator A>
+class RawTable
+{
+public:
+    using key_type        = Policy::key_type;
+    using value_type      = Policy::slot_type;
+    using hasher          = H;
+    using key_equal       = Eq;
+    using allocator_type  = A;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = value_type       &;
+    using const_reference = value_type const &;
+    using iterator        = Iterator<value_type, false>;
+    using const_iterator  = Iterator<value_type, true>;
+
+    [[nodiscard]] RawTable() = default;
+
+    [[nodiscard]] explicit constexpr RawTable(
+        allocator_type const &a,
+        hasher         const &hash  = {},
+        key_equal      const &equal = {})
+        noexcept
+    : _hash(hash), _equal(equal), _allocator(a) {}
+
+    [[nodiscard]] constexpr RawTable(RawTable &&other) noexcept
+    :
+        _ctrl      (std::exchange(other._ctrl,       {})),
+        _slots     (std::exchange(other._slots,      {})),
+        _size      (std::exchange(other._size,       0)),
+        _growthLeft(std::exchange(other._growthLeft, 0)),
+        _hash      (other._hash),
+        _equal     (other._equal),
+        _allocator (other._allocator)
+    {}
+
+    constexpr RawTable &operator=(RawTable &&other) noexcept
+    {
+        RawTable(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    constexpr ~RawTable()
+    {
+        destroyAll();
+        deallocate();
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return _allocator; }
+    [[nodiscard]] constexpr hasher         hash_function() const noexcept { return _hash;      }
+    [[nodiscard]] constexpr key_equal      key_eq()        const noexcept { return _equal;     }
+
+    [[nodiscard]] constexpr iterator       begin()        noexcept { return {_ctrl.data(), _ctrl.data() + _ctrl.size(), _slots.data()}; }
+    [[nodiscard]] constexpr const_iterator begin()  const noexcept { return {_ctrl.data(), _ctrl.data() + _ctrl.size(), _slots.data()}; }
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] constexpr iterator       end()          noexcept { return iteratorAt(capacity()); }
+    [[nodiscard]] constexpr const_iterator end()    const noexcept { return iteratorAt(capacity()); }
+    [[nodiscard]] constexpr const_iterator cend()   const noexcept { return end(); }
+
+    [[nodiscard]] constexpr bool      empty()    const noexcept { return _size == 0;     }
+    [[nodiscard]] constexpr size_type size()     const noexcept { return _size;          }
+    [[nodiscard]] constexpr size_type capacity() const noexcept { return _slots.size();  }
+
+    // Makes room for count elements in total, so that inserting them does not rehash.
+    [[nodiscard]] constexpr RE<void, SimpleError> reserve(size_type count) noexcept
+    {
+        if (count <= _size + _growthLeft) return {};
+        return rehash(capacityFor(count));
+    }
+
+    constexpr void clear() noexcept
+    {
+        destroyAll();
+        for (ctrl_t &c : _ctrl) c = ctrlEmpty;
+        _size = 0;
+        _growthLeft = maxLoadOf(capacity());
+    }
+
+    template<class K = key_type>
+    requires lookup_key<K, RawTable>
+    [[nodiscard]] constexpr iterator find(K const &key) noexcept
+    {
+        return iteratorAt(findIndex(key));
+    }
+
+    template<class K = key_type>
+    requires lookup_key<K, RawTable>
+    [[nodiscard]] constexpr const_iterator find(K const &key) const noexcept
+    {
+        return iteratorAt(findIndex(key));
+    }
+
+    template<class K = key_type>
+    requires lookup_key<K, RawTable>
+    [[nodiscard]] constexpr bool contains(K const &key) const noexcept
+    {
+        return findIndex(key) != npos;
+    }
+
+    template<class K = key_type>
+    requires lookup_key<K, RawTable>
+    constexpr size_type erase(K const &key) noexcept
+    {
+        size_type idx = findIndex(key);
+        if (idx == npos) return 0;
+        eraseAt(idx);
+        return 1;
+    }
+
+    constexpr void erase(const_iterator pos) noexcept
+    {
+        PL_ASSERT(pos != end());
+        eraseAt(size_type(pos._slot - _slots.data()));
+    }
+
+    constexpr void swap(RawTable &other) noexcept
+    {
+        using std::swap;
+        swap(_ctrl,       other._ctrl);
+        swap(_slots,      other._slots);
+        swap(_size,       other._size);
+        swap(_growthLeft, other._growthLeft);
+        swap(_hash,       other._hash);
+        swap(_equal,      other._equal);
+        swap(_allocator,  other._allocator);
+    }
+
+protected:
+    static constexpr size_type npos = size_type(-1);
+
+    [[nodiscard]] constexpr iterator iteratorAt(size_type idx) noexcept
+    {
+        if (idx == npos) idx = capacity();
+        return {_ctrl.data() + idx, _ctrl.data() + _ctrl.size(), _slots.data() + idx};
+    }
+
+    [[nodiscard]] constexpr const_iterator iteratorAt(size_type idx) const noexcept
+    {
+        if (idx == npos) idx = capacity();
+        return {_ctrl.data() + idx, _ctrl.data() + _ctrl.size(), _slots.data() + idx};
+    }
+
+    [[nodiscard]] constexpr value_type *slotAt(size_type idx) noexcept
+    {
+        return _slots.data() + idx;
+    }
+
+    // Finds the slot of key, or claims a free slot for it.
+    // The second member tells whether the slot was claimed, in which case the caller must construct it.
+    template<class K>
+    [[nodiscard]] constexpr RE<std::pair<size_type, bool>, SimpleError> findOrPrepareInsert(K const &key) noexcept
+    {
+        std::uint64_t hash = hashOf(key);
+        if (size_type idx = findIndex(key, hash); idx != npos)
+            return std::pair(idx, false);
+
+        size_type idx = capacity() == 0 ? npos : findFreeIndex(hash);
+        if (idx == npos || (_growthLeft == 0 && _ctrl[idx] == ctrlEmpty))
+        {
+            PL_TRY_DISCARD(rehash(grownCapacity()));
+            idx = findFreeIndex(hash);
+        }
+
+        if (_ctrl[idx] == ctrlEmpty) --_growthLeft;
+        _ctrl[idx] = h2Of(hash);
+        ++_size;
+        return std::pair(idx, true);
+    }
+
+private:
+    template<class K>
+    [[nodiscard]] constexpr std::uint64_t hashOf(K const &key) const noexcept
+    {
+        // Mixed again so that weak hashes, e.g. identity hashes of integers, still spread over every bit.
+        return hashMix(std::uint64_t(_hash(key)), 0x9e3779b97f4a7c15ull);
+    }
+
+    [[nodiscard]] static constexpr ctrl_t h2Of(std::uint64_t hash) noexcept
+    {
+        return ctrl_t(hash & 0x7f);
+    }
+
+    [[nodiscard]] constexpr size_type numGroups() const noexcept
+    {
+        return capacity() / groupWidth;
+    }
+
+    template<class K>
+    [[nodiscard]] constexpr size_type findIndex(K const &key) const noexcept
+    {
+        return findIndex(key, hashOf(key));
+    }
+
+    // Probes groups in triangular order, which visits every group once as the number of groups is a power of two.
+    template<class K>
+    [[nodiscard]] constexpr size_type findIndex(K const &key, std::uint64_t hash) const noexcept
+    {
+        if (capacity() == 0) return npos;
+
+        size_type mask  = numGroups() - 1;
+        size_type group = (hash >> 7) & mask;
+        for (size_type step = 1;; ++step)
+        {
+            Group g(_ctrl.data() + group * groupWidth);
+            for (GroupMask m = g.match(h2Of(hash)); m; m &= m - 1)
+            {
+                size_type idx = group * groupWidth + size_type(std::countr_zero(m));
+                if (_equal(Policy::key(_slots[idx]), key)) return idx;
+            }
+            if (g.matchEmpty()) return npos;
+            group = (group + step) & mask;
+        }
+    }
+
+    [[nodiscard]] constexpr size_type findFreeIndex(std::uint64_t hash) const noexcept
+    {
+        size_type mask  = numGroups() - 1;
+        size_type group = (hash >> 7) & mask;
+        for (size_type step = 1;; ++step)
+        {
+            if (GroupMask m = Group(_ctrl.data() + group * groupWidth).matchEmptyOrDeleted(); m)
+                return group * groupWidth + size_type(std::countr_zero(m));
+            group = (group + step) & mask;
+        }
+    }
+
+    constexpr void eraseAt(size_type idx) noexcept
+    {
+        std::destroy_at(&_slots[idx]);
+        --_size;
+
+        // A probe sequence that reaches a group with an empty slot ends there,
+        // so the slot can be freed outright, rather than leaving a tombstone.
+        if (Group(_ctrl.data() + idx / groupWidth * groupWidth).matchEmpty())
+        {
+            _ctrl[idx] = ctrlEmpty;
+            ++_growthLeft;
+        }
+        else
+        {
+            _ctrl[idx] = ctrlDeleted;
+        }
+    }
+
+    [[nodiscard]] static constexpr size_type capacityFor(size_type count) noexcept
+    {
+        size_type capacity = groupWidth;
+        while (maxLoadOf(capacity) < count) capacity *= 2;
+        return capacity;
+    }
+
+    // Rehashing in place is enough when most of the used up capacity is tombstones.
+    [[nodiscard]] constexpr size_type grownCapacity() const noexcept
+    {
+        if (capacity() != 0 && _size < maxLoadOf(capacity()) / 2)
+            return capacity();
+        return capacityFor(_size + 1);
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> rehash(size_type newCapacity) noexcept
+    {
+        PL_TRY_ASSIGN(Span<ctrl_t> newCtrl, alloc<ctrl_t>(_allocator, newCapacity));
+        RE<Span<value_type>, SimpleError> newSlots = alloc<value_type>(_allocator, newCapacity);
+        if (!newSlots)
+        {
+            free(_allocator, newCtrl);
+            return {tags::error, std::move(newSlots).error()};
+        }
+        for (ctrl_t &c : newCtrl) std::construct_at(&c, ctrlEmpty);
+
+        Span<ctrl_t>     oldCtrl  = std::exchange(_ctrl,  newCtrl);
+        Span<value_type> oldSlots = std::exchange(_slots, *newSlots);
+        for (size_type i = 0; i < oldCtrl.size(); ++i)
+        {
+            if (oldCtrl[i] < 0) continue;
+
+            std::uint64_t hash = hashOf(Policy::key(oldSlots[i]));
+            size_type idx = findFreeIndex(hash);
+            _ctrl[idx] = h2Of(hash);
+            std::construct_at(&_slots[idx], std::move(oldSlots[i]));
+            std::destroy_at(&oldSlots[i]);
+        }
+        _growthLeft = maxLoadOf(newCapacity) - _size;
+
+        if (!oldCtrl.empty())
+        {
+            free(_allocator, oldCtrl);
+            free(_allocator, oldSlots);
+        }
+        return {};
+    }
+
+    constexpr void destroyAll() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        {
+            for (size_type i = 0; i < _ctrl.size(); ++i)
+                if (_ctrl[i] >= 0) std::destroy_at(&_slots[i]);
+        }
+    }
+
+    constexpr void deallocate() noexcept
+    {
+        if (_ctrl.empty()) return;
+        free(_allocator, _ctrl);
+        free(_allocator, _slots);
+        _ctrl  = {};
+        _slots = {};
+    }
+
+    Span<ctrl_t>            _ctrl;
+    Span<value_type>        _slots;
+    size_type               _size       = 0;
+    size_type               _growthLeft = 0;
+    [[no_unique_address]] H  _hash      = {};
+    [[no_unique_address]] Eq _equal     = {};
+    [[no_unique_address]] A  _allocator = {};
+};
+
+template<class K, class V>
+struct MapPolicy
+{
+    using key_type  = K;
+    using slot_type = std::pair<K, V>;
+
+    [[nodiscard]] static constexpr K const &key(slot_type const &slot) noexcept { return slot.first; }
+};
+
+template<class K>
+struct SetPolicy
+{
+    using key_type  = K;
+    using slot_type = K;
+
+    [[nodiscard]] static constexpr K const &key(slot_type const &slot) noexcept { return slot; }
+};
+} // namespace pl::hash_map_
+
+export namespace pl
+{
+// Flat hash map, storing its elements inline in an open-addressing table.
+// See hash_map_::RawTable for the layout.
+//
+// Elements are std::pair<K, V>, and their keys must not be modified through iterators.
+// Insertions rehash once the table is 7/8 full, which moves every element and invalidates every iterator.
+// Lookups accept any type that both H and Eq accept, if both are transparent.
+template<
+    class       K,
+    class       V,
+    class       H  = Hash<K>,
+    class       Eq = std::equal_to<>,
+    allocator   A  = default_allocator_t<std::pair<K, V>>>
+class HashMap : public hash_map_::RawTable<hash_map_::MapPolicy<K, V>, H, Eq, A>
+{
+private:
+    using Base = hash_map_::RawTable<hash_map_::MapPolicy<K, V>, H, Eq, A>;
+
+public:
+    using typename Base::key_type;
+    using typename Base::value_type;
+    using typename Base::size_type;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using mapped_type = V;
+
+    using Base::Base;
+
+    // Inserts V(args...) under key, unless key is already present.
+    template<class KK, class ...Args>
+    requires std::is_constructible_v<K, KK> && std::is_constructible_v<V, Args...>
+    [[nodiscard]] constexpr RE<std::pair<iterator, bool>, SimpleError> try_emplace(KK &&key, Args &&...args) noexcept
+    {
+        PL_TRY_ASSIGN(auto found, this->findOrPrepareInsert(key));
+        auto [idx, inserted] = found;
+        if (inserted)
+        {
+            std::construct_at(this->slotAt(idx),
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<KK>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        return std::pair(this->iteratorAt(idx), inserted);
+    }
+
+    [[nodiscard]] constexpr RE<std::pair<iterator, bool>, SimpleError> insert(value_type const &value) noexcept
+    requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    [[nodiscard]] constexpr RE<std::pair<iterator, bool>, SimpleError> insert(value_type &&value) noexcept
+    {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template<class KK, class VV>
+    requires std::is_constructible_v<K, KK> && std::is_assignable_v<V &, VV>
+    [[nodiscard]] constexpr RE<std::pair<iterator, bool>, SimpleError> insert_or_assign(KK &&key, VV &&value) noexcept
+    {
+        PL_TRY_ASSIGN(auto result, try_emplace(std::forward<KK>(key), std::forward<VV>(value)));
+        if (!result.second) result.first->second = std::forward<VV>(value);
+        return result;
+    }
+
+    template<class KK = K>
+    requires hash_map_::lookup_key<KK, Base>
+    [[nodiscard]] constexpr Opt<Ptr<V>> get(KK const &key) noexcept
+    {
+        if (iterator it = this->find(key); it != this->end())
+            return makeNonNull_Unchecked(&it->second);
+        return {};
+    }
+
+    template<class KK = K>
+    requires hash_map_::lookup_key<KK, Base>
+    [[nodiscard]] constexpr Opt<Ptr<V const>> get(KK const &key) const noexcept
+    {
+        if (const_iterator it = this->find(key); it != this->end())
+            return makeNonNull_Unchecked(&it->second);
+        return {};
+    }
+};
+
+// Flat hash set, the key-only counterpart of HashMap.
+template<
+    class       K,
+    class       H  = Hash<K>,
+    class       Eq = std::equal_to<>,
+    allocator   A  = default_allocator_t<K>>
+class HashSet : public hash_map_::RawTable<hash_map_::SetPolicy<K>, H, Eq, A>
+{
+private:
+    using Base = hash_map_::RawTable<hash_map_::SetPolicy<K>, H, Eq, A>;
+
+public:
+    using typename Base::key_type;
+    using typename Base::value_type;
+    using typename Base::size_type;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+
+    using Base::Base;
+
+    // Inserts K(key), unless an equal key is already present.
+    template<class KK>
+    requires std::is_constructible_v<K, KK>
+    [[nodiscard]] constexpr RE<std::pair<iterator, bool>, SimpleError> insert(KK &&key) noexcept
+    {
+        PL_TRY_ASSIGN(auto found, this->findOrPrepareInsert(key));
+        auto [idx, inserted] = found;
+        if (inserted) std::construct_at(this->slotAt(idx), std::forward<KK>(key));
+        return std::pair(this->iteratorAt(idx), inserted);
+    }
+};
+} // export namespace pl
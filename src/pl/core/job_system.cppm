@@ -0,0 +1,500 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:job_system;
+
+import :concurrent_queue;
+import :error;
+import :memory;
+import :null;
+import :optional;
+import :result_error;
+import :span;
+import :thread_caching_allocator;
+
+export namespace pl
+{
+class JobSystem;
+
+// Tracks a group of jobs, and the first error any of them returned.
+// A job submitted after another counter only runs once that counter is done,
+// and fails with that counter's error instead of running if any of its jobs failed.
+class JobCounter
+{
+public:
+    [[nodiscard]] JobCounter() = default;
+
+    JobCounter           (JobCounter const &) = delete;
+    JobCounter &operator=(JobCounter const &) = delete;
+
+    ~JobCounter()
+    {
+        assert(done() && "every job must finish before its counter is destroyed");
+    }
+
+    [[nodiscard]] bool done() const noexcept
+    {
+        return _pending.load(std::memory_order_acquire) == 0;
+    }
+
+    // Lets long running jobs stop early once another job of the group has failed.
+    [[nodiscard]] bool failed() const noexcept
+    {
+        return _failed.test(std::memory_order_relaxed);
+    }
+
+private:
+    friend class JobSystem;
+
+    void add() noexcept
+    {
+        _pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void finish(RE<void, SimpleError> &&result) noexcept
+    {
+        // Only the first failure is kept, and it is published by the release below.
+        if (!result && !_failed.test_and_set(std::memory_order_relaxed))
+            _error = std::move(result).error();
+        _pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // Only valid once done().
+    [[nodiscard]] RE<void, SimpleError> result() const noexcept
+    {
+        if (_error) return {tags::error, *_error};
+        return {};
+    }
+
+    void reset() noexcept
+    {
+        _error = tags::nullopt;
+        _failed.clear(std::memory_order_relaxed);
+    }
+
+    std::atomic<std::size_t> _pending = 0;
+    std::atomic_flag         _failed;
+    Opt<SimpleError>         _error;
+};
+} // export namespace pl
+
+namespace pl::job_system_
+{
+template<class F, class ...Args>
+concept job_function =
+    std::is_invocable_v<F &, Args...>
+ && (std::is_void_v<std::invoke_result_t<F &, Args...>>
+  || std::is_same_v<std::invoke_result_t<F &, Args...>, RE<void, SimpleError>>);
+
+template<class F, class ...Args>
+requires job_function<F, Args...>
+RE<void, SimpleError> invoke(F &f, Args &&...args) noexcept
+{
+    if constexpr (std::is_void_v<std::invoke_result_t<F &, Args...>>)
+    {
+        std::invoke(f, std::forward<Args>(args)...);
+        return {};
+    }
+    else
+    {
+        return std::invoke(f, std::forward<Args>(args)...);
+    }
+}
+
+// A job owns its callable, which is stored inline so that a job is a single allocation.
+// Jobs are allocated from ThreadCachingAllocator, as they are usually freed by another thread.
+struct Job
+{
+    static constexpr std::size_t size = 128;
+    static constexpr std::size_t inlineSize = size - 4 * sizeof(void *);
+
+    // Runs, then destroys the callable.
+    RE<void, SimpleError> (*run)(Job &) noexcept;
+    // Destroys the callable without running it.
+    void (*discard)(Job &) noexcept;
+    JobCounter       *counter;
+    JobCounter const *dependency;
+    alignas(std::max_align_t) std::byte callable[inlineSize];
+};
+
+static_assert(sizeof(Job) == Job::size);
+
+template<class F>
+concept inline_job_function =
+    sizeof(F) <= Job::inlineSize
+ && alignof(F) <= alignof(std::max_align_t)
+ && std::is_nothrow_move_constructible_v<F>;
+
+// Chase-Lev work-stealing deque, after "Correct and Efficient Work-Stealing for Weak Memory Models".
+// The owner pushes and pops at the bottom, thieves steal from the top.
+// The buffer does not grow; a full deque makes the owner run the job inline instead.
+class WorkStealingDeque
+{
+public:
+    static constexpr std::int64_t capacity = 4096;
+
+    // Owner only.
+    [[nodiscard]] bool push(Job *job) noexcept
+    {
+        std::int64_t b = _bottom.load(std::memory_order_relaxed);
+        std::int64_t t = _top.load(std::memory_order_acquire);
+        if (b - t >= capacity) return false;
+
+        _jobs[b & (capacity - 1)].store(job, std::memory_order_relaxed);
+        // A release store publishes the job like the paper's release fence does, and ThreadSanitizer understands it.
+        _bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only.
+    [[nodiscard]] Job *pop() noexcept
+    {
+        std::int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = _top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job *job = _jobs[b & (capacity - 1)].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // Last job, race against thieves for it.
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Any thread.
+    [[nodiscard]] Job *steal() noexcept
+    {
+        std::int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        Job *job = _jobs[t & (capacity - 1)].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+private:
+    alignas(cacheLineSize) std::atomic<std::int64_t> _top    = 0;
+    alignas(cacheLineSize) std::atomic<std::int64_t> _bottom = 0;
+    alignas(cacheLineSize) std::atomic<Job *>        _jobs[capacity] = {};
+};
+
+struct alignas(cacheLineSize) Worker
+{
+    WorkStealingDeque deque;
+    std::thread       thread;
+    std::uint32_t     rng = 0;
+};
+
+struct CurrentWorker
+{
+    JobSystem const *system;
+    Worker          *worker;
+};
+
+constinit inline thread_local CurrentWorker currentWorker = {};
+} // namespace pl::job_system_
+
+export namespace pl
+{
+// Fixed pool of worker threads that share jobs through work stealing.
+//
+// Every worker owns a deque of jobs. Jobs submitted from a worker go to the bottom of its own deque,
+// and run in LIFO order for cache locality, while idle workers steal from the top of other deques.
+// Jobs submitted from threads outside the pool go through a shared injection queue instead.
+//
+// The thread calling init becomes worker 0, and only runs jobs while it waits on a counter.
+// Waiting never blocks a worker: it keeps running other jobs until the counter is done.
+// Idle background workers sleep until new jobs are submitted.
+class JobSystem
+{
+public:
+    using size_type = std::size_t;
+
+    [[nodiscard]] JobSystem() = default;
+
+    JobSystem           (JobSystem const &) = delete;
+    JobSystem &operator=(JobSystem const &) = delete;
+
+    ~JobSystem()
+    {
+        deinit();
+    }
+
+    // Starts numThreads - 1 background workers, the calling thread being the last one.
+    // Defaults to one worker per hardware thread.
+    [[nodiscard]] RE<void, SimpleError> init(size_type numThreads = std::thread::hardware_concurrency()) noexcept
+    {
+        assert(_workers.empty() && "JobSystem is already initialized");
+        numThreads = std::max<size_type>(numThreads, 1);
+
+        PL_TRY_DISCARD(_injected.init(1024));
+        PL_TRY_ASSIGN(_workers, new_<job_system_::Worker>[numThreads](AlignedAllocator()));
+
+        _stopping.store(false, std::memory_order_relaxed);
+        for (size_type i = 0; i < numThreads; ++i)
+            _workers[i].rng = std::uint32_t(i * 2654435761u + 1);
+
+        job_system_::currentWorker = {this, &_workers[0]};
+        for (size_type i = 1; i < numThreads; ++i)
+            _workers[i].thread = std::thread([this, i] { workerMain(_workers[i]); });
+        return {};
+    }
+
+    // Stops and joins every background worker. Every counter must be done.
+    void deinit() noexcept
+    {
+        if (_workers.empty()) return;
+
+        _stopping.store(true, std::memory_order_relaxed);
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+        _epoch.notify_all();
+        for (size_type i = 1; i < _workers.size(); ++i)
+            _workers[i].thread.join();
+
+        if (job_system_::currentWorker.system == this)
+            job_system_::currentWorker = {};
+
+        delete_(AlignedAllocator(), _workers);
+        _workers = {};
+    }
+
+    [[nodiscard]] size_type numWorkers() const noexcept
+    {
+        return _workers.size();
+    }
+
+    // Schedules f to run on any worker, and tracks it with counter.
+    // f returns either void or RE<void, SimpleError>.
+    // Fails only if the job cannot be allocated, in which case f is not run and counter is untouched.
+    template<class F>
+    requires job_system_::job_function<std::decay_t<F>>
+    [[nodiscard]] RE<void, SimpleError> submit(JobCounter &counter, F &&f) noexcept
+    {
+        return schedule(nullptr, counter, std::forward<F>(f));
+    }
+
+    // Like submit, but f only runs once dependency is done, and not at all if any job of dependency failed.
+    // dependency must not be waited on, which resets it, before counter is done.
+    template<class F>
+    requires job_system_::job_function<std::decay_t<F>>
+    [[nodiscard]] RE<void, SimpleError> submit(JobCounter const &dependency, JobCounter &counter, F &&f) noexcept
+    {
+        return schedule(&dependency, counter, std::forward<F>(f));
+    }
+
+    // Runs other jobs until every job tracked by counter has finished,
+    // then returns the first error any of them returned, and resets the counter for reuse.
+    [[nodiscard]] RE<void, SimpleError> wait(JobCounter &counter) noexcept
+    {
+        waitUntilDone(counter);
+        RE<void, SimpleError> result = counter.result();
+        counter.reset();
+        return result;
+    }
+
+    // Calls f on every element of span, split into chunks of grainSize elements that run in parallel.
+    // A grainSize of 0 picks one that gives every worker a few chunks to balance the load.
+    // f returns either void or RE<void, SimpleError>. Once an element fails,
+    // chunks that have not started yet are skipped, and the first error is returned.
+    template<class T, class F>
+    requires job_system_::job_function<F, T &>
+    [[nodiscard]] RE<void, SimpleError> parallel_for(Span<T> span, F &&f, size_type grainSize = 0) noexcept
+    {
+        if (span.empty()) return {};
+        if (grainSize == 0)
+            grainSize = std::max<size_type>(1, (span.size() + 4 * numWorkers() - 1) / (4 * numWorkers()));
+
+        JobCounter counter;
+        for (size_type first = 0; first < span.size(); first += grainSize)
+        {
+            Span<T> chunk(span.data() + first, std::min(grainSize, span.size() - first));
+            RE<void, SimpleError> submitted = submit(counter, [chunk, &f, &counter] -> RE<void, SimpleError>
+            {
+                for (T &element : chunk)
+                {
+                    if (counter.failed()) break;
+                    PL_TRY_DISCARD(job_system_::invoke(f, element));
+                }
+                return {};
+            });
+
+            if (!submitted)
+            {
+                waitUntilDone(counter);
+                counter.reset();
+                return submitted;
+            }
+        }
+        return wait(counter);
+    }
+
+private:
+    using Job = job_system_::Job;
+
+    template<class F>
+    [[nodiscard]] RE<void, SimpleError> schedule(JobCounter const *dependency, JobCounter &counter, F &&f) noexcept
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(job_system_::inline_job_function<Fn>,
+            "Job functions must fit in Job::inlineSize bytes, capture by reference if they are larger");
+
+        PL_TRY_ASSIGN(Job *job, new_<Job>(ThreadCachingAllocator()));
+        job->run = [](Job &job) noexcept -> RE<void, SimpleError>
+        {
+            Fn *fn = std::launder(reinterpret_cast<Fn *>(job.callable));
+            RE<void, SimpleError> result = job_system_::invoke(*fn);
+            std::destroy_at(fn);
+            return result;
+        };
+        job->discard = [](Job &job) noexcept
+        {
+            std::destroy_at(std::launder(reinterpret_cast<Fn *>(job.callable)));
+        };
+        job->counter    = &counter;
+        job->dependency = dependency;
+        std::construct_at(reinterpret_cast<Fn *>(job->callable), std::forward<F>(f));
+
+        counter.add();
+        enqueue(job);
+        return {};
+    }
+
+    void enqueue(Job *job) noexcept
+    {
+        job_system_::CurrentWorker current = job_system_::currentWorker;
+        bool queued =
+            current.system == this
+                ? current.worker->deque.push(job)
+                : bool(_injected.try_push(job));
+        if (!queued)
+        {
+            execute(job);
+            return;
+        }
+
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (_numSleeping.load(std::memory_order_seq_cst) != 0)
+            _epoch.notify_one();
+    }
+
+    void execute(Job *job) noexcept
+    {
+        RE<void, SimpleError> result = {};
+        if (job->dependency)
+        {
+            waitUntilDone(*job->dependency);
+            result = job->dependency->result();
+        }
+
+        if (result)
+            result = job->run(*job);
+        else
+            job->discard(*job);
+
+        JobCounter *counter = job->counter;
+        delete_(ThreadCachingAllocator(), makeNonNull_Unchecked(job));
+        counter->finish(std::move(result));
+    }
+
+    [[nodiscard]] Job *findJob(job_system_::Worker *self) noexcept
+    {
+        if (self)
+        {
+            if (Job *job = self->deque.pop()) return job;
+        }
+
+        if (Opt<Job *> job = _injected.try_pop()) return *job;
+
+        // Steal from a random victim first, so that thieves spread out.
+        size_type n = _workers.size();
+        size_type start = 0;
+        if (self)
+        {
+            self->rng ^= self->rng << 13;
+            self->rng ^= self->rng >> 17;
+            self->rng ^= self->rng << 5;
+            start = self->rng % n;
+        }
+        for (size_type i = 0; i < n; ++i)
+        {
+            job_system_::Worker &victim = _workers[(start + i) % n];
+            if (&victim == self) continue;
+            if (Job *job = victim.deque.steal()) return job;
+        }
+        return nullptr;
+    }
+
+    void waitUntilDone(JobCounter const &counter) noexcept
+    {
+        job_system_::CurrentWorker current = job_system_::currentWorker;
+        job_system_::Worker *self = current.system == this ? current.worker : nullptr;
+        while (!counter.done())
+        {
+            if (Job *job = findJob(self))
+                execute(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void workerMain(job_system_::Worker &self) noexcept
+    {
+        job_system_::currentWorker = {this, &self};
+        while (!_stopping.load(std::memory_order_relaxed))
+        {
+            if (Job *job = findJob(&self))
+            {
+                execute(job);
+                continue;
+            }
+
+            // Re-check for jobs after announcing that we are about to sleep,
+            // so that a job submitted in between either is found or wakes us up.
+            _numSleeping.fetch_add(1, std::memory_order_seq_cst);
+            std::uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+            if (Job *job = findJob(&self))
+            {
+                _numSleeping.fetch_sub(1, std::memory_order_relaxed);
+                execute(job);
+                continue;
+            }
+            if (!_stopping.load(std::memory_order_relaxed))
+                _epoch.wait(epoch, std::memory_order_seq_cst);
+            _numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+        job_system_::currentWorker = {};
+    }
+
+    Span<job_system_::Worker> _workers;
+    MPMCQueue<Job *>          _injected;
+
+    alignas(cacheLineSize) std::atomic<std::uint64_t> _epoch       = 0;
+    alignas(cacheLineSize) std::atomic<std::uint32_t> _numSleeping = 0;
+    std::atomic<bool>                                 _stopping    = false;
+};
+} // export namespace pl
@@ -1,7 +1,9 @@
 module;
+#include <algorithm>
 #include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -9,6 +11,10 @@ module;
 #include <type_traits>
 #include <utility>
 
+#if defined(__linux__)
+#   include <sys/mman.h>
+#endif
+
 #include <pl/macro.hpp>
 
 export module pl.core:memory;
@@ -108,6 +114,18 @@ constexpr bool isValidAlignment(std::size_t alignment) noexcept
     return (alignment != 0) && ((alignment & (alignment - 1)) == 0);
 }
 
+// Rounds value up to the next multiple of alignment.
+// alignment MUST be a valid alignment.
+[[nodiscard]]
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Data written by different threads is kept this far apart to avoid false sharing.
+// Fixed rather than std::hardware_destructive_interference_size, so that it does not vary between compiler flags.
+constexpr std::size_t cacheLineSize = 64;
+
 template<class T>
 concept allocator = 
     requires (
@@ -121,6 +139,48 @@ concept allocator =
     }
  && std::is_nothrow_copy_constructible_v<std::remove_reference_t<T>>;
 
+// Optional extension of allocator, for resizing an allocation in place without moving it.
+// expand returns false, and leaves the allocation untouched, if it cannot be done.
+// On success, the allocation must be freed with newSize from then on.
+template<class T>
+concept expanding_allocator =
+    allocator<T>
+ && requires (
+        T a,
+        Ptr<void> memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+    {
+        { a.expand(memory, oldSize, newSize, alignment) } noexcept -> std::same_as<bool>;
+    };
+
+// Optional extension of allocator, for resizing an allocation which may be moved in the process.
+// The bytes up to the smaller of both sizes are preserved.
+// On failure, the original allocation is left untouched.
+template<class T>
+concept reallocating_allocator =
+    allocator<T>
+ && requires (
+        T a,
+        Ptr<void> memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+    {
+        { a.realloc(memory, oldSize, newSize, alignment) } noexcept -> std::same_as<RE<Ptr<void>, SimpleError>>;
+    };
+
+// Whether moving a T into new storage and destroying the original is equivalent to copying its bytes,
+// which lets containers relocate their elements with memcpy or realloc.
+// Trivially copyable types are. Other types can opt in by specializing is_trivially_relocatable,
+// which is true for most types that merely own resources through pointers or handles.
+template<class T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<class T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 class BadAlloc : public SuberrorType<>
 {
 public:
@@ -171,6 +231,21 @@ public:
         assert(alignment <= alignof(std::max_align_t) && isValidAlignment(alignment));
         std::free(memory);
     }
+
+    [[nodiscard]]
+    static RE<Ptr<void>, SimpleError> realloc(
+                         Ptr<void> memory,
+        [[maybe_unused]] NonZero<std::size_t> oldSize,
+                         NonZero<std::size_t> newSize,
+        [[maybe_unused]] NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(alignment <= alignof(std::max_align_t) && isValidAlignment(alignment));
+        if (void *newMemory = std::realloc(memory, newSize); newMemory)
+            return makeNonNull_Unchecked(newMemory);
+        else
+            return {tags::error, getSingleton<BadMalloc>()};
+    }
 };
 
 } // export namespace pl
@@ -178,6 +253,609 @@ public:
 namespace pl
 {
 static_assert(allocator<Mallocator>, "Mallocator must be an allocator");
+static_assert(reallocating_allocator<Mallocator>, "Mallocator must support realloc");
+} // namespace pl
+
+export namespace pl
+{
+// Allocator that honours any valid alignment, e.g. for SIMD or cache line aligned data.
+// Alignments no greater than alignof(std::max_align_t) are forwarded to Mallocator.
+class AlignedAllocator
+{
+public:
+    [[nodiscard]]
+    static RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(isValidAlignment(alignment));
+        if (alignment <= alignof(std::max_align_t))
+            return Mallocator::alloc(size, alignment);
+
+        // std::aligned_alloc requires size to be a multiple of alignment.
+        if (void *memory = std::aligned_alloc(alignment, alignUp(size, alignment)); memory)
+            return makeNonNull_Unchecked(memory);
+        else
+            return {tags::error, getSingleton<BadMalloc>()};
+    }
+
+    static void free(
+                         Ptr<void> memory,
+        [[maybe_unused]] NonZero<std::size_t> size,
+        [[maybe_unused]] NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(isValidAlignment(alignment));
+        std::free(memory);
+    }
+
+    [[nodiscard]]
+    static RE<Ptr<void>, SimpleError> realloc(
+        Ptr<void>            memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(isValidAlignment(alignment));
+        if (alignment <= alignof(std::max_align_t))
+            return Mallocator::realloc(memory, oldSize, newSize, alignment);
+
+        // There is no aligned counterpart of std::realloc.
+        PL_TRY_ASSIGN(Ptr<void> newMemory, alloc(newSize, alignment));
+        std::memcpy(newMemory, memory, std::min<std::size_t>(oldSize, newSize));
+        free(memory, oldSize, alignment);
+        return newMemory;
+    }
+};
+
+class BadMmap : public SuberrorType<BadAlloc>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "BadMmap";
+    }
+};
+
+// Allocator for large, long-lived buffers backed by transparent huge pages.
+// Every allocation is rounded up to, and aligned to, hugePageSize,
+// so it is only worth it for buffers of at least a few megabytes.
+class HugePageAllocator
+{
+public:
+    static constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    [[nodiscard]]
+    static RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(alignment <= hugePageSize && isValidAlignment(alignment));
+#if defined(__linux__)
+        // mmap only guarantees page alignment, so over-reserve and trim to a huge page boundary.
+        std::size_t length   = alignUp(size, hugePageSize);
+        std::size_t reserved = length + hugePageSize;
+        void *mapping = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+            return {tags::error, getSingleton<BadMmap>()};
+
+        auto *begin   = static_cast<std::byte *>(mapping);
+        auto *aligned = begin + (alignUp(reinterpret_cast<std::uintptr_t>(begin), hugePageSize)
+                               - reinterpret_cast<std::uintptr_t>(begin));
+        auto *end     = begin + reserved;
+
+        if (aligned != begin)       ::munmap(begin, std::size_t(aligned - begin));
+        if (aligned + length < end) ::munmap(aligned + length, std::size_t(end - (aligned + length)));
+
+        // Only a hint, the memory is still usable if the kernel declines.
+        ::madvise(aligned, length, MADV_HUGEPAGE);
+        return makeNonNull_Unchecked(static_cast<void *>(aligned));
+#else
+        return AlignedAllocator::alloc(
+            makeNonZero_Unchecked(alignUp(size, hugePageSize)),
+            makeNonZero_Unchecked(hugePageSize));
+#endif
+    }
+
+    static void free(
+        Ptr<void>            memory,
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(alignment <= hugePageSize && isValidAlignment(alignment));
+#if defined(__linux__)
+        (void) alignment;
+        ::munmap(memory, alignUp(size, hugePageSize));
+#else
+        AlignedAllocator::free(
+            memory,
+            makeNonZero_Unchecked(alignUp(size, hugePageSize)),
+            makeNonZero_Unchecked(hugePageSize));
+#endif
+    }
+
+    // Succeeds as long as the allocation stays within the huge pages it already spans.
+    [[nodiscard]]
+    static bool expand(
+        [[maybe_unused]] Ptr<void> memory,
+                         NonZero<std::size_t> oldSize,
+                         NonZero<std::size_t> newSize,
+        [[maybe_unused]] NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(alignment <= hugePageSize && isValidAlignment(alignment));
+        return alignUp(oldSize, hugePageSize) == alignUp(newSize, hugePageSize);
+    }
+};
+
+// Allocator used by containers when none is specified.
+// Over-aligned types need AlignedAllocator, everything else is served by Mallocator.
+template<class T>
+using default_allocator_t = std::conditional_t<
+        (alignof(T) > alignof(std::max_align_t)),
+        AlignedAllocator,
+        Mallocator>;
+} // export namespace pl
+
+namespace pl
+{
+static_assert(allocator<AlignedAllocator>, "AlignedAllocator must be an allocator");
+static_assert(allocator<HugePageAllocator>, "HugePageAllocator must be an allocator");
+static_assert(reallocating_allocator<AlignedAllocator>, "AlignedAllocator must support realloc");
+static_assert(expanding_allocator<HugePageAllocator>, "HugePageAllocator must support expand");
+} // namespace pl
+
+export namespace pl
+{
+class ArenaExhausted : public SuberrorType<BadAlloc>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "ArenaExhausted";
+    }
+};
+
+enum class ArenaGrowth
+{
+    fixed,      // Only a single block is ever allocated, alloc fails once it is full.
+    chained,    // A new block is chained from the upstream allocator once the current one is full.
+};
+
+// Linear (bump) memory resource.
+// Allocation bumps a cursor within the current block, and free only reclaims memory
+// if it was the most recent allocation. Everything else is thrown away in bulk by reset(),
+// which keeps the blocks around so that steady-state use never touches the upstream allocator.
+//
+// Arena is not an allocator by itself, since allocators must be copyable.
+// ArenaAllocator is the copyable handle that refers to it.
+template<allocator Upstream = Mallocator>
+class Arena
+{
+public:
+    [[nodiscard]]
+    explicit Arena(
+        std::size_t     blockSize,
+        ArenaGrowth     growth   = ArenaGrowth::chained,
+        Upstream const &upstream = {})
+        noexcept
+    :
+        _blockSize(blockSize),
+        _growth(growth),
+        _upstream(upstream)
+    {}
+
+    Arena           (Arena const &) = delete;
+    Arena &operator=(Arena const &) = delete;
+
+    ~Arena()
+    {
+        release();
+    }
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        assert(isValidAlignment(alignment));
+        if (void *memory = bump(size, alignment); memory)
+            return makeNonNull_Unchecked(memory);
+
+        // Blocks retained across reset() are reused before asking upstream for more.
+        for (Block *block = _current ? _current->next : _first; block; block = block->next)
+        {
+            enter(block);
+            if (void *memory = bump(size, alignment); memory)
+                return makeNonNull_Unchecked(memory);
+        }
+
+        if (_first && _growth == ArenaGrowth::fixed)
+            return {tags::error, getSingleton<ArenaExhausted>()};
+
+        PL_TRY_ASSIGN(Block *block, allocBlock(size + alignment - 1));
+        enter(block);
+        return makeNonNull_Unchecked(bump(size, alignment));
+    }
+
+    void free(
+        Ptr<void>            memory,
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        (void) alignment;
+        // Only the most recent allocation can be given back, everything else waits for reset().
+        auto *p = static_cast<std::byte *>(static_cast<void *>(memory));
+        if (p + size == _cursor) _cursor = p;
+    }
+
+    // Only the most recent allocation can be resized, within what is left of its block.
+    [[nodiscard]]
+    bool expand(
+        Ptr<void>            memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        (void) alignment;
+        auto *p = static_cast<std::byte *>(static_cast<void *>(memory));
+        if (p + oldSize != _cursor || newSize > std::size_t(_limit - p)) return false;
+        _cursor = p + newSize;
+        return true;
+    }
+
+    // Allocates the first block up front, so that not even the first use has to go upstream.
+    [[nodiscard]]
+    RE<void, SimpleError> reserve() noexcept
+    {
+        if (_first) return {};
+        PL_TRY_DISCARD(allocBlock(0));
+        return {};
+    }
+
+    // Invalidates every allocation made from the arena, but keeps its blocks for reuse.
+    void reset() noexcept
+    {
+        _current = nullptr;
+        _cursor  = nullptr;
+        _limit   = nullptr;
+    }
+
+    // Invalidates every allocation made from the arena, and returns its blocks upstream.
+    void release() noexcept
+    {
+        for (Block *block = _first; block;)
+        {
+            Block *next = block->next;
+            _upstream.free(
+                makeNonNull_Unchecked(static_cast<void *>(block)),
+                makeNonZero_Unchecked(block->size),
+                makeNonZero_Unchecked(alignof(std::max_align_t)));
+            block = next;
+        }
+        _first = nullptr;
+        _last  = nullptr;
+        reset();
+    }
+
+private:
+    struct Block
+    {
+        Block       *next;
+        std::size_t  size;  // including this header
+    };
+
+    [[nodiscard]]
+    void *bump(std::size_t size, std::size_t alignment) noexcept
+    {
+        auto cursor  = reinterpret_cast<std::uintptr_t>(_cursor);
+        auto aligned = alignUp(cursor, alignment);
+        if (aligned + size > reinterpret_cast<std::uintptr_t>(_limit)) return nullptr;
+
+        std::byte *memory = _cursor + (aligned - cursor);
+        _cursor = memory + size;
+        return memory;
+    }
+
+    void enter(Block *block) noexcept
+    {
+        _current = block;
+        _cursor  = reinterpret_cast<std::byte *>(block) + sizeof(Block);
+        _limit   = reinterpret_cast<std::byte *>(block) + block->size;
+    }
+
+    [[nodiscard]]
+    RE<Block *, SimpleError> allocBlock(std::size_t minUsableSize) noexcept
+    {
+        std::size_t size = std::max(_blockSize, sizeof(Block) + minUsableSize);
+        PL_TRY_ASSIGN(Ptr<void> memory, _upstream.alloc(
+                makeNonZero_Unchecked(size),
+                makeNonZero_Unchecked(alignof(std::max_align_t))));
+
+        Block *block = std::construct_at(static_cast<Block *>(static_cast<void *>(memory)), nullptr, size);
+        if (_last)
+            _last->next = block;
+        else
+            _first = block;
+        _last = block;
+        return block;
+    }
+
+    Block     *_first   = {};
+    Block     *_last    = {};
+    Block     *_current = {};
+    std::byte *_cursor  = {};
+    std::byte *_limit   = {};
+
+    std::size_t                    _blockSize;
+    ArenaGrowth                    _growth;
+    [[no_unique_address]] Upstream _upstream;
+};
+
+template<allocator Upstream = Mallocator>
+class ArenaAllocator
+{
+public:
+    [[nodiscard]]
+    constexpr ArenaAllocator(Arena<Upstream> &arena) noexcept : _arena(&arena) {}
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        const noexcept
+    {
+        return _arena->alloc(size, alignment);
+    }
+
+    void free(
+        Ptr<void>            memory,
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        const noexcept
+    {
+        _arena->free(memory, size, alignment);
+    }
+
+    [[nodiscard]]
+    bool expand(
+        Ptr<void>            memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+        const noexcept
+    {
+        return _arena->expand(memory, oldSize, newSize, alignment);
+    }
+
+    [[nodiscard]]
+    constexpr Arena<Upstream> &arena() const noexcept
+    {
+        return *_arena;
+    }
+
+private:
+    Arena<Upstream> *_arena;
+};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(allocator<ArenaAllocator<>>, "ArenaAllocator must be an allocator");
+static_assert(expanding_allocator<ArenaAllocator<>>, "ArenaAllocator must support expand");
+} // namespace pl
+
+export namespace pl
+{
+class BadPoolAlloc : public SuberrorType<BadAlloc>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "BadPoolAlloc";
+    }
+};
+
+// Fixed-size block memory resource.
+// Slabs are requested from the upstream allocator and carved into blocks lazily.
+// Freed blocks are recycled through an intrusive free list threaded through the blocks themselves,
+// so both alloc and free are O(1), and the pool never fragments.
+//
+// Slabs are aligned to blockAlignment, so Upstream must support that alignment,
+// which is why it defaults to AlignedAllocator rather than Mallocator.
+//
+// Like Arena, Pool is the owning resource and PoolAllocator is the copyable allocator handle.
+template<
+    std::size_t BlockSize,
+    std::size_t Align    = alignof(std::max_align_t),
+    allocator   Upstream = AlignedAllocator>
+requires (BlockSize != 0 && isValidAlignment(Align))
+class Pool
+{
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    struct Slab
+    {
+        Slab *next;
+    };
+
+public:
+    static constexpr std::size_t blockAlignment = std::max(Align, alignof(FreeBlock));
+    static constexpr std::size_t blockSize      = alignUp(std::max(BlockSize, sizeof(FreeBlock)), blockAlignment);
+
+    [[nodiscard]]
+    explicit Pool(
+        std::size_t     blocksPerSlab = 64,
+        Upstream const &upstream      = {})
+        noexcept
+    :
+        _blocksPerSlab(blocksPerSlab),
+        _upstream(upstream)
+    {
+        assert(blocksPerSlab != 0);
+    }
+
+    Pool           (Pool const &) = delete;
+    Pool &operator=(Pool const &) = delete;
+
+    ~Pool()
+    {
+        release();
+    }
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        if (size > BlockSize || alignment > blockAlignment)
+            return {tags::error, getSingleton<BadPoolAlloc>()};
+
+        if (_freeList)
+        {
+            FreeBlock *block = _freeList;
+            _freeList = block->next;
+            return makeNonNull_Unchecked(static_cast<void *>(block));
+        }
+
+        if (_carve == _carveEnd)
+        {
+            PL_TRY_DISCARD(grow());
+        }
+
+        void *block = _carve;
+        _carve += blockSize;
+        return makeNonNull_Unchecked(block);
+    }
+
+    void free(
+        Ptr<void>            memory,
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        (void) size;
+        (void) alignment;
+        assert(size <= BlockSize && alignment <= blockAlignment);
+        _freeList = std::construct_at(static_cast<FreeBlock *>(static_cast<void *>(memory)), _freeList);
+    }
+
+    // Allocates another slab from upstream, so that the next blocksPerSlab allocations
+    // do not need to grow the pool.
+    [[nodiscard]]
+    RE<void, SimpleError> grow() noexcept
+    {
+        PL_TRY_ASSIGN(Ptr<void> memory, _upstream.alloc(
+                makeNonZero_Unchecked(slabSize()),
+                makeNonZero_Unchecked(blockAlignment)));
+
+        _slabs    = std::construct_at(static_cast<Slab *>(static_cast<void *>(memory)), _slabs);
+        _carve    = reinterpret_cast<std::byte *>(_slabs) + slabHeaderSize;
+        _carveEnd = _carve + _blocksPerSlab * blockSize;
+        return {};
+    }
+
+    // Invalidates every block allocated from the pool, and returns its slabs upstream.
+    void release() noexcept
+    {
+        for (Slab *slab = _slabs; slab;)
+        {
+            Slab *next = slab->next;
+            _upstream.free(
+                makeNonNull_Unchecked(static_cast<void *>(slab)),
+                makeNonZero_Unchecked(slabSize()),
+                makeNonZero_Unchecked(blockAlignment));
+            slab = next;
+        }
+        _slabs    = nullptr;
+        _freeList = nullptr;
+        _carve    = nullptr;
+        _carveEnd = nullptr;
+    }
+
+private:
+    static constexpr std::size_t slabHeaderSize = alignUp(sizeof(Slab), blockAlignment);
+
+    [[nodiscard]]
+    constexpr std::size_t slabSize() const noexcept
+    {
+        return slabHeaderSize + _blocksPerSlab * blockSize;
+    }
+
+    FreeBlock *_freeList = {};
+    Slab      *_slabs    = {};
+    std::byte *_carve    = {};
+    std::byte *_carveEnd = {};
+
+    std::size_t                    _blocksPerSlab;
+    [[no_unique_address]] Upstream _upstream;
+};
+
+template<
+    std::size_t BlockSize,
+    std::size_t Align    = alignof(std::max_align_t),
+    allocator   Upstream = AlignedAllocator>
+class PoolAllocator
+{
+public:
+    using pool_type = Pool<BlockSize, Align, Upstream>;
+
+    [[nodiscard]]
+    constexpr PoolAllocator(pool_type &pool) noexcept : _pool(&pool) {}
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        const noexcept
+    {
+        return _pool->alloc(size, alignment);
+    }
+
+    void free(
+        Ptr<void>            memory,
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        const noexcept
+    {
+        _pool->free(memory, size, alignment);
+    }
+
+    [[nodiscard]]
+    constexpr pool_type &pool() const noexcept
+    {
+        return *_pool;
+    }
+
+private:
+    pool_type *_pool;
+};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(allocator<PoolAllocator<16>>, "PoolAllocator must be an allocator");
 } // namespace pl
 
 export namespace pl
@@ -282,6 +960,73 @@ constexpr void free(A &&a, Span<T, N> arr) noexcept
     }
 }
 
+// Resizes arr in place to count elements, without moving it.
+// Returns false if the allocator does not support it, or cannot do it this time.
+// The elements' lifetimes are not affected either way.
+template<class T, allocator A>
+requires (sizeof(T) != 0)
+[[nodiscard]]
+constexpr bool expand(A &&a, Span<T> arr, std::size_t count) noexcept
+{
+    if consteval
+    {
+        return false;
+    }
+    else
+    {
+        if constexpr (expanding_allocator<A>)
+        {
+            if (arr.empty() || count == 0) return false;
+            return a.expand(
+                makeNonNull_Unchecked(static_cast<void *>(arr.data())),
+                makeNonZero_Unchecked(sizeof(T) * arr.size()),
+                makeNonZero_Unchecked(sizeof(T) * count),
+                makeNonZero_Unchecked(alignof(T)));
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
+
+// Resizes arr to count elements, relocating its first numLive elements by copying their bytes
+// if it has to be moved. Prefers expanding in place, then the allocator's realloc,
+// and falls back to alloc, memcpy and free.
+// On success, arr must no longer be used. On failure, it is left untouched.
+template<class T, allocator A>
+requires (sizeof(T) != 0 && is_trivially_relocatable_v<T>)
+[[nodiscard]]
+RE<Span<T>, SimpleError> realloc(A &&a, Span<T> arr, std::size_t count, std::size_t numLive) noexcept
+{
+    assert(numLive <= arr.size() && numLive <= count);
+    if (arr.empty()) return alloc<T>(a, count);
+    if (count == 0)
+    {
+        free(a, arr);
+        return {};
+    }
+    if (expand(a, arr, count)) return Span<T>(arr.data(), count);
+
+    if constexpr (reallocating_allocator<A>)
+    {
+        PL_TRY_ASSIGN(Ptr<void> memory, a.realloc(
+                makeNonNull_Unchecked(static_cast<void *>(arr.data())),
+                makeNonZero_Unchecked(sizeof(T) * arr.size()),
+                makeNonZero_Unchecked(sizeof(T) * count),
+                makeNonZero_Unchecked(alignof(T))));
+
+        return start_lifetime_as_array<T>(memory, count);
+    }
+    else
+    {
+        PL_TRY_ASSIGN(Span<T> newArr, alloc<T>(a, count));
+        std::memcpy(static_cast<void *>(newArr.data()), arr.data(), sizeof(T) * numLive);
+        free(a, arr);
+        return newArr;
+    }
+}
+
 template<class T>
 requires (sizeof(T) != 0)
 class NewArr
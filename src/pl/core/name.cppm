@@ -0,0 +1,287 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <string_view>
+
+#include <pl/macro.hpp>
+
+export module pl.core:name;
+
+import :error;
+import :hash;
+import :memory;
+import :null;
+import :numeric;
+import :optional;
+import :result_error;
+import :singleton;
+
+export namespace pl
+{
+class NameTableFull : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "NameTableFull";
+    }
+};
+
+// A string together with its hash, the key that Names are looked up by.
+// Declaring it constexpr, or using the _name literal, hashes the string at compile time.
+class NameKey
+{
+public:
+    [[nodiscard]] constexpr NameKey(std::string_view str) noexcept
+    : _str(str), _hash(hashBytes(str.data(), str.size())) {}
+
+    [[nodiscard]] constexpr NameKey(char const *str) noexcept
+    : NameKey(std::string_view(str)) {}
+
+    [[nodiscard]] constexpr std::string_view str()  const noexcept { return _str;  }
+    [[nodiscard]] constexpr std::uint64_t    hash() const noexcept { return _hash; }
+
+private:
+    std::string_view _str;
+    std::uint64_t    _hash;
+};
+
+namespace literals
+{
+[[nodiscard]]
+consteval NameKey operator""_name(char const *str, std::size_t size) noexcept
+{
+    return std::string_view(str, size);
+}
+} // namespace literals
+} // export namespace pl
+
+namespace pl::name_
+{
+// Every name ever interned stays in these tables until the program exits.
+// Both tables are zero-initialized statics, so they cost nothing until they are touched.
+constexpr std::uint32_t maxNames      = 64 * 1024;
+constexpr std::uint32_t numSlots      = 2 * maxNames;
+constexpr std::size_t   minBlockSize  = 64 * 1024;
+
+struct Entry
+{
+    char const    *data;
+    std::uint32_t  size;
+    std::uint64_t  hash;
+};
+
+// Slots of the lookup table hold id + 1, so that 0 means empty.
+// An inserting thread stores the name first, and then publishes it with a single CAS of an empty slot,
+// so that a slot is never seen half-filled, and never goes back to empty.
+constexpr std::uint32_t slotEmpty = 0;
+
+// Append-only storage for the characters of names.
+// Blocks are never freed, and are chained so that they stay reachable.
+struct Block
+{
+    Block                    *prev;
+    std::size_t               size;
+    std::atomic<std::size_t>  used;
+
+    [[nodiscard]] char *data() noexcept
+    {
+        return reinterpret_cast<char *>(this + 1);
+    }
+};
+
+// Id 0 is the empty name, its entry is left zeroed so that the table stays out of the binary.
+constexpr std::uint64_t emptyHash = hashBytes("", 0);
+
+constinit inline Entry                      entries[maxNames] = {};
+constinit inline std::atomic<std::uint32_t> slots[numSlots]   = {};
+constinit inline std::atomic<std::uint32_t> numNames          = 1;
+constinit inline std::atomic<Block *>       currentBlock      = nullptr;
+
+[[nodiscard]]
+inline char *storeChars(std::string_view str) noexcept
+{
+    Block *block = currentBlock.load(std::memory_order_acquire);
+    while (true)
+    {
+        if (block)
+        {
+            std::size_t offset = block->used.fetch_add(str.size() + 1, std::memory_order_relaxed);
+            if (offset + str.size() + 1 <= block->size)
+            {
+                char *chars = block->data() + offset;
+                std::memcpy(chars, str.data(), str.size());
+                chars[str.size()] = '\0';
+                return chars;
+            }
+        }
+
+        // The rest of the current block is abandoned, names are small.
+        std::size_t size = std::max(minBlockSize, str.size() + 1);
+        RE<Ptr<void>, SimpleError> memory = Mallocator::alloc(
+            makeNonZero_Unchecked(sizeof(Block) + size),
+            makeNonZero_Unchecked(alignof(Block)));
+        if (!memory) return nullptr;
+
+        Block *fresh = ::new (static_cast<void *>(*memory)) Block{block, size, str.size() + 1};
+        if (currentBlock.compare_exchange_strong(block, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            std::memcpy(fresh->data(), str.data(), str.size());
+            fresh->data()[str.size()] = '\0';
+            return fresh->data();
+        }
+
+        // Another thread installed a block first, use that one instead.
+        Mallocator::free(*memory, makeNonZero_Unchecked(sizeof(Block) + size), makeNonZero_Unchecked(alignof(Block)));
+    }
+}
+
+[[nodiscard]]
+inline bool matches(std::uint32_t id, NameKey const &key) noexcept
+{
+    Entry const &entry = entries[id];
+    return entry.hash == key.hash() && std::string_view(entry.data, entry.size) == key.str();
+}
+} // namespace pl::name_
+
+export namespace pl
+{
+// Interned string: equal strings intern to the same Name, so comparing Names compares integers.
+//
+// Names are interned into a global, append-only table. Lookups never wait, not even on a concurrent
+// insertion, and insertions only contend when two threads insert names that hash to the same slot.
+// A Name stays valid, and its characters stay null-terminated and in place, until the program exits.
+class Name
+{
+public:
+    using id_type = std::uint32_t;
+
+    static constexpr std::uint32_t maxNames = name_::maxNames;
+
+    // The empty name.
+    [[nodiscard]] constexpr Name() noexcept = default;
+
+    // Returns the Name of key, interning it if it has never been interned.
+    [[nodiscard]]
+    static RE<Name, SimpleError> intern(NameKey const &key) noexcept
+    {
+        using namespace name_;
+        if (key.str().empty()) return Name();
+
+        // The name is stored once the first empty slot is reached, and then offered to every empty slot
+        // from there on, until one of them is won.
+        std::uint32_t id = 0;
+        for (std::uint32_t i = std::uint32_t(key.hash()) & (numSlots - 1);; i = (i + 1) & (numSlots - 1))
+        {
+            std::uint32_t value = slots[i].load(std::memory_order_acquire);
+            if (value == slotEmpty)
+            {
+                if (id == 0)
+                {
+                    PL_TRY_ASSIGN(id, store(key));
+                }
+                if (slots[i].compare_exchange_strong(value, id + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                    return Name(id);
+
+                // Lost the race for this slot, value is what the winner stored.
+                // If it is the same name, the stored id is lost, which is harmless, as ids are never reused anyway.
+            }
+            if (matches(value - 1, key)) return Name(value - 1);
+        }
+    }
+
+    // Returns the Name of key if it has been interned, without interning it.
+    [[nodiscard]]
+    static Opt<Name> find(NameKey const &key) noexcept
+    {
+        using namespace name_;
+        if (key.str().empty()) return Name();
+
+        for (std::uint32_t i = std::uint32_t(key.hash()) & (numSlots - 1);; i = (i + 1) & (numSlots - 1))
+        {
+            std::uint32_t value = slots[i].load(std::memory_order_acquire);
+            if (value == slotEmpty) return {};
+            if (matches(value - 1, key)) return Name(value - 1);
+        }
+    }
+
+    [[nodiscard]] constexpr id_type id() const noexcept { return _id; }
+
+    [[nodiscard]] std::string_view view() const noexcept
+    {
+        name_::Entry const &entry = name_::entries[_id];
+        return {entry.data, entry.size};
+    }
+
+    [[nodiscard]] char const *c_str() const noexcept
+    {
+        return _id == 0 ? "" : name_::entries[_id].data;
+    }
+
+    // Hash of the characters, the same as NameKey(view()).hash(), so it is stable across runs.
+    [[nodiscard]] std::uint64_t hash() const noexcept
+    {
+        return _id == 0 ? name_::emptyHash : name_::entries[_id].hash;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return _id == 0; }
+
+    [[nodiscard]] friend constexpr bool operator==(Name, Name) noexcept = default;
+
+    friend std::ostream &operator<<(std::ostream &os, Name name)
+    {
+        return os << name.view();
+    }
+
+private:
+    [[nodiscard]] explicit constexpr Name(id_type id) noexcept : _id(id) {}
+
+    // Stores the name in a fresh entry, which is not reachable until its id is published in a slot.
+    [[nodiscard]]
+    static RE<id_type, SimpleError> store(NameKey const &key) noexcept
+    {
+        using namespace name_;
+        std::uint32_t id = numNames.fetch_add(1, std::memory_order_relaxed);
+        if (id >= maxNames)
+        {
+            numNames.fetch_sub(1, std::memory_order_relaxed);
+            return {tags::error, getSingleton<NameTableFull>()};
+        }
+
+        // On failure the id is lost, which is harmless, as ids are never reused anyway.
+        char const *chars = storeChars(key.str());
+        if (!chars) return {tags::error, getSingleton<BadMalloc>()};
+
+        entries[id] = {chars, std::uint32_t(key.str().size()), key.hash()};
+        return id;
+    }
+
+    id_type _id = 0;
+};
+
+// Names already carry the hash of their characters.
+template<>
+struct Hash<Name>
+{
+    [[nodiscard]]
+    static std::uint64_t operator()(Name name) noexcept
+    {
+        return name.hash();
+    }
+};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(sizeof(Name) == sizeof(std::uint32_t));
+static_assert(NameKey("VK_KHR_swapchain").hash() == hashBytes("VK_KHR_swapchain", 16));
+} // namespace pl
@@ -7,48 +7,13 @@ module;
 
 export module pl.core:null;
 
+export import :null_trait;
+
 import :error;
 import :result_error;
 
 export namespace pl
 {
-template<class T>
-struct PointerNullTrait
-{
-    [[nodiscard]] static constexpr bool isNull(T *ptr) noexcept { return ptr == nullptr; }
-    [[nodiscard]] static constexpr T     *null()       noexcept { return nullptr;        }
-};
-
-template<class T>
-PointerNullTrait<T> plNullable(T*);
-
-template<class Trait, class T>
-concept null_trait = requires (T const ct)
-{
-    { Trait::isNull(ct) } noexcept -> std::convertible_to<bool>;
-    { Trait::null()     } noexcept -> std::same_as<T>;
-};
-
-template<class T>
-concept nullable = requires (T const ct)
-{
-    { plNullable(ct) } -> null_trait<T>;
-};
-
-template<class Trait, class T>
-concept hidden_null_trait = requires(T t, T const ct)
-{
-    { Trait::isNull(ct)    } noexcept -> std::convertible_to<bool>;
-    { Trait::null()        } noexcept -> std::same_as<T>;
-    { Trait::assignNull(t) } noexcept;
-};
-
-template<class T>
-concept hidden_nullable = requires (T const ct)
-{
-    { plHiddenNullable(ct) } -> null_trait<T>;
-};
-
 class NullError : public SuberrorType<>
 {
 public:
@@ -334,3 +299,9 @@ constexpr Ptr<T> addr(T &t) noexcept
     return makeNonNull_Unchecked(std::addressof(t));
 }
 } // export namespace pl
+
+namespace pl
+{
+static_assert(sizeof(RE<Ptr<int>, SimpleError>) == 2 * sizeof(void *));
+static_assert(std::is_trivially_copyable_v<RE<Ptr<int>, SimpleError>>);
+}
@@ -0,0 +1,46 @@
+module;
+#include <concepts>
+
+export module pl.core:null_trait;
+
+export namespace pl
+{
+template<class T>
+struct PointerNullTrait
+{
+    [[nodiscard]] static constexpr bool isNull(T *ptr) noexcept { return ptr == nullptr; }
+    [[nodiscard]] static constexpr T     *null()       noexcept { return nullptr;        }
+};
+
+template<class T>
+PointerNullTrait<T> plNullable(T*);
+
+template<class Trait, class T>
+concept null_trait = requires (T const ct)
+{
+    { Trait::isNull(ct) } noexcept -> std::convertible_to<bool>;
+    { Trait::null()     } noexcept -> std::same_as<T>;
+};
+
+template<class T>
+concept nullable = requires (T const ct)
+{
+    { plNullable(ct) } -> null_trait<T>;
+};
+
+template<class Trait, class T>
+concept hidden_null_trait = requires(T t, T const ct)
+{
+    { Trait::isNull(ct)    } noexcept -> std::convertible_to<bool>;
+    { Trait::null()        } noexcept -> std::same_as<T>;
+    { Trait::assignNull(t) } noexcept;
+};
+
+// Types with a value that can never be observed, which wrappers such as Optional and ResultError
+// can use as their empty state instead of storing a separate flag.
+template<class T>
+concept hidden_nullable = requires (T const ct)
+{
+    { plHiddenNullable(ct) } -> hidden_null_trait<T>;
+};
+} // export namespace pl
@@ -105,7 +105,7 @@ struct NonZeroHiddenNullTrait
     [[nodiscard]] 
     static constexpr bool isNull(NonZero<T> v) noexcept
     {
-        return v != 0;
+        return v == 0;
     }
 
     [[nodiscard]] 
@@ -114,8 +114,7 @@ struct NonZeroHiddenNullTrait
         return NonZero<T>();
     }
 
-    [[nodiscard]] 
-    static constexpr NonZero<T> assignNull(NonZero<T> &v) noexcept
+    static constexpr void assignNull(NonZero<T> &v) noexcept
     {
         v = null();
     }
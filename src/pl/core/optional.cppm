@@ -366,7 +366,7 @@ public:
     constexpr Optional(Optional const &other)
     noexcept(std::is_nothrow_copy_constructible_v<T>)
     requires std::is_copy_constructible_v<T>
-    : _obj(*other)
+    : _obj(other._obj)
     {}
 
     [[nodiscard]] 
@@ -374,7 +374,7 @@ public:
     constexpr Optional(Optional &&other)
     noexcept(std::is_nothrow_move_constructible_v<T>)
     requires std::is_move_constructible_v<T>
-    : _obj(*std::move(other))
+    : _obj(std::move(other._obj))
     {}
 
     template<class U>
@@ -464,48 +464,48 @@ public:
 
     [[nodiscard]] constexpr T &operator*() & noexcept
     {
-        assert(hasValue());
+        assert(has_value());
         return _obj;
     }
 
     [[nodiscard]] constexpr T const &operator*() const & noexcept
     {
-        assert(hasValue());
+        assert(has_value());
         return _obj;
     }
 
     [[nodiscard]] constexpr T &&operator*() && noexcept
     {
-        assert(hasValue());
+        assert(has_value());
         return std::move(_obj);
     }
 
     [[nodiscard]] constexpr T const &&operator*() const && noexcept
     {
-        assert(hasValue());
+        assert(has_value());
         return std::move(_obj);
     }
 
     [[nodiscard]] constexpr T *operator->() noexcept
     {
-        assert(hasValue());
+        assert(has_value());
         return &_obj;
     }
 
     [[nodiscard]] constexpr T const *operator->() const noexcept
     {
-        assert(hasValue());
+        assert(has_value());
         return &_obj;
     }
 
     [[nodiscard]] explicit constexpr operator bool() const noexcept
     {
-        return null_trait::isNull(_obj);
+        return has_value();
     }
 
-    [[nodiscard]] constexpr bool hasValue() const noexcept
+    [[nodiscard]] constexpr bool has_value() const noexcept
     {
-        return null_trait::isNull(_obj);
+        return !null_trait::isNull(_obj);
     }
 private:
     T _obj;
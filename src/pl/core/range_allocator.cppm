@@ -0,0 +1,317 @@
+module;
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:range_allocator;
+
+import :array_list;
+import :error;
+import :memory;
+import :result_error;
+
+export namespace pl
+{
+class RangeExhausted : public SuberrorType<BadAlloc>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "RangeExhausted";
+    }
+};
+
+// Range of offsets handed out by a RangeAllocator.
+struct RangeAllocation
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+    // Identifies the allocation to RangeAllocator::free.
+    std::uint32_t node;
+};
+
+// Sub-allocates ranges of [0, capacity) for memory that cannot hold bookkeeping of its own,
+// such as GPU memory. Nothing is ever read from or written to the managed range itself.
+//
+// Free ranges are kept in two-level segregated fit (TLSF) bins: by the position of their highest bit,
+// then by the sl_bits bits below it. Bitmaps of non-empty bins find a fitting range in O(1),
+// and a freed range is merged with its free neighbours right away, so free is O(1) too.
+// The bookkeeping of the range is only allocated on the first alloc.
+template<allocator A = default_allocator_t<std::byte>>
+class RangeAllocator
+{
+public:
+    using allocator_type = A;
+    using size_type      = std::uint64_t;
+
+    static constexpr std::uint32_t sl_bits = 4;
+
+    [[nodiscard]] RangeAllocator() = default;
+
+    [[nodiscard]] explicit constexpr RangeAllocator(size_type capacity, allocator_type const &a = {}) noexcept
+    : _nodes(a), _capacity(capacity) {}
+
+    [[nodiscard]] constexpr RangeAllocator(RangeAllocator &&other) noexcept
+    : _nodes(other.get_allocator())
+    {
+        swap(other);
+    }
+
+    constexpr RangeAllocator &operator=(RangeAllocator &&other) noexcept
+    {
+        RangeAllocator(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _nodes.get_allocator();
+    }
+
+    [[nodiscard]] constexpr size_type   capacity()        const noexcept { return _capacity;            }
+    [[nodiscard]] constexpr size_type   used()            const noexcept { return _used;                }
+    [[nodiscard]] constexpr size_type   available()       const noexcept { return _capacity - _used;    }
+    [[nodiscard]] constexpr std::size_t num_allocations() const noexcept { return _numAllocations;      }
+    [[nodiscard]] constexpr bool        empty()           const noexcept { return _numAllocations == 0; }
+
+    // alignment MUST be a power of 2.
+    [[nodiscard]]
+    constexpr RE<RangeAllocation, SimpleError> alloc(size_type size, size_type alignment = 1) noexcept
+    {
+        PL_ASSERT(size != 0 && std::has_single_bit(alignment));
+        if (size > _capacity || alignment - 1 > _capacity - size)
+            return {tags::error, getSingleton<RangeExhausted>()};
+
+        // Splitting off the padding before and the rest after the allocation takes up to two more nodes.
+        PL_TRY_DISCARD(_nodes.reserve(3));
+        if (_nodes.empty())
+        {
+            for (auto &row : _heads)
+                for (std::uint32_t &head : row) head = npos;
+            (void) _nodes.push_back({0, _capacity, npos, npos, npos, npos, false});
+            insert_free(0);
+        }
+
+        // Any range in a bin at least this large fits the allocation, however it is aligned.
+        // Failing that, ranges sharing a bin with the allocation may still be large enough.
+        size_type     padded = size + alignment - 1;
+        std::uint32_t node   = find_free(search_bin_of(padded));
+        if (node == npos)
+            node = find_in_bin(bin_of(padded), padded);
+        if (node == npos)
+            return {tags::error, getSingleton<RangeExhausted>()};
+        remove_free(node);
+
+        size_type begin   = _nodes[node].offset;
+        size_type aligned = (begin + alignment - 1) & ~(alignment - 1);
+        if (aligned != begin)
+        {
+            // The range before this one is in use, since free ranges are always merged.
+            std::uint32_t front = new_node({begin, aligned - begin, _nodes[node].prevPhys, node, npos, npos, false});
+            if (_nodes[front].prevPhys != npos) _nodes[_nodes[front].prevPhys].nextPhys = front;
+            _nodes[node].prevPhys = front;
+            _nodes[node].offset   = aligned;
+            _nodes[node].size    -= aligned - begin;
+            insert_free(front);
+        }
+        if (_nodes[node].size != size)
+        {
+            std::uint32_t back = new_node({aligned + size, _nodes[node].size - size, node, _nodes[node].nextPhys, npos, npos, false});
+            if (_nodes[back].nextPhys != npos) _nodes[_nodes[back].nextPhys].prevPhys = back;
+            _nodes[node].nextPhys = back;
+            _nodes[node].size     = size;
+            insert_free(back);
+        }
+
+        _used += size;
+        ++_numAllocations;
+        return RangeAllocation{aligned, size, node};
+    }
+
+    constexpr void free(RangeAllocation const &allocation) noexcept
+    {
+        std::uint32_t node = allocation.node;
+        PL_ASSERT(node < _nodes.size() && !_nodes[node].isFree && _nodes[node].offset == allocation.offset);
+
+        _used -= _nodes[node].size;
+        --_numAllocations;
+
+        if (std::uint32_t next = _nodes[node].nextPhys; next != npos && _nodes[next].isFree)
+        {
+            remove_free(next);
+            absorb_next(node);
+        }
+        if (std::uint32_t prev = _nodes[node].prevPhys; prev != npos && _nodes[prev].isFree)
+        {
+            remove_free(prev);
+            absorb_next(prev);
+            node = prev;
+        }
+        insert_free(node);
+    }
+
+    constexpr void swap(RangeAllocator &other) noexcept
+    {
+        using std::swap;
+        _nodes.swap(other._nodes);
+        swap(_heads,          other._heads);
+        swap(_slBitmaps,      other._slBitmaps);
+        swap(_flBitmap,       other._flBitmap);
+        swap(_unusedHead,     other._unusedHead);
+        swap(_capacity,       other._capacity);
+        swap(_used,           other._used);
+        swap(_numAllocations, other._numAllocations);
+    }
+
+    friend constexpr void swap(RangeAllocator &a, RangeAllocator &b) noexcept
+    {
+        a.swap(b);
+    }
+
+private:
+    static constexpr std::uint32_t npos    = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t slCount = std::uint32_t(1) << sl_bits;
+    // Ranges smaller than slCount share the first bin row, one size per bin.
+    static constexpr std::uint32_t flCount = std::numeric_limits<size_type>::digits - sl_bits + 1;
+
+    struct Node
+    {
+        size_type     offset;
+        size_type     size;
+        // Neighbouring ranges by offset.
+        std::uint32_t prevPhys;
+        std::uint32_t nextPhys;
+        // Neighbours in the bin while free, next unused node while unused.
+        std::uint32_t prevFree;
+        std::uint32_t nextFree;
+        bool          isFree;
+    };
+
+    struct Bin
+    {
+        std::uint32_t fl;
+        std::uint32_t sl;
+    };
+
+    [[nodiscard]] static constexpr Bin bin_of(size_type size) noexcept
+    {
+        if (size < slCount) return {0, std::uint32_t(size)};
+        auto msb = std::uint32_t(std::bit_width(size)) - 1;
+        return {msb - sl_bits + 1, std::uint32_t(size >> (msb - sl_bits)) - slCount};
+    }
+
+    // First bin whose every range is at least size.
+    [[nodiscard]] static constexpr Bin search_bin_of(size_type size) noexcept
+    {
+        if (size >= slCount)
+        {
+            auto msb = std::uint32_t(std::bit_width(size)) - 1;
+            size_type rounded = size + (size_type(1) << (msb - sl_bits)) - 1;
+            // Nothing is larger than the largest bin anyway.
+            if (rounded < size) return {flCount - 1, slCount - 1};
+            size = rounded;
+        }
+        return bin_of(size);
+    }
+
+    [[nodiscard]] constexpr std::uint32_t find_free(Bin bin) const noexcept
+    {
+        std::uint32_t slMap = _slBitmaps[bin.fl] & (~std::uint32_t(0) << bin.sl);
+        if (slMap == 0)
+        {
+            std::uint64_t flMap = bin.fl + 1 < flCount ? _flBitmap & (~std::uint64_t(0) << (bin.fl + 1)) : 0;
+            if (flMap == 0) return npos;
+            bin.fl = std::uint32_t(std::countr_zero(flMap));
+            slMap  = _slBitmaps[bin.fl];
+        }
+        bin.sl = std::uint32_t(std::countr_zero(slMap));
+        return _heads[bin.fl][bin.sl];
+    }
+
+    [[nodiscard]] constexpr std::uint32_t find_in_bin(Bin bin, size_type size) const noexcept
+    {
+        if (!(_slBitmaps[bin.fl] & (std::uint32_t(1) << bin.sl))) return npos;
+        for (std::uint32_t node = _heads[bin.fl][bin.sl]; node != npos; node = _nodes[node].nextFree)
+        {
+            if (_nodes[node].size >= size) return node;
+        }
+        return npos;
+    }
+
+    constexpr void insert_free(std::uint32_t node) noexcept
+    {
+        Bin bin = bin_of(_nodes[node].size);
+        std::uint32_t &head = _heads[bin.fl][bin.sl];
+
+        _nodes[node].isFree   = true;
+        _nodes[node].prevFree = npos;
+        _nodes[node].nextFree = head;
+        if (head != npos) _nodes[head].prevFree = node;
+        head = node;
+
+        _slBitmaps[bin.fl] |= std::uint32_t(1) << bin.sl;
+        _flBitmap          |= std::uint64_t(1) << bin.fl;
+    }
+
+    constexpr void remove_free(std::uint32_t node) noexcept
+    {
+        Bin bin = bin_of(_nodes[node].size);
+        std::uint32_t prev = _nodes[node].prevFree;
+        std::uint32_t next = _nodes[node].nextFree;
+
+        if (prev != npos) _nodes[prev].nextFree = next;
+        else              _heads[bin.fl][bin.sl] = next;
+        if (next != npos) _nodes[next].prevFree = prev;
+        _nodes[node].isFree = false;
+
+        if (_heads[bin.fl][bin.sl] == npos)
+        {
+            _slBitmaps[bin.fl] &= ~(std::uint32_t(1) << bin.sl);
+            if (_slBitmaps[bin.fl] == 0) _flBitmap &= ~(std::uint64_t(1) << bin.fl);
+        }
+    }
+
+    // Merges the range after node into node, and releases its node.
+    constexpr void absorb_next(std::uint32_t node) noexcept
+    {
+        std::uint32_t next = _nodes[node].nextPhys;
+        _nodes[node].size    += _nodes[next].size;
+        _nodes[node].nextPhys = _nodes[next].nextPhys;
+        if (_nodes[node].nextPhys != npos) _nodes[_nodes[node].nextPhys].prevPhys = node;
+
+        _nodes[next].nextFree = _unusedHead;
+        _unusedHead = next;
+    }
+
+    // Room for the node MUST have been reserved.
+    [[nodiscard]] constexpr std::uint32_t new_node(Node const &value) noexcept
+    {
+        if (_unusedHead == npos)
+        {
+            (void) _nodes.push_back(value);
+            return std::uint32_t(_nodes.size() - 1);
+        }
+        std::uint32_t node = _unusedHead;
+        _unusedHead  = _nodes[node].nextFree;
+        _nodes[node] = value;
+        return node;
+    }
+
+    ArrayList<Node, A> _nodes;
+    // Only valid where the bitmaps are set, until the first alloc.
+    std::uint32_t      _heads[flCount][slCount] = {};
+    std::uint32_t      _slBitmaps[flCount]      = {};
+    std::uint64_t      _flBitmap                = 0;
+    std::uint32_t      _unusedHead              = npos;
+    size_type          _capacity                = 0;
+    size_type          _used                    = 0;
+    std::size_t        _numAllocations          = 0;
+};
+} // export namespace pl
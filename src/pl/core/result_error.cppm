@@ -10,6 +10,7 @@ export module pl.core:result_error;
 
 export import :tags;
 
+import :null_trait;
 import :traits;
 
 export namespace pl
@@ -185,6 +186,14 @@ ErrorResult(E) -> ErrorResult<E>;
 template<class Result, class Error>
 class [[nodiscard]] ResultError
 {
+    static constexpr bool trivially_copyable =
+        traits::is_trivially_copyable_or_void_v<Result>
+     && traits::is_trivially_copyable_or_void_v<Error>;
+
+    static constexpr bool trivially_destructible =
+        traits::is_trivially_destructible_or_void_v<Result>
+     && traits::is_trivially_destructible_or_void_v<Error>;
+
 public:
     [[nodiscard]]
     explicit(!traits::is_implicitly_default_constructible_v<Result> && !std::is_void_v<Result>)
@@ -278,6 +287,14 @@ public:
     requires std::is_constructible_v<Error, std::initializer_list<T>, Args...>
     : _u{.error{std::move(ilist), std::forward<Args>(args)...}}, _hasValue(false) {}
 
+    // When both alternatives are trivially copyable, so is ResultError, which lets the ABI return it in registers
+    // instead of through memory. That keeps propagating errors with PL_TRY cheap.
+    [[nodiscard]] ResultError(ResultError const &) requires trivially_copyable = default;
+    [[nodiscard]] ResultError(ResultError      &&) requires trivially_copyable = default;
+
+    ResultError &operator=(ResultError const  &) requires trivially_copyable = default;
+    ResultError &operator=(ResultError       &&) requires trivially_copyable = default;
+
     [[nodiscard]]
     explicit(
         !std::is_convertible_v<std::add_lvalue_reference_t<Result const>, Result>
@@ -288,7 +305,8 @@ public:
      && traits::is_nothrow_copy_constructible_or_void_v<Error >)
     requires(
         traits::is_copy_constructible_or_void_v<Result>
-     && traits::is_copy_constructible_or_void_v<Error >)
+     && traits::is_copy_constructible_or_void_v<Error >
+     && !trivially_copyable)
     : _u{.none{}}, _hasValue(other.has_value())
     {
         if (other)
@@ -317,7 +335,8 @@ public:
      && traits::is_nothrow_move_constructible_or_void_v<Error>)
     requires(
         traits::is_move_constructible_or_void_v<Result>
-     && traits::is_move_constructible_or_void_v<Error>)
+     && traits::is_move_constructible_or_void_v<Error>
+     && !trivially_copyable)
     : _u{.none{}}, _hasValue(other.has_value())
     {
         if (other)
@@ -490,7 +509,8 @@ public:
         traits::is_copy_constructible_or_void_v<Result>
      && traits::is_copy_assignable_or_void_v   <Result>
      && traits::is_copy_constructible_or_void_v<Error >
-     && traits::is_copy_assignable_or_void_v   <Error >)
+     && traits::is_copy_assignable_or_void_v   <Error >
+     && !trivially_copyable)
     {
         if (_hasValue)
         {
@@ -538,7 +558,8 @@ public:
         traits::is_move_constructible_or_void_v<Result>
      && traits::is_move_constructible_or_void_v<Error >
      && traits::is_move_assignable_or_void_v   <Result>
-     && traits::is_move_assignable_or_void_v   <Error >)
+     && traits::is_move_assignable_or_void_v   <Error >
+     && !trivially_copyable)
     {
         if (_hasValue)
         {
@@ -690,9 +711,12 @@ public:
                     _u.error = std::move(other).error();
             }
         }
+        _hasValue = other.has_value();
         return *this;
     }
 
+    ~ResultError() requires trivially_destructible = default;
+
     constexpr ~ResultError()
     {
         if (_hasValue)
@@ -797,6 +821,7 @@ private:
         [[no_unique_address]] tags::none_t                   none;
         [[no_unique_address]] traits::none_if_void_t<Result> result;
         [[no_unique_address]] traits::none_if_void_t<Error>  error;
+        ~U() requires trivially_destructible = default;
         constexpr ~U() {}
     };
 
@@ -804,6 +829,140 @@ private:
     bool                    _hasValue;
 };
 
+// A ResultError without a result and with a hidden-nullable error stores nothing but the error,
+// with the null error meaning success. RE<void, SimpleError> is then as small as a pointer.
+template<class Error>
+requires hidden_nullable<Error>
+class [[nodiscard]] ResultError<void, Error>
+{
+    using null_trait = decltype(plHiddenNullable(std::declval<Error const &>()));
+
+public:
+    [[nodiscard]]
+    constexpr ResultError() noexcept
+    : _error(null_trait::null()) {}
+
+    template<class Error2>
+    [[nodiscard]]
+    explicit(!std::is_convertible_v<std::add_lvalue_reference_t<Error2 const>, Error>)
+    constexpr ResultError(ErrorResult<Error2> const &e)
+    noexcept(std::is_nothrow_constructible_v<Error, std::add_lvalue_reference_t<Error2 const>>)
+    requires std::is_constructible_v        <Error, std::add_lvalue_reference_t<Error2 const>>
+    : _error(e.error())
+    {
+        assert(!null_trait::isNull(_error));
+    }
+
+    template<class Error2>
+    [[nodiscard]]
+    explicit(!std::is_convertible_v<Error2, Error>)
+    constexpr ResultError(ErrorResult<Error2> &&e)
+    noexcept(std::is_nothrow_constructible_v<Error, Error2>)
+    requires std::is_constructible_v        <Error, Error2>
+    : _error(std::move(e).error())
+    {
+        assert(!null_trait::isNull(_error));
+    }
+
+    [[nodiscard]]
+    explicit constexpr ResultError(tags::in_place_t) noexcept
+    : ResultError() {}
+
+    template<class ...Args>
+    [[nodiscard]]
+    explicit(!traits::is_implicitly_constructible_v<Error, Args...>)
+    constexpr ResultError(tags::error_t, Args &&...args)
+    noexcept(std::is_nothrow_constructible_v<Error, Args...>)
+    requires std::is_constructible_v        <Error, Args...>
+    : _error(std::forward<Args>(args)...)
+    {
+        assert(!null_trait::isNull(_error));
+    }
+
+    [[nodiscard]] ResultError(ResultError const &) = default;
+    [[nodiscard]] ResultError(ResultError      &&) = default;
+
+    template<class Error2>
+    [[nodiscard]]
+    explicit(!std::is_convertible_v<std::add_lvalue_reference_t<Error2 const>, Error>)
+    constexpr ResultError(ResultError<void, Error2> const &other)
+    noexcept(std::is_nothrow_constructible_v<Error, std::add_lvalue_reference_t<Error2 const>>)
+    requires(
+        std::is_constructible_v<Error, std::add_lvalue_reference_t<Error2 const>>
+     && !std::is_same_v<Error, Error2>)
+    : _error(other ? null_trait::null() : Error(other.error())) {}
+
+    template<class Error2>
+    [[nodiscard]]
+    explicit(!std::is_convertible_v<Error2, Error>)
+    constexpr ResultError(ResultError<void, Error2> &&other)
+    noexcept(std::is_nothrow_constructible_v<Error, Error2>)
+    requires(
+        std::is_constructible_v<Error, Error2>
+     && !std::is_same_v<Error, Error2>)
+    : _error(other ? null_trait::null() : Error(std::move(other).error())) {}
+
+    template<class Error2>
+    constexpr ResultError &operator=(ErrorResult<Error2> const &e)
+    noexcept(std::is_nothrow_assignable_v<std::add_lvalue_reference_t<Error>, std::add_lvalue_reference_t<Error2 const>>)
+    requires std::is_assignable_v        <std::add_lvalue_reference_t<Error>, std::add_lvalue_reference_t<Error2 const>>
+    {
+        _error = e.error();
+        assert(!null_trait::isNull(_error));
+        return *this;
+    }
+
+    template<class Error2>
+    constexpr ResultError &operator=(ErrorResult<Error2> &&e)
+    noexcept(std::is_nothrow_assignable_v<std::add_lvalue_reference_t<Error>, Error2>)
+    requires std::is_assignable_v        <std::add_lvalue_reference_t<Error>, Error2>
+    {
+        _error = std::move(e).error();
+        assert(!null_trait::isNull(_error));
+        return *this;
+    }
+
+    ResultError &operator=(ResultError const  &) = default;
+    ResultError &operator=(ResultError       &&) = default;
+
+    constexpr void operator*() const noexcept
+    {
+        assert(has_value());
+        return;
+    }
+
+    [[nodiscard]] constexpr Error &error() & noexcept
+    {
+        assert(!has_value());
+        return _error;
+    }
+
+    [[nodiscard]] constexpr Error const &error() const & noexcept
+    {
+        assert(!has_value());
+        return _error;
+    }
+
+    [[nodiscard]] constexpr Error &&error() && noexcept
+    {
+        assert(!has_value());
+        return std::move(_error);
+    }
+
+    [[nodiscard]] constexpr Error const &&error() const && noexcept
+    {
+        assert(!has_value());
+        return std::move(_error);
+    }
+
+    [[nodiscard]] explicit constexpr operator bool() const noexcept { return has_value(); }
+
+    [[nodiscard]] constexpr bool has_value() const noexcept { return null_trait::isNull(_error); }
+
+private:
+    Error _error;
+};
+
 template<class Result, class Error>
 using RE = ResultError<Result, Error>;
 } // export namespace pl
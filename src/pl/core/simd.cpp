@@ -0,0 +1,512 @@
+module;
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   define PL_SIMD_X86 1
+#   include <immintrin.h>
+#else
+#   define PL_SIMD_X86 0
+#endif
+
+module pl.core;
+
+import :simd;
+
+namespace pl::simd_
+{
+namespace
+{
+float sumScalarKernel(float const *p, std::size_t n) noexcept
+{
+    return sumScalar(p, n);
+}
+
+float minScalarKernel(float const *p, std::size_t n) noexcept
+{
+    return minScalar(p, n);
+}
+
+float maxScalarKernel(float const *p, std::size_t n) noexcept
+{
+    return maxScalar(p, n);
+}
+
+float dotScalarKernel(float const *a, float const *b, std::size_t n) noexcept
+{
+    return dotScalar(a, b, n);
+}
+
+void inclusiveScanScalarKernel(float const *from, float *to, std::size_t n) noexcept
+{
+    inclusiveScanScalar(from, to, n);
+}
+
+std::size_t popcountScalarKernel(std::uint64_t const *p, std::size_t n) noexcept
+{
+    return popcountScalar(p, n);
+}
+
+constexpr Kernels scalarKernels = {
+    sumScalarKernel,
+    minScalarKernel,
+    maxScalarKernel,
+    dotScalarKernel,
+    inclusiveScanScalarKernel,
+    popcountScalarKernel,
+};
+
+#if PL_SIMD_X86
+// SSE2
+
+[[gnu::target("sse2")]]
+float horizontalSum(__m128 v) noexcept
+{
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums     = _mm_add_ps(v, shuffled);
+    shuffled        = _mm_movehl_ps(shuffled, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+}
+
+[[gnu::target("sse2")]]
+float horizontalMin(__m128 v) noexcept
+{
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 mins     = _mm_min_ps(v, shuffled);
+    shuffled        = _mm_movehl_ps(shuffled, mins);
+    return _mm_cvtss_f32(_mm_min_ss(mins, shuffled));
+}
+
+[[gnu::target("sse2")]]
+float horizontalMax(__m128 v) noexcept
+{
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 maxs     = _mm_max_ps(v, shuffled);
+    shuffled        = _mm_movehl_ps(shuffled, maxs);
+    return _mm_cvtss_f32(_mm_max_ss(maxs, shuffled));
+}
+
+[[gnu::target("sse2")]]
+float sumSse2(float const *p, std::size_t n) noexcept
+{
+    // Two accumulators hide the latency of the additions.
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(p + i));
+        acc1 = _mm_add_ps(acc1, _mm_loadu_ps(p + i + 4));
+    }
+    if (i + 4 <= n)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(p + i));
+        i += 4;
+    }
+
+    float sum = horizontalSum(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+[[gnu::target("sse2")]]
+float minSse2(float const *p, std::size_t n) noexcept
+{
+    if (n < 4) return minScalar(p, n);
+
+    __m128 min = _mm_loadu_ps(p);
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) min = _mm_min_ps(min, _mm_loadu_ps(p + i));
+
+    float result = horizontalMin(min);
+    for (; i < n; ++i) result = p[i] < result ? p[i] : result;
+    return result;
+}
+
+[[gnu::target("sse2")]]
+float maxSse2(float const *p, std::size_t n) noexcept
+{
+    if (n < 4) return maxScalar(p, n);
+
+    __m128 max = _mm_loadu_ps(p);
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) max = _mm_max_ps(max, _mm_loadu_ps(p + i));
+
+    float result = horizontalMax(max);
+    for (; i < n; ++i) result = result < p[i] ? p[i] : result;
+    return result;
+}
+
+[[gnu::target("sse2")]]
+float dotSse2(float const *a, float const *b, std::size_t n) noexcept
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i),     _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    if (i + 4 <= n)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        i += 4;
+    }
+
+    float sum = horizontalSum(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Scans each vector in log2(4) shifted additions, then adds the running total of the previous vectors.
+[[gnu::target("sse2")]]
+void inclusiveScanSse2(float const *from, float *to, std::size_t n) noexcept
+{
+    __m128 carry = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(from + i);
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+        x = _mm_add_ps(x, carry);
+        _mm_storeu_ps(to + i, x);
+        carry = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    float sum = _mm_cvtss_f32(carry);
+    for (; i < n; ++i) to[i] = sum += from[i];
+}
+
+// SSE2 has neither POPCNT nor a byte shuffle, so bits are counted in parallel within each byte,
+// and the bytes summed with psadbw.
+[[gnu::target("sse2")]]
+std::size_t popcountSse2(std::uint64_t const *p, std::size_t n) noexcept
+{
+    __m128i const m1   = _mm_set1_epi8(0x55);
+    __m128i const m2   = _mm_set1_epi8(0x33);
+    __m128i const m4   = _mm_set1_epi8(0x0f);
+    __m128i       acc  = _mm_setzero_si128();
+    std::size_t   i    = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i));
+        x   = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+        x   = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+        x   = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(x, _mm_setzero_si128()));
+    }
+
+    auto count = static_cast<std::size_t>(
+        _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+    return count + popcountScalar(p + i, n - i);
+}
+
+constexpr Kernels sse2Kernels = {
+    sumSse2,
+    minSse2,
+    maxSse2,
+    dotSse2,
+    inclusiveScanSse2,
+    popcountSse2,
+};
+
+// AVX2
+
+[[gnu::target("avx2,fma")]]
+__m128 fold(__m256 v) noexcept
+{
+    return _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+[[gnu::target("avx2,fma")]]
+float sumAvx2(float const *p, std::size_t n) noexcept
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(p + i));
+        acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(p + i + 8));
+        acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(p + i + 16));
+        acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(p + i + 24));
+    }
+    for (; i + 8 <= n; i += 8) acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(p + i));
+
+    __m256 acc = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+    float sum = horizontalSum(fold(acc));
+    for (; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+[[gnu::target("avx2,fma")]]
+float minAvx2(float const *p, std::size_t n) noexcept
+{
+    if (n < 8) return minSse2(p, n);
+
+    __m256 min = _mm256_loadu_ps(p);
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) min = _mm256_min_ps(min, _mm256_loadu_ps(p + i));
+
+    float result = horizontalMin(_mm_min_ps(_mm256_castps256_ps128(min), _mm256_extractf128_ps(min, 1)));
+    for (; i < n; ++i) result = p[i] < result ? p[i] : result;
+    return result;
+}
+
+[[gnu::target("avx2,fma")]]
+float maxAvx2(float const *p, std::size_t n) noexcept
+{
+    if (n < 8) return maxSse2(p, n);
+
+    __m256 max = _mm256_loadu_ps(p);
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) max = _mm256_max_ps(max, _mm256_loadu_ps(p + i));
+
+    float result = horizontalMax(_mm_max_ps(_mm256_castps256_ps128(max), _mm256_extractf128_ps(max, 1)));
+    for (; i < n; ++i) result = result < p[i] ? p[i] : result;
+    return result;
+}
+
+[[gnu::target("avx2,fma")]]
+float dotAvx2(float const *a, float const *b, std::size_t n) noexcept
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i),      _mm256_loadu_ps(b + i),      acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),  _mm256_loadu_ps(b + i + 8),  acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+    }
+    for (; i + 8 <= n; i += 8) acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+
+    __m256 acc = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+    float sum = horizontalSum(fold(acc));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Scans each 128-bit lane like the SSE2 kernel, then adds the total of the low lane to the high lane.
+[[gnu::target("avx2,fma")]]
+void inclusiveScanAvx2(float const *from, float *to, std::size_t n) noexcept
+{
+    __m256 carry = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(from + i);
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+
+        __m256 laneTotals = _mm256_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+        x = _mm256_add_ps(x, _mm256_permute2f128_ps(laneTotals, laneTotals, 0x08));
+        x = _mm256_add_ps(x, carry);
+        _mm256_storeu_ps(to + i, x);
+
+        carry = _mm256_permute2f128_ps(x, x, 0x11);
+        carry = _mm256_shuffle_ps(carry, carry, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    float sum = _mm256_cvtss_f32(carry);
+    for (; i < n; ++i) to[i] = sum += from[i];
+}
+
+// Looks up the count of each nibble with vpshufb, and sums the bytes with vpsadbw.
+[[gnu::target("avx2,fma")]]
+std::size_t popcountAvx2(std::uint64_t const *p, std::size_t n) noexcept
+{
+    __m256i const lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    __m256i const low = _mm256_set1_epi8(0x0f);
+    __m256i       acc = _mm256_setzero_si256();
+    std::size_t   i   = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i x      = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p + i));
+        __m256i counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low)),
+            _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    __m128i sums  = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    auto    count = static_cast<std::size_t>(
+        _mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+    return count + popcountSse2(p + i, n - i);
+}
+
+constexpr Kernels avx2Kernels = {
+    sumAvx2,
+    minAvx2,
+    maxAvx2,
+    dotAvx2,
+    inclusiveScanAvx2,
+    popcountAvx2,
+};
+
+// AVX-512
+// Tails are handled with masked loads instead of scalar loops.
+
+[[gnu::target("avx512f")]]
+__mmask16 tailMask(std::size_t remaining) noexcept
+{
+    return static_cast<__mmask16>((1u << remaining) - 1);
+}
+
+[[gnu::target("avx512f")]]
+float sumAvx512(float const *p, std::size_t n) noexcept
+{
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(p + i));
+        acc1 = _mm512_add_ps(acc1, _mm512_loadu_ps(p + i + 16));
+    }
+    for (; i + 16 <= n; i += 16) acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(p + i));
+    if (i < n) acc1 = _mm512_add_ps(acc1, _mm512_maskz_loadu_ps(tailMask(n - i), p + i));
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+[[gnu::target("avx512f")]]
+float minAvx512(float const *p, std::size_t n) noexcept
+{
+    if (n < 16) return minAvx2(p, n);
+
+    __m512 min = _mm512_loadu_ps(p);
+    std::size_t i = 16;
+    for (; i + 16 <= n; i += 16) min = _mm512_min_ps(min, _mm512_loadu_ps(p + i));
+    // Lanes past the end keep their current minimum.
+    if (i < n) min = _mm512_min_ps(min, _mm512_mask_loadu_ps(min, tailMask(n - i), p + i));
+
+    return _mm512_reduce_min_ps(min);
+}
+
+[[gnu::target("avx512f")]]
+float maxAvx512(float const *p, std::size_t n) noexcept
+{
+    if (n < 16) return maxAvx2(p, n);
+
+    __m512 max = _mm512_loadu_ps(p);
+    std::size_t i = 16;
+    for (; i + 16 <= n; i += 16) max = _mm512_max_ps(max, _mm512_loadu_ps(p + i));
+    if (i < n) max = _mm512_max_ps(max, _mm512_mask_loadu_ps(max, tailMask(n - i), p + i));
+
+    return _mm512_reduce_max_ps(max);
+}
+
+[[gnu::target("avx512f")]]
+float dotAvx512(float const *a, float const *b, std::size_t n) noexcept
+{
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i),      _mm512_loadu_ps(b + i),      acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= n; i += 16) acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    if (i < n)
+    {
+        __mmask16 mask = tailMask(n - i);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+// The scan is bound by its serial dependency on the carry, so wider vectors do not pay for
+// the extra cross-lane shuffles, and the AVX2 kernel is kept.
+// AVX-512F alone has no byte shuffle nor vector popcount, so popcount also keeps the AVX2 kernel.
+constexpr Kernels avx512Kernels = {
+    sumAvx512,
+    minAvx512,
+    maxAvx512,
+    dotAvx512,
+    inclusiveScanAvx2,
+    popcountAvx2,
+};
+#endif
+
+[[nodiscard]]
+Kernels const &kernelsFor(simd::Isa isa) noexcept
+{
+#if PL_SIMD_X86
+    switch (isa)
+    {
+        case simd::Isa::scalar: return scalarKernels;
+        case simd::Isa::sse2:   return sse2Kernels;
+        case simd::Isa::avx2:   return avx2Kernels;
+        case simd::Isa::avx512: return avx512Kernels;
+        default:                return scalarKernels;
+    }
+#else
+    (void) isa;
+    return scalarKernels;
+#endif
+}
+
+struct Dispatch
+{
+    simd::Isa           isa;
+    Kernels const *kernels;
+};
+
+[[nodiscard]]
+Dispatch &dispatch() noexcept
+{
+    static Dispatch d = [] noexcept
+    {
+        simd::Isa isa = simd::detectIsa();
+        return Dispatch{isa, &kernelsFor(isa)};
+    }();
+    return d;
+}
+} // namespace
+
+Kernels const &kernels() noexcept
+{
+    return *dispatch().kernels;
+}
+} // namespace pl::simd_
+
+namespace pl::simd
+{
+Isa detectIsa() noexcept
+{
+#if PL_SIMD_X86
+    __builtin_cpu_init();
+    bool const avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (avx2 && __builtin_cpu_supports("avx512f")) return Isa::avx512;
+    if (avx2)                                       return Isa::avx2;
+    if (__builtin_cpu_supports("sse2"))             return Isa::sse2;
+#endif
+    return Isa::scalar;
+}
+
+Isa activeIsa() noexcept
+{
+    return simd_::dispatch().isa;
+}
+
+Isa setIsa(Isa isa) noexcept
+{
+    Isa const detected = detectIsa();
+    if (detected < isa) isa = detected;
+
+    simd_::dispatch() = {isa, &simd_::kernelsFor(isa)};
+    return isa;
+}
+} // namespace pl::simd
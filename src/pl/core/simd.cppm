@@ -0,0 +1,345 @@
+module;
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:simd;
+
+import :span;
+import :tags;
+
+export namespace pl::simd
+{
+// Instruction sets that the float kernels are compiled for, from slowest to fastest.
+enum class Isa : std::uint8_t
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512,
+};
+
+// The fastest instruction set supported by this CPU.
+[[nodiscard]] Isa detectIsa() noexcept;
+
+// The instruction set that the kernels dispatch to, detectIsa() until setIsa is called.
+[[nodiscard]] Isa activeIsa() noexcept;
+
+// Makes the kernels dispatch to isa, or to the fastest supported instruction set below it,
+// and returns the one picked. Meant for tests and benchmarks, must not race with running kernels.
+Isa setIsa(Isa isa) noexcept;
+} // export namespace pl::simd
+
+namespace pl::simd_
+{
+template<class T>
+concept arithmetic = std::integral<T> || std::floating_point<T>;
+
+// Spans with a static extent up to this many elements are unrolled at compile time.
+constexpr std::size_t unrollLimit = 16;
+
+template<std::size_t Extent>
+constexpr bool unrolled = Extent != tags::dynamic_extent && Extent <= unrollLimit;
+
+// Only float has arithmetic vector kernels, other types rely on the compiler to vectorize the scalar loops.
+template<class T>
+constexpr bool hasKernels = std::is_same_v<T, float>;
+
+struct Kernels
+{
+    float       (*sum)          (float const *, std::size_t) noexcept;
+    float       (*min)          (float const *, std::size_t) noexcept;
+    float       (*max)          (float const *, std::size_t) noexcept;
+    float       (*dot)          (float const *, float const *, std::size_t) noexcept;
+    void        (*inclusiveScan)(float const *, float *, std::size_t) noexcept;
+    std::size_t (*popcount)     (std::uint64_t const *, std::size_t) noexcept;
+};
+
+[[nodiscard]] Kernels const &kernels() noexcept;
+
+template<class T>
+[[nodiscard]]
+constexpr T sumScalar(T const *p, std::size_t n) noexcept
+{
+    T sum = T();
+    for (std::size_t i = 0; i < n; ++i) sum += p[i];
+    return sum;
+}
+
+template<class T>
+[[nodiscard]]
+constexpr T minScalar(T const *p, std::size_t n) noexcept
+{
+    T min = p[0];
+    for (std::size_t i = 1; i < n; ++i) min = p[i] < min ? p[i] : min;
+    return min;
+}
+
+template<class T>
+[[nodiscard]]
+constexpr T maxScalar(T const *p, std::size_t n) noexcept
+{
+    T max = p[0];
+    for (std::size_t i = 1; i < n; ++i) max = max < p[i] ? p[i] : max;
+    return max;
+}
+
+template<class T>
+[[nodiscard]]
+constexpr T dotScalar(T const *a, T const *b, std::size_t n) noexcept
+{
+    T sum = T();
+    for (std::size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+template<class T>
+constexpr void inclusiveScanScalar(T const *from, T *to, std::size_t n) noexcept
+{
+    T sum = T();
+    for (std::size_t i = 0; i < n; ++i) to[i] = sum += from[i];
+}
+
+[[nodiscard]]
+constexpr std::size_t popcountScalar(std::uint64_t const *p, std::size_t n) noexcept
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) count += static_cast<std::size_t>(std::popcount(p[i]));
+    return count;
+}
+
+// Calls f(std::integral_constant<std::size_t, I>()) for every I in [0, N).
+template<std::size_t N, class F>
+constexpr void unroll(F &&f)
+{
+    [&]<std::size_t ...I>(std::index_sequence<I...>)
+    {
+        (f(std::integral_constant<std::size_t, I>()), ...);
+    }(std::make_index_sequence<N>());
+}
+} // namespace pl::simd_
+
+export namespace pl::simd
+{
+// Bulk algorithms over contiguous spans.
+//
+// At runtime, sum, min, max, dot and inclusive_scan over float, and popcount, dispatch to SSE2, AVX2 or AVX-512 kernels,
+// picked once from the instruction sets the CPU supports. Every algorithm also has a scalar path
+// that is used in constant evaluation, for other element types, and for short spans with a static extent,
+// which are unrolled at compile time instead.
+//
+// The vector kernels reorder floating-point additions, so their results can differ in the last bits
+// from the scalar path and between instruction sets. min and max are unspecified if the span contains a NaN.
+
+template<class T, std::size_t E>
+constexpr void fill(Span<T, E> to, std::type_identity_t<T> const &value) noexcept
+{
+    if constexpr (simd_::unrolled<E>)
+        simd_::unroll<E>([&](auto i) { to.data()[i] = value; });
+    else
+        for (T &x : to) x = value;
+}
+
+// to must be at least as long as from.
+template<class T, std::size_t E, class U, std::size_t F>
+requires std::is_assignable_v<U &, T const &>
+constexpr void copy(Span<T, E> from, Span<U, F> to) noexcept
+{
+    PL_ASSERT(from.size() <= to.size());
+    if constexpr (simd_::unrolled<E>)
+        simd_::unroll<E>([&](auto i) { to.data()[i] = from.data()[i]; });
+    else
+    {
+        if !consteval
+        {
+            if constexpr (std::is_same_v<std::remove_const_t<T>, U> && std::is_trivially_copyable_v<U>)
+            {
+                // The C library already picks the fastest copy for the CPU.
+                if (!from.empty()) std::memmove(to.data(), from.data(), from.size() * sizeof(U));
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < from.size(); ++i) to.data()[i] = from.data()[i];
+    }
+}
+
+// to must be at least as long as from, and may be from itself.
+template<class T, std::size_t E, class U, std::size_t F, class Fn>
+requires std::is_invocable_v<Fn &, T &> && std::is_assignable_v<U &, std::invoke_result_t<Fn &, T &>>
+constexpr void transform(Span<T, E> from, Span<U, F> to, Fn f)
+{
+    PL_ASSERT(from.size() <= to.size());
+    if constexpr (simd_::unrolled<E>)
+        simd_::unroll<E>([&](auto i) { to.data()[i] = f(from.data()[i]); });
+    else
+        for (std::size_t i = 0; i < from.size(); ++i) to.data()[i] = f(from.data()[i]);
+}
+
+// to must be at least as long as a, b must be as long as a, and to may be either of them.
+template<class T, std::size_t E, class U, std::size_t F, class V, std::size_t G, class Fn>
+requires
+    std::is_invocable_v<Fn &, T &, U &>
+ && std::is_assignable_v<V &, std::invoke_result_t<Fn &, T &, U &>>
+constexpr void transform(Span<T, E> a, Span<U, F> b, Span<V, G> to, Fn f)
+{
+    PL_ASSERT(a.size() == b.size() && a.size() <= to.size());
+    if constexpr (simd_::unrolled<E>)
+        simd_::unroll<E>([&](auto i) { to.data()[i] = f(a.data()[i], b.data()[i]); });
+    else
+        for (std::size_t i = 0; i < a.size(); ++i) to.data()[i] = f(a.data()[i], b.data()[i]);
+}
+
+// Folds from into init from left to right.
+template<class T, std::size_t E, class Acc, class Op = std::plus<>>
+requires std::is_assignable_v<Acc &, std::invoke_result_t<Op &, Acc &, T &>>
+[[nodiscard]]
+constexpr Acc reduce(Span<T, E> from, Acc init, Op op = {})
+{
+    if constexpr (simd_::unrolled<E>)
+        simd_::unroll<E>([&](auto i) { init = op(init, from.data()[i]); });
+    else
+        for (T &x : from) init = op(init, x);
+    return init;
+}
+
+template<class T, std::size_t E>
+requires simd_::arithmetic<std::remove_const_t<T>>
+[[nodiscard]]
+constexpr std::remove_const_t<T> sum(Span<T, E> from) noexcept
+{
+    using U = std::remove_const_t<T>;
+    if constexpr (simd_::unrolled<E>)
+        return [&]<std::size_t ...I>(std::index_sequence<I...>)
+        {
+            return static_cast<U>((U() + ... + from.data()[I]));
+        }(std::make_index_sequence<E>());
+    else
+    {
+        if !consteval
+        {
+            if constexpr (simd_::hasKernels<U>)
+                return simd_::kernels().sum(from.data(), from.size());
+        }
+        return simd_::sumScalar<U>(from.data(), from.size());
+    }
+}
+
+// from must not be empty.
+template<class T, std::size_t E>
+requires simd_::arithmetic<std::remove_const_t<T>>
+[[nodiscard]]
+constexpr std::remove_const_t<T> min(Span<T, E> from) noexcept
+{
+    using U = std::remove_const_t<T>;
+    PL_ASSERT(!from.empty());
+    if constexpr (!simd_::unrolled<E>)
+    {
+        if !consteval
+        {
+            if constexpr (simd_::hasKernels<U>)
+                return simd_::kernels().min(from.data(), from.size());
+        }
+    }
+    return simd_::minScalar<U>(from.data(), from.size());
+}
+
+// from must not be empty.
+template<class T, std::size_t E>
+requires simd_::arithmetic<std::remove_const_t<T>>
+[[nodiscard]]
+constexpr std::remove_const_t<T> max(Span<T, E> from) noexcept
+{
+    using U = std::remove_const_t<T>;
+    PL_ASSERT(!from.empty());
+    if constexpr (!simd_::unrolled<E>)
+    {
+        if !consteval
+        {
+            if constexpr (simd_::hasKernels<U>)
+                return simd_::kernels().max(from.data(), from.size());
+        }
+    }
+    return simd_::maxScalar<U>(from.data(), from.size());
+}
+
+// a and b must have the same size.
+template<class T, std::size_t E, class U, std::size_t F>
+requires
+    simd_::arithmetic<std::remove_const_t<T>>
+ && std::is_same_v<std::remove_const_t<T>, std::remove_const_t<U>>
+[[nodiscard]]
+constexpr std::remove_const_t<T> dot(Span<T, E> a, Span<U, F> b) noexcept
+{
+    using V = std::remove_const_t<T>;
+    PL_ASSERT(a.size() == b.size());
+    if constexpr (simd_::unrolled<E>)
+        return [&]<std::size_t ...I>(std::index_sequence<I...>)
+        {
+            return static_cast<V>((V() + ... + (a.data()[I] * b.data()[I])));
+        }(std::make_index_sequence<E>());
+    else
+    {
+        if !consteval
+        {
+            if constexpr (simd_::hasKernels<V>)
+                return simd_::kernels().dot(a.data(), b.data(), a.size());
+        }
+        return simd_::dotScalar<V>(a.data(), b.data(), a.size());
+    }
+}
+
+// Number of set bits in words.
+template<class T, std::size_t E>
+requires std::is_same_v<std::remove_const_t<T>, std::uint64_t>
+[[nodiscard]]
+constexpr std::size_t popcount(Span<T, E> words) noexcept
+{
+    if constexpr (simd_::unrolled<E>)
+        return [&]<std::size_t ...I>(std::index_sequence<I...>)
+        {
+            return (std::size_t() + ... + static_cast<std::size_t>(std::popcount(words.data()[I])));
+        }(std::make_index_sequence<E>());
+    else
+    {
+        if !consteval
+        {
+            return simd_::kernels().popcount(words.data(), words.size());
+        }
+        return simd_::popcountScalar(words.data(), words.size());
+    }
+}
+
+// Writes the running sums of from to to.
+// to must be at least as long as from, and may be from itself, but must not otherwise overlap it.
+template<class T, std::size_t E, std::size_t F>
+requires simd_::arithmetic<std::remove_const_t<T>>
+constexpr void inclusive_scan(Span<T, E> from, Span<std::remove_const_t<T>, F> to) noexcept
+{
+    using U = std::remove_const_t<T>;
+    PL_ASSERT(from.size() <= to.size());
+    if constexpr (simd_::unrolled<E>)
+    {
+        U sum = U();
+        simd_::unroll<E>([&](auto i) { to.data()[i] = sum += from.data()[i]; });
+    }
+    else
+    {
+        if !consteval
+        {
+            if constexpr (simd_::hasKernels<U>)
+            {
+                simd_::kernels().inclusiveScan(from.data(), to.data(), from.size());
+                return;
+            }
+        }
+        simd_::inclusiveScanScalar<U>(from.data(), to.data(), from.size());
+    }
+}
+} // export namespace pl::simd
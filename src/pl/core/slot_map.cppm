@@ -0,0 +1,344 @@
+module;
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:slot_map;
+
+import :array_list;
+import :error;
+import :handle;
+import :memory;
+import :null;
+import :optional;
+import :result_error;
+import :span;
+
+export namespace pl
+{
+class StaleHandle : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "StaleHandle";
+    }
+};
+
+class SlotMapFull : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "SlotMapFull";
+    }
+};
+
+template<class T, allocator A, std::unsigned_integral Bits>
+requires (sizeof(Bits) == 4 || sizeof(Bits) == 8)
+class SlotMap;
+
+// Generation-checked handle to a value in a SlotMap<T>.
+// Half of Bits holds the slot index and the other half the slot generation,
+// so a handle is 32 or 64 bits wide. A default-constructed handle is null, and is never live.
+template<class T, std::unsigned_integral Bits = std::uint64_t>
+requires (sizeof(Bits) == 4 || sizeof(Bits) == 8)
+class SlotHandle
+{
+public:
+    using index_type      = std::conditional_t<sizeof(Bits) == 8, std::uint32_t, std::uint16_t>;
+    using generation_type = index_type;
+
+    [[nodiscard]] SlotHandle() = default;
+
+    [[nodiscard]] constexpr index_type      index()      const noexcept { return _index;      }
+    [[nodiscard]] constexpr generation_type generation() const noexcept { return _generation; }
+    [[nodiscard]] constexpr bool            is_null()    const noexcept { return _generation == 0; }
+
+    [[nodiscard]] friend constexpr bool operator==(SlotHandle, SlotHandle) noexcept = default;
+
+private:
+    template<class U, allocator A, std::unsigned_integral B>
+    requires (sizeof(B) == 4 || sizeof(B) == 8)
+    friend class SlotMap;
+
+    [[nodiscard]] constexpr SlotHandle(index_type index, generation_type generation) noexcept
+    : _index(index), _generation(generation) {}
+
+    index_type      _index      = 0;
+    generation_type _generation = 0;
+};
+
+// Stable handles to densely stored values, with O(1) insert, erase and lookup.
+//
+// Values live contiguously in insertion order, except that erase moves the last value into the hole,
+// so iterating over values() touches live values only. Each handle refers to a slot, which
+// in turn records where its value currently lives. A slot's generation is bumped every time its
+// value is erased, so handles to erased values are detected rather than aliasing newer values.
+// A slot whose generation would wrap around is retired instead of being reused.
+//
+// unique_handle erases its value on destruction. It refers back to the map,
+// so the map must neither move nor be destroyed while unique handles to it exist.
+template<class T, allocator A = default_allocator_t<T>, std::unsigned_integral Bits = std::uint64_t>
+requires (sizeof(Bits) == 4 || sizeof(Bits) == 8)
+class SlotMap
+{
+public:
+    using value_type      = T;
+    using allocator_type  = A;
+    using size_type       = std::size_t;
+    using handle_type     = SlotHandle<T, Bits>;
+    using index_type      = handle_type::index_type;
+    using generation_type = handle_type::generation_type;
+    using iterator        = ArrayList<T, A>::iterator;
+    using const_iterator  = ArrayList<T, A>::const_iterator;
+
+    class deleter_type
+    {
+    public:
+        [[nodiscard]] explicit constexpr deleter_type(SlotMap &map) noexcept : _map(&map) {}
+
+        constexpr void operator()(handle_type handle) const noexcept
+        {
+            (void) _map->erase(handle);
+        }
+    private:
+        SlotMap *_map;
+    };
+
+    using unique_handle = UHandle<handle_type, deleter_type>;
+
+    // One index is reserved to terminate the free list.
+    static constexpr size_type max_size = std::numeric_limits<index_type>::max();
+
+    [[nodiscard]] SlotMap() = default;
+
+    [[nodiscard]] explicit constexpr SlotMap(allocator_type const &a) noexcept
+    : _values(a), _denseToSlot(a), _slots(a) {}
+
+    [[nodiscard]] constexpr SlotMap(SlotMap &&other) noexcept
+    :
+        _values     (std::move(other._values)),
+        _denseToSlot(std::move(other._denseToSlot)),
+        _slots      (std::move(other._slots)),
+        _freeHead   (std::exchange(other._freeHead, npos))
+    {}
+
+    constexpr SlotMap &operator=(SlotMap &&other) noexcept
+    {
+        SlotMap(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _values.get_allocator();
+    }
+
+    [[nodiscard]] constexpr bool contains(handle_type handle) const noexcept
+    {
+        return
+            !handle.is_null()
+         && handle._index < _slots.size()
+         && _slots[handle._index].generation == handle._generation;
+    }
+
+    [[nodiscard]] constexpr Opt<Ptr<T>> get(handle_type handle) noexcept
+    {
+        if (!contains(handle)) return {};
+        return makeNonNull_Unchecked(&_values[_slots[handle._index].dense]);
+    }
+
+    [[nodiscard]] constexpr Opt<Ptr<T const>> get(handle_type handle) const noexcept
+    {
+        if (!contains(handle)) return {};
+        return makeNonNull_Unchecked(&_values[_slots[handle._index].dense]);
+    }
+
+    [[nodiscard]] constexpr T &operator[](handle_type handle) noexcept
+    {
+        PL_ASSERT(contains(handle));
+        return _values[_slots[handle._index].dense];
+    }
+
+    [[nodiscard]] constexpr T const &operator[](handle_type handle) const noexcept
+    {
+        PL_ASSERT(contains(handle));
+        return _values[_slots[handle._index].dense];
+    }
+
+    // Handle of the value at position idx of values().
+    [[nodiscard]] constexpr handle_type handle_at(size_type idx) const noexcept
+    {
+        PL_ASSERT(idx < size());
+        index_type slot = _denseToSlot[idx];
+        return {slot, _slots[slot].generation};
+    }
+
+    [[nodiscard]] constexpr Span<T> values() noexcept
+    {
+        return {_values.data(), _values.size()};
+    }
+
+    [[nodiscard]] constexpr Span<T const> values() const noexcept
+    {
+        return {_values.data(), _values.size()};
+    }
+
+    [[nodiscard]] constexpr iterator       begin()        noexcept { return _values.begin();  }
+    [[nodiscard]] constexpr const_iterator begin()  const noexcept { return _values.begin();  }
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return _values.cbegin(); }
+    [[nodiscard]] constexpr iterator       end()          noexcept { return _values.end();    }
+    [[nodiscard]] constexpr const_iterator end()    const noexcept { return _values.end();    }
+    [[nodiscard]] constexpr const_iterator cend()   const noexcept { return _values.cend();   }
+
+    [[nodiscard]] constexpr bool      empty() const noexcept { return _values.empty(); }
+    [[nodiscard]] constexpr size_type size()  const noexcept { return _values.size();  }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> reserve(size_type num_beyond_size)
+    {
+        PL_TRY_DISCARD(_values.reserve(num_beyond_size));
+        PL_TRY_DISCARD(_denseToSlot.reserve(num_beyond_size));
+        return _slots.reserve_capacity(size() + num_beyond_size);
+    }
+
+    // Erases every value. Every handle handed out so far becomes stale, but slots are kept for reuse.
+    constexpr void clear() noexcept
+    {
+        for (index_type slot : _denseToSlot) free_slot(slot);
+        _values.clear();
+        _denseToSlot.clear();
+    }
+
+    template<class ...Args>
+    [[nodiscard]]
+    constexpr RE<handle_type, SimpleError> emplace(Args &&...args)
+    noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    requires std::is_constructible_v<T, Args...>
+    {
+        PL_TRY_DISCARD(_values.reserve(1));
+        PL_TRY_DISCARD(_denseToSlot.reserve(1));
+
+        index_type slot = _freeHead;
+        if (slot == npos)
+        {
+            if (_slots.size() == max_size)
+                return {tags::error, getSingleton<SlotMapFull>()};
+
+            PL_TRY_DISCARD(_slots.push_back({npos, 1}));
+            slot = index_type(_slots.size() - 1);
+        }
+        else
+        {
+            _freeHead = _slots[slot].dense;
+        }
+
+        // Cannot fail, as both lists have reserved room for one more.
+        (void) _values.emplace_back(std::forward<Args>(args)...);
+        (void) _denseToSlot.push_back(slot);
+        _slots[slot].dense = index_type(_values.size() - 1);
+        return handle_type(slot, _slots[slot].generation);
+    }
+
+    [[nodiscard]] constexpr RE<handle_type, SimpleError> insert(T const &value)
+    noexcept(std::is_nothrow_copy_constructible_v<T>)
+    requires std::is_copy_constructible_v<T>
+    {
+        return emplace(value);
+    }
+
+    [[nodiscard]] constexpr RE<handle_type, SimpleError> insert(T &&value)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    requires std::is_move_constructible_v<T>
+    {
+        return emplace(std::move(value));
+    }
+
+    // Like emplace, but the value is erased once the returned handle is destroyed.
+    template<class ...Args>
+    [[nodiscard]]
+    constexpr RE<unique_handle, SimpleError> emplace_unique(Args &&...args)
+    noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    requires std::is_constructible_v<T, Args...>
+    {
+        PL_TRY_ASSIGN(handle_type handle, emplace(std::forward<Args>(args)...));
+        return unique_handle(std::move(handle), deleter_type(*this));
+    }
+
+    constexpr RE<void, SimpleError> erase(handle_type handle) noexcept
+    {
+        if (!contains(handle))
+            return {tags::error, getSingleton<StaleHandle>()};
+
+        index_type dense = _slots[handle._index].dense;
+        index_type last  = index_type(_values.size() - 1);
+        if (dense != last)
+        {
+            _values[dense] = std::move(_values[last]);
+            _denseToSlot[dense] = _denseToSlot[last];
+            _slots[_denseToSlot[dense]].dense = dense;
+        }
+        _values.pop_back();
+        _denseToSlot.pop_back();
+        free_slot(handle._index);
+        return {};
+    }
+
+    constexpr void swap(SlotMap &other) noexcept
+    {
+        using std::swap;
+        _values     .swap(other._values     );
+        _denseToSlot.swap(other._denseToSlot);
+        _slots      .swap(other._slots      );
+        swap(_freeHead, other._freeHead);
+    }
+
+    friend constexpr void swap(SlotMap &a, SlotMap &b) noexcept
+    {
+        a.swap(b);
+    }
+
+private:
+    static constexpr index_type npos = std::numeric_limits<index_type>::max();
+
+    struct Slot
+    {
+        // Position of the value in _values while the slot is live, next free slot otherwise.
+        index_type      dense;
+        generation_type generation;
+    };
+
+    constexpr void free_slot(index_type slot) noexcept
+    {
+        if (++_slots[slot].generation == 0) return; // retired
+
+        _slots[slot].dense = _freeHead;
+        _freeHead = slot;
+    }
+
+    ArrayList<T,          A> _values;
+    ArrayList<index_type, A> _denseToSlot;
+    ArrayList<Slot,       A> _slots;
+    index_type               _freeHead = npos;
+};
+
+template<class T, allocator A, std::unsigned_integral Bits>
+struct is_trivially_relocatable<SlotMap<T, A, Bits>> : is_trivially_relocatable<A> {};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(sizeof(SlotHandle<int, std::uint32_t>) == 4);
+static_assert(sizeof(SlotHandle<int, std::uint64_t>) == 8);
+} // namespace pl
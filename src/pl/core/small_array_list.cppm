@@ -0,0 +1,264 @@
+module;
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:small_array_list;
+
+import :array_list;
+import :error;
+import :iterator;
+import :memory;
+import :null;
+import :result_error;
+import :span;
+
+export namespace pl
+{
+// ArrayList that keeps up to N elements inline, and only spills to the allocator once it outgrows them.
+// Meant for the many lists that hold a handful of elements, so that they never allocate.
+//
+// The inline storage is only used at runtime. During constant evaluation every element lives in
+// allocated storage, as the elements of an uninitialized byte buffer cannot be constructed there.
+template<class T, std::size_t N, allocator A = default_allocator_t<T>>
+requires (N != 0)
+class SmallArrayList : public array_list_::ListBase<SmallArrayList<T, N, A>, T, A>
+{
+private:
+    using Base = array_list_::ListBase<SmallArrayList<T, N, A>, T, A>;
+    friend Base;
+
+public:
+    using typename Base::value_type;
+    using typename Base::allocator_type;
+    using typename Base::size_type;
+    using typename Base::difference_type;
+    using typename Base::reference;
+    using typename Base::const_reference;
+    using typename Base::pointer;
+    using typename Base::const_pointer;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using typename Base::reverse_iterator;
+    using typename Base::const_reverse_iterator;
+
+    static constexpr size_type inline_capacity = N;
+
+    [[nodiscard]] SmallArrayList() = default;
+
+    [[nodiscard]] explicit constexpr SmallArrayList(allocator_type const &a) noexcept
+    : _allocator(a) {}
+
+    [[nodiscard]] constexpr SmallArrayList(SmallArrayList &&other)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    :
+        _allocator(other._allocator)
+    {
+        take(other);
+    }
+
+    constexpr SmallArrayList &operator=(SmallArrayList &&other)
+    noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_copy_assignable_v<A>)
+    {
+        if (this == &other) return *this;
+        release();
+        _allocator = other._allocator;
+        take(other);
+        return *this;
+    }
+
+    constexpr ~SmallArrayList()
+    {
+        release();
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _allocator;
+    }
+
+    // Whether the elements currently live in the inline storage.
+    [[nodiscard]] constexpr bool is_inline() const noexcept
+    {
+        if consteval
+        {
+            return false;
+        }
+        else
+        {
+            return _begin == inline_data();
+        }
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    // Moves the elements back into the inline storage if they fit.
+    [[nodiscard]] constexpr RE<void, SimpleError> shrink_to_fit()
+    {
+        return reallocate(this->size());
+    }
+
+    constexpr void swap(SmallArrayList &other)
+    noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_copy_assignable_v<A>)
+    {
+        // Inline elements cannot be exchanged by swapping pointers.
+        SmallArrayList tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    [[nodiscard]] constexpr T *list_begin() const noexcept
+    {
+        return _begin;
+    }
+
+    [[nodiscard]] constexpr T *&list_end() noexcept
+    {
+        return _end;
+    }
+
+    [[nodiscard]] constexpr T *inline_data() const noexcept
+    {
+        if consteval
+        {
+            return nullptr;
+        }
+        else
+        {
+            return const_cast<T *>(reinterpret_cast<T const *>(_inline));
+        }
+    }
+
+    [[nodiscard]] static constexpr size_type initial_capacity() noexcept
+    {
+        if consteval
+        {
+            return 0;
+        }
+        else
+        {
+            return N;
+        }
+    }
+
+    // Moves the elements in [first, last) to dest, and ends the lifetime of the originals.
+    static constexpr void relocate(T *first, T *last, T *dest)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if consteval
+        {
+            for (; first != last; ++first, ++dest)
+            {
+                std::construct_at(dest, std::move(*first));
+                std::destroy_at(first);
+            }
+        }
+        else
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if (first != last)
+                    std::memcpy(static_cast<void *>(dest), first, sizeof(T) * size_type(last - first));
+            }
+            else
+            {
+                std::uninitialized_move(first, last, dest);
+                std::destroy(first, last);
+            }
+        }
+    }
+
+    // Destroys the elements and frees the allocated storage, if any.
+    constexpr void release() noexcept
+    {
+        std::ranges::destroy(_begin, _end);
+        if (!is_inline()) free(_allocator, Span<T>(_begin, _capacity));
+        _begin    = inline_data();
+        _end      = _begin;
+        _capacity = initial_capacity();
+    }
+
+    // Takes the elements of other, which must be released beforehand, and leaves other empty.
+    constexpr void take(SmallArrayList &other)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (other.is_inline())
+        {
+            relocate(other._begin, other._end, _begin);
+            _end = _begin + other.size();
+            other._end = other._begin;
+        }
+        else
+        {
+            _begin    = std::exchange(other._begin,    other.inline_data());
+            _end      = std::exchange(other._end,      other._begin);
+            _capacity = std::exchange(other._capacity, initial_capacity());
+        }
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> reallocate(size_type const new_capacity)
+    {
+        namespace rng = std::ranges;
+
+        const size_type new_size = std::min(this->size(), new_capacity);
+        rng::destroy(_begin + new_size, _end);
+        _end = _begin + new_size;
+
+        if !consteval
+        {
+            if (new_capacity <= N)
+            {
+                if (!is_inline())
+                {
+                    Span<T> old_arr(_begin, _capacity);
+                    relocate(_begin, _end, inline_data());
+                    free(_allocator, old_arr);
+                    _begin    = inline_data();
+                    _end      = _begin + new_size;
+                    _capacity = N;
+                }
+                return {};
+            }
+
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if (!is_inline())
+                {
+                    PL_TRY_ASSIGN(Span<T> new_arr, realloc<T>(_allocator, Span<T>(_begin, _capacity), new_capacity, new_size));
+                    _begin    = new_arr.data();
+                    _end      = _begin + new_size;
+                    _capacity = new_capacity;
+                    return {};
+                }
+            }
+        }
+
+        RE<Span<T>, SimpleError> alloc_result = alloc<T>(_allocator, new_capacity);
+        if (!alloc_result) return {tags::error, std::move(alloc_result).error()};
+        Span<T> &new_arr = *alloc_result;
+        relocate(_begin, _end, new_arr.data());
+        if (!is_inline()) free(_allocator, Span<T>(_begin, _capacity));
+        _begin    = new_arr.data();
+        _end      = _begin + new_size;
+        _capacity = new_capacity;
+        return {};
+    }
+
+    T        *_begin    = inline_data();
+    T        *_end      = _begin;
+    size_type _capacity = initial_capacity();
+    [[no_unique_address]] A _allocator = {};
+    alignas(T) std::byte _inline[sizeof(T) * N];
+};
+} // export namespace pl
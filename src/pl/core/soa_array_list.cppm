@@ -0,0 +1,498 @@
+module;
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:soa_array_list;
+
+import :error;
+import :memory;
+import :null;
+import :result_error;
+import :span;
+
+namespace pl
+{
+// Iterates over the rows of a BasicSoAArrayList, dereferencing to a tuple of references
+// to the row's element in every column, which can be unpacked with structured bindings.
+template<class ...Us>
+class SoARowIterator
+{
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using difference_type  = std::ptrdiff_t;
+    using value_type       = std::tuple<std::remove_const_t<Us>...>;
+    using reference        = std::tuple<Us &...>;
+
+    SoARowIterator           ()                       = default;
+    SoARowIterator           (SoARowIterator const &) = default;
+    SoARowIterator &operator=(SoARowIterator const &) = default;
+
+    constexpr SoARowIterator(std::tuple<Us *...> columns, difference_type index) noexcept
+    :
+        _columns(columns),
+        _index(index)
+    {}
+
+    // Mutable to const conversion.
+    template<class ...Vs>
+    requires (!std::is_same_v<std::tuple<Vs...>, std::tuple<Us...>>)
+    constexpr SoARowIterator(SoARowIterator<Vs...> const &other) noexcept
+    :
+        _columns(other._columns),
+        _index(other._index)
+    {}
+
+    constexpr SoARowIterator &operator++() noexcept
+    {
+        ++_index;
+        return *this;
+    }
+
+    constexpr SoARowIterator operator++(int) noexcept
+    {
+        auto copy = *this;
+        ++_index;
+        return copy;
+    }
+
+    constexpr SoARowIterator &operator--() noexcept
+    {
+        --_index;
+        return *this;
+    }
+
+    constexpr SoARowIterator operator--(int) noexcept
+    {
+        auto copy = *this;
+        --_index;
+        return copy;
+    }
+
+    constexpr SoARowIterator &operator+=(difference_type d) noexcept
+    {
+        _index += d;
+        return *this;
+    }
+
+    constexpr SoARowIterator &operator-=(difference_type d) noexcept
+    {
+        _index -= d;
+        return *this;
+    }
+
+    friend constexpr SoARowIterator operator+(SoARowIterator i, difference_type d) noexcept
+    {
+        i._index += d;
+        return i;
+    }
+
+    friend constexpr SoARowIterator operator+(difference_type d, SoARowIterator i) noexcept
+    {
+        i._index += d;
+        return i;
+    }
+
+    friend constexpr SoARowIterator operator-(SoARowIterator i, difference_type d) noexcept
+    {
+        i._index -= d;
+        return i;
+    }
+
+    friend constexpr difference_type operator-(SoARowIterator a, SoARowIterator b) noexcept
+    {
+        PL_ASSERT(a._columns == b._columns);
+        return a._index - b._index;
+    }
+
+    constexpr reference operator*() const noexcept
+    {
+        return (*this)[0];
+    }
+
+    constexpr reference operator[](difference_type d) const noexcept
+    {
+        return std::apply([&](Us *...columns) { return reference(columns[_index + d]...); }, _columns);
+    }
+
+    constexpr bool operator==(SoARowIterator const &other) const noexcept
+    {
+        PL_ASSERT(_columns == other._columns);
+        return _index == other._index;
+    }
+
+    constexpr auto operator<=>(SoARowIterator const &other) const noexcept
+    {
+        PL_ASSERT(_columns == other._columns);
+        return _index <=> other._index;
+    }
+
+private:
+    template<class ...Vs>
+    friend class SoARowIterator;
+
+    std::tuple<Us *...> _columns = {};
+    difference_type     _index   = 0;
+};
+} // namespace pl
+
+export namespace pl
+{
+// Structure of arrays counterpart of ArrayList.
+// Each of Ts is stored in its own contiguous column, so that loops touching only a few fields
+// of every row only pull those fields into cache, and can be vectorized.
+//
+// All columns live in a single allocation and grow together. Each column starts at a multiple of
+// column_alignment, so it never shares a cache line with the previous one.
+// During constant evaluation, columns are allocated separately instead.
+template<allocator A, class ...Ts>
+requires (sizeof...(Ts) != 0 && ((sizeof(Ts) != 0) && ...))
+class BasicSoAArrayList
+{
+public:
+    using allocator_type  = A;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_type      = std::tuple<Ts...>;
+    using reference       = std::tuple<Ts       &...>;
+    using const_reference = std::tuple<Ts const &...>;
+    using iterator        = SoARowIterator<Ts      ...>;
+    using const_iterator  = SoARowIterator<Ts const...>;
+
+    template<std::size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_type num_columns      = sizeof...(Ts);
+    static constexpr size_type column_alignment = std::max({cacheLineSize, alignof(Ts)...});
+
+    [[nodiscard]] BasicSoAArrayList() = default;
+
+    [[nodiscard]] explicit constexpr BasicSoAArrayList(allocator_type const &a) noexcept
+    : _allocator(a) {}
+
+    [[nodiscard]] constexpr BasicSoAArrayList(BasicSoAArrayList &&other) noexcept
+    :
+        _columns(std::exchange(other._columns, {})),
+        _size(std::exchange(other._size, 0)),
+        _capacity(std::exchange(other._capacity, 0)),
+        _allocator(other._allocator)
+    {}
+
+    constexpr BasicSoAArrayList &operator=(BasicSoAArrayList &&other)
+    noexcept(std::is_nothrow_copy_assignable_v<A>)
+    {
+        if (this == &other) return *this;
+        clear();
+        deallocate();
+        _columns   = std::exchange(other._columns, {});
+        _size      = std::exchange(other._size, 0);
+        _capacity  = std::exchange(other._capacity, 0);
+        _allocator = other._allocator;
+        return *this;
+    }
+
+    constexpr ~BasicSoAArrayList()
+    {
+        clear();
+        deallocate();
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _allocator;
+    }
+
+    template<std::size_t I>
+    [[nodiscard]] constexpr Span<column_type<I>> column() noexcept
+    {
+        return {std::get<I>(_columns), _size};
+    }
+
+    template<std::size_t I>
+    [[nodiscard]] constexpr Span<column_type<I> const> column() const noexcept
+    {
+        return {std::get<I>(_columns), _size};
+    }
+
+    [[nodiscard]] constexpr reference operator[](size_type idx) noexcept
+    {
+        PL_ASSERT(idx < size());
+        return begin()[difference_type(idx)];
+    }
+
+    [[nodiscard]] constexpr const_reference operator[](size_type idx) const noexcept
+    {
+        PL_ASSERT(idx < size());
+        return begin()[difference_type(idx)];
+    }
+
+    [[nodiscard]] constexpr iterator begin() noexcept
+    {
+        return {_columns, 0};
+    }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept
+    {
+        return {_columns, 0};
+    }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    [[nodiscard]] constexpr iterator end() noexcept
+    {
+        return {_columns, difference_type(_size)};
+    }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept
+    {
+        return {_columns, difference_type(_size)};
+    }
+
+    [[nodiscard]] constexpr const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    // Reserve capacity enough for extra rows.
+    [[nodiscard]] constexpr RE<void, SimpleError> reserve(size_type num_beyond_size)
+    {
+        return reserve_capacity(size() + num_beyond_size);
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> reserve_capacity(size_type required_capacity)
+    {
+        if (required_capacity <= capacity()) return {};
+        return reallocate(_capacity + std::max(_capacity / 2, required_capacity - _capacity));
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> shrink_to_fit()
+    {
+        if (_size == _capacity) return {};
+        return reallocate(_size);
+    }
+
+    constexpr void clear() noexcept
+    {
+        for_each_column([&](auto i) { std::destroy_n(std::get<i>(_columns), _size); });
+        _size = 0;
+    }
+
+    template<class ...Us>
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> emplace_back(Us &&...values)
+    noexcept((std::is_nothrow_constructible_v<Ts, Us> && ...))
+    requires (sizeof...(Us) == sizeof...(Ts) && (std::is_constructible_v<Ts, Us> && ...))
+    {
+        PL_TRY_DISCARD(reserve(1));
+        [&]<std::size_t ...Is>(std::index_sequence<Is...>)
+        {
+            (std::construct_at(std::get<Is>(_columns) + _size, std::forward<Us>(values)), ...);
+        }(std::index_sequence_for<Ts...>());
+        ++_size;
+        return {};
+    }
+
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> push_back(Ts ...values)
+    noexcept((std::is_nothrow_move_constructible_v<Ts> && ...))
+    {
+        return emplace_back(std::move(values)...);
+    }
+
+    constexpr void pop_back() noexcept
+    {
+        PL_ASSERT(!empty());
+        --_size;
+        for_each_column([&](auto i) { std::destroy_at(std::get<i>(_columns) + _size); });
+    }
+
+    // Removes the row at idx by moving the last row into its place, so it does not preserve order.
+    constexpr void swap_remove(size_type idx) noexcept
+    {
+        PL_ASSERT(idx < size());
+        if (idx != _size - 1)
+        {
+            for_each_column([&](auto i)
+            {
+                auto *column = std::get<i>(_columns);
+                column[idx] = std::move(column[_size - 1]);
+            });
+        }
+        pop_back();
+    }
+
+    constexpr RE<void, SimpleError> resize(size_type count) noexcept
+    {
+        PL_TRY_DISCARD(reserve_capacity(count));
+        if (count < _size)
+        {
+            for_each_column([&](auto i) { std::destroy(std::get<i>(_columns) + count, std::get<i>(_columns) + _size); });
+        }
+        else
+        {
+            for_each_column([&](auto i)
+            {
+                auto *column = std::get<i>(_columns);
+                for (size_type r = _size; r < count; ++r)
+                    default_construct_at(makeNonNull_Unchecked(column + r));
+            });
+        }
+        _size = count;
+        return {};
+    }
+
+    constexpr void swap(BasicSoAArrayList &other) noexcept
+    {
+        using std::swap;
+        swap(_columns  , other._columns  );
+        swap(_size     , other._size     );
+        swap(_capacity , other._capacity );
+        swap(_allocator, other._allocator);
+    }
+
+private:
+    template<class F>
+    static constexpr void for_each_column(F &&f)
+    {
+        [&]<std::size_t ...Is>(std::index_sequence<Is...>)
+        {
+            (f(std::integral_constant<std::size_t, Is>()), ...);
+        }(std::index_sequence_for<Ts...>());
+    }
+
+    // Offset of every column within the allocation, followed by the size of the whole allocation.
+    [[nodiscard]]
+    static constexpr std::array<size_type, num_columns + 1> column_offsets(size_type capacity) noexcept
+    {
+        constexpr size_type sizes[] = {sizeof(Ts)...};
+        std::array<size_type, num_columns + 1> offsets = {};
+        for (size_type i = 0; i < num_columns; ++i)
+            offsets[i + 1] = alignUp(offsets[i] + sizes[i] * capacity, column_alignment);
+        return offsets;
+    }
+
+    // Moves count elements from first to dest, and ends the lifetime of the originals.
+    template<class T>
+    static constexpr void relocate(T *first, T *dest, size_type count) noexcept
+    {
+        if (count == 0) return;
+        if consteval
+        {
+            for (size_type i = 0; i < count; ++i)
+            {
+                std::construct_at(dest + i, std::move(first[i]));
+                std::destroy_at(first + i);
+            }
+        }
+        else
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                std::memcpy(static_cast<void *>(dest), first, sizeof(T) * count);
+            }
+            else
+            {
+                std::uninitialized_move_n(first, count, dest);
+                std::destroy_n(first, count);
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> reallocate(size_type const new_capacity)
+    {
+        PL_ASSERT(new_capacity >= _size);
+        std::tuple<Ts *...> new_columns = {};
+        if (new_capacity != 0)
+        {
+            if consteval
+            {
+                new_columns = std::tuple<Ts *...>(std::allocator<Ts>().allocate(new_capacity)...);
+            }
+            else
+            {
+                auto offsets = column_offsets(new_capacity);
+                PL_TRY_ASSIGN(Ptr<void> memory, _allocator.alloc(
+                        makeNonZero_Unchecked(offsets.back()),
+                        makeNonZero_Unchecked(column_alignment)));
+
+                // The allocation provides storage for the columns, whose elements are created
+                // when they are constructed or relocated into place.
+                auto *block = static_cast<std::byte *>(static_cast<void *>(memory));
+                for_each_column([&](auto i)
+                {
+                    using T = column_type<decltype(i)::value>;
+                    std::get<i>(new_columns) = static_cast<T *>(static_cast<void *>(block + offsets[i]));
+                });
+            }
+        }
+
+        for_each_column([&](auto i) { relocate(std::get<i>(_columns), std::get<i>(new_columns), _size); });
+        deallocate();
+        _columns  = new_columns;
+        _capacity = new_capacity;
+        return {};
+    }
+
+    // Frees the columns, whose elements must have been destroyed or relocated beforehand.
+    constexpr void deallocate() noexcept
+    {
+        if (_capacity == 0) return;
+        if consteval
+        {
+            for_each_column([&](auto i)
+            {
+                std::allocator<column_type<decltype(i)::value>>().deallocate(std::get<i>(_columns), _capacity);
+            });
+        }
+        else
+        {
+            _allocator.free(
+                makeNonNull_Unchecked(static_cast<void *>(std::get<0>(_columns))),
+                makeNonZero_Unchecked(column_offsets(_capacity).back()),
+                makeNonZero_Unchecked(column_alignment));
+        }
+        _columns  = {};
+        _capacity = 0;
+    }
+
+    std::tuple<Ts *...>     _columns  = {};
+    size_type               _size     = 0;
+    size_type               _capacity = 0;
+    [[no_unique_address]] A _allocator = {};
+};
+
+// BasicSoAArrayList only refers to its columns through pointers.
+template<allocator A, class ...Ts>
+struct is_trivially_relocatable<BasicSoAArrayList<A, Ts...>> : is_trivially_relocatable<A> {};
+
+// Columns are aligned beyond alignof(std::max_align_t), so they need AlignedAllocator.
+template<class ...Ts>
+using SoAArrayList = BasicSoAArrayList<AlignedAllocator, Ts...>;
+} // export namespace pl
@@ -0,0 +1,455 @@
+module;
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.core:stable_array_list;
+
+import :array_list;
+import :error;
+import :memory;
+import :null;
+import :result_error;
+import :span;
+
+namespace pl::stable_array_list_
+{
+// Chunks of about 16 KiB, which keeps the chunk table small for large lists,
+// while a chunk is still cheap to allocate for a short one.
+template<class T>
+constexpr std::size_t defaultChunkSize = std::bit_floor(std::max(std::size_t(16 * 1024) / sizeof(T), std::size_t(1)));
+} // namespace pl::stable_array_list_
+
+namespace pl
+{
+// Refers to an element of a StableArrayList by index, through the list's chunk table.
+// Unlike ArrayListIterator, it stays valid when the list grows.
+template<class T, std::size_t ChunkSize, class Chunks>
+class StableArrayListIterator
+{
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using difference_type  = std::ptrdiff_t;
+    using value_type       = std::remove_const_t<T>;
+    using reference        = T &;
+    using pointer          = T *;
+
+    StableArrayListIterator           ()                                = default;
+    StableArrayListIterator           (StableArrayListIterator const &) = default;
+    StableArrayListIterator &operator=(StableArrayListIterator const &) = default;
+
+    constexpr StableArrayListIterator(Chunks const *chunks, difference_type index) noexcept
+    :
+        _chunks(chunks),
+        _index(index)
+    {}
+
+    // Mutable to const conversion.
+    template<class U>
+    requires (!std::is_same_v<U, T> && std::is_convertible_v<U *, T *>)
+    constexpr StableArrayListIterator(StableArrayListIterator<U, ChunkSize, Chunks> const &other) noexcept
+    :
+        _chunks(other._chunks),
+        _index(other._index)
+    {}
+
+    constexpr StableArrayListIterator &operator++() noexcept
+    {
+        ++_index;
+        return *this;
+    }
+
+    constexpr StableArrayListIterator operator++(int) noexcept
+    {
+        auto copy = *this;
+        ++_index;
+        return copy;
+    }
+
+    constexpr StableArrayListIterator &operator--() noexcept
+    {
+        --_index;
+        return *this;
+    }
+
+    constexpr StableArrayListIterator operator--(int) noexcept
+    {
+        auto copy = *this;
+        --_index;
+        return copy;
+    }
+
+    constexpr StableArrayListIterator &operator+=(difference_type d) noexcept
+    {
+        _index += d;
+        return *this;
+    }
+
+    constexpr StableArrayListIterator &operator-=(difference_type d) noexcept
+    {
+        _index -= d;
+        return *this;
+    }
+
+    friend constexpr StableArrayListIterator operator+(StableArrayListIterator i, difference_type d) noexcept
+    {
+        i._index += d;
+        return i;
+    }
+
+    friend constexpr StableArrayListIterator operator+(difference_type d, StableArrayListIterator i) noexcept
+    {
+        i._index += d;
+        return i;
+    }
+
+    friend constexpr StableArrayListIterator operator-(StableArrayListIterator i, difference_type d) noexcept
+    {
+        i._index -= d;
+        return i;
+    }
+
+    friend constexpr difference_type operator-(StableArrayListIterator a, StableArrayListIterator b) noexcept
+    {
+        PL_ASSERT(a._chunks == b._chunks);
+        return a._index - b._index;
+    }
+
+    constexpr reference operator*() const noexcept
+    {
+        return (*this)[0];
+    }
+
+    constexpr pointer operator->() const noexcept
+    {
+        return &(*this)[0];
+    }
+
+    constexpr reference operator[](difference_type d) const noexcept
+    {
+        auto i = static_cast<std::size_t>(_index + d);
+        return (*_chunks)[i / ChunkSize][i % ChunkSize];
+    }
+
+    constexpr bool operator==(StableArrayListIterator const &other) const noexcept
+    {
+        PL_ASSERT(_chunks == other._chunks);
+        return _index == other._index;
+    }
+
+    constexpr auto operator<=>(StableArrayListIterator const &other) const noexcept
+    {
+        PL_ASSERT(_chunks == other._chunks);
+        return _index <=> other._index;
+    }
+
+private:
+    template<class U, std::size_t, class>
+    friend class StableArrayListIterator;
+
+    Chunks const    *_chunks = nullptr;
+    difference_type  _index  = 0;
+};
+} // namespace pl
+
+export namespace pl
+{
+// List whose elements never move once constructed, so pointers and references to them
+// stay valid until they are removed, however much the list grows.
+//
+// Elements are stored in fixed-size chunks of ChunkSize elements, found through a table of chunk pointers,
+// so indexing is a shift, a mask and two loads. Growth allocates a new chunk, and only the table,
+// which holds a pointer per chunk, is ever reallocated. Each chunk is contiguous, and chunk() exposes it
+// as a Span for bulk processing, e.g. with simd.
+//
+// ChunkSize must be a power of two. Unlike ArrayList, chunks are not released by clear() or pop_back(),
+// only by shrink_to_fit().
+template<
+    class T,
+    std::size_t ChunkSize = stable_array_list_::defaultChunkSize<T>,
+    allocator A = default_allocator_t<T>>
+requires (sizeof(T) != 0 && std::has_single_bit(ChunkSize))
+class StableArrayList
+{
+    using Chunks = ArrayList<T *, A>;
+
+public:
+    using value_type      = T;
+    using allocator_type  = A;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = value_type       &;
+    using const_reference = value_type const &;
+    using pointer         = value_type       *;
+    using const_pointer   = value_type const *;
+    using iterator        = StableArrayListIterator<T      , ChunkSize, Chunks>;
+    using const_iterator  = StableArrayListIterator<T const, ChunkSize, Chunks>;
+
+    static constexpr size_type chunk_size = ChunkSize;
+
+    [[nodiscard]] StableArrayList() = default;
+
+    [[nodiscard]] explicit constexpr StableArrayList(allocator_type const &a) noexcept
+    : _chunks(a) {}
+
+    [[nodiscard]] constexpr StableArrayList(StableArrayList &&other) noexcept
+    :
+        _chunks(std::move(other._chunks)),
+        _size(std::exchange(other._size, 0))
+    {}
+
+    constexpr StableArrayList &operator=(StableArrayList &&other) noexcept
+    {
+        // The emptied chunk table is handed to other, which frees it.
+        release();
+        swap(other);
+        return *this;
+    }
+
+    constexpr ~StableArrayList()
+    {
+        release();
+    }
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _chunks.get_allocator();
+    }
+
+    [[nodiscard]] constexpr reference operator[](size_type idx) noexcept
+    {
+        PL_ASSERT(idx < size());
+        return _chunks[idx / ChunkSize][idx % ChunkSize];
+    }
+
+    [[nodiscard]] constexpr const_reference operator[](size_type idx) const noexcept
+    {
+        PL_ASSERT(idx < size());
+        return _chunks[idx / ChunkSize][idx % ChunkSize];
+    }
+
+    [[nodiscard]] constexpr reference front() noexcept
+    {
+        PL_ASSERT(!empty());
+        return (*this)[0];
+    }
+
+    [[nodiscard]] constexpr const_reference front() const noexcept
+    {
+        PL_ASSERT(!empty());
+        return (*this)[0];
+    }
+
+    [[nodiscard]] constexpr reference back() noexcept
+    {
+        PL_ASSERT(!empty());
+        return (*this)[_size - 1];
+    }
+
+    [[nodiscard]] constexpr const_reference back() const noexcept
+    {
+        PL_ASSERT(!empty());
+        return (*this)[_size - 1];
+    }
+
+    [[nodiscard]] constexpr iterator       begin()        noexcept { return {&_chunks, 0}; }
+    [[nodiscard]] constexpr const_iterator begin()  const noexcept { return {&_chunks, 0}; }
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin();       }
+
+    [[nodiscard]] constexpr iterator       end()        noexcept { return {&_chunks, difference_type(_size)}; }
+    [[nodiscard]] constexpr const_iterator end()  const noexcept { return {&_chunks, difference_type(_size)}; }
+    [[nodiscard]] constexpr const_iterator cend() const noexcept { return end();                              }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return _chunks.size() * ChunkSize;
+    }
+
+    // Number of chunks that hold elements, all of them full except for the last one.
+    [[nodiscard]] constexpr size_type num_chunks() const noexcept
+    {
+        return (_size + ChunkSize - 1) / ChunkSize;
+    }
+
+    // The elements in the chunk at idx, which are contiguous in memory.
+    [[nodiscard]] constexpr Span<T> chunk(size_type idx) noexcept
+    {
+        PL_ASSERT(idx < num_chunks());
+        return Span<T>(_chunks[idx], std::min(ChunkSize, _size - idx * ChunkSize));
+    }
+
+    [[nodiscard]] constexpr Span<T const> chunk(size_type idx) const noexcept
+    {
+        PL_ASSERT(idx < num_chunks());
+        return Span<T const>(_chunks[idx], std::min(ChunkSize, _size - idx * ChunkSize));
+    }
+
+    // Calls f with the Span of every chunk, in order.
+    template<class F>
+    constexpr void for_each_chunk(F &&f)
+    {
+        for (size_type i = 0; i < num_chunks(); ++i) f(chunk(i));
+    }
+
+    template<class F>
+    constexpr void for_each_chunk(F &&f) const
+    {
+        for (size_type i = 0; i < num_chunks(); ++i) f(chunk(i));
+    }
+
+    // Reserve capacity enough for extra elements.
+    [[nodiscard]] constexpr RE<void, SimpleError> reserve(size_type num_beyond_size)
+    {
+        return reserve_capacity(_size + num_beyond_size);
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> reserve_capacity(size_type required_capacity)
+    {
+        size_type required_chunks = (required_capacity + ChunkSize - 1) / ChunkSize;
+        if (required_chunks <= _chunks.size()) return {};
+
+        PL_TRY_DISCARD(_chunks.reserve_capacity(required_chunks));
+        while (_chunks.size() < required_chunks)
+        {
+            PL_TRY_DISCARD(add_chunk());
+        }
+        return {};
+    }
+
+    // Frees the chunks past the last element. Elements are not moved.
+    constexpr void shrink_to_fit() noexcept
+    {
+        while (_chunks.size() > num_chunks())
+        {
+            free(get_allocator(), Span<T>(_chunks.back(), ChunkSize));
+            _chunks.pop_back();
+        }
+    }
+
+    constexpr void clear() noexcept
+    {
+        destroy_from(0);
+        _size = 0;
+    }
+
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> push_back(T const &value)
+    noexcept(std::is_nothrow_copy_constructible_v<T>)
+    requires std::is_copy_constructible_v<T>
+    {
+        return emplace_back(value);
+    }
+
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> push_back(T &&value)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    requires std::is_move_constructible_v<T>
+    {
+        return emplace_back(std::move(value));
+    }
+
+    template<class ...Args>
+    [[nodiscard]]
+    constexpr RE<void, SimpleError> emplace_back(Args &&...args)
+    noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    requires std::is_constructible_v<T, Args...>
+    {
+        if (_size == capacity())
+        {
+            PL_TRY_DISCARD(add_chunk());
+        }
+        std::construct_at(_chunks[_size / ChunkSize] + _size % ChunkSize, std::forward<Args>(args)...);
+        ++_size;
+        return {};
+    }
+
+    constexpr void pop_back() noexcept
+    {
+        PL_ASSERT(!empty());
+        --_size;
+        std::destroy_at(_chunks[_size / ChunkSize] + _size % ChunkSize);
+    }
+
+    constexpr RE<void, SimpleError> resize(size_type count) noexcept
+    {
+        if (count < _size)
+        {
+            destroy_from(count);
+            _size = count;
+            return {};
+        }
+
+        PL_TRY_DISCARD(reserve_capacity(count));
+        for (; _size < count; ++_size)
+        {
+            T *p = _chunks[_size / ChunkSize] + _size % ChunkSize;
+            // Default initialization through placement new is not allowed in constant evaluation.
+            if consteval { std::construct_at(p); }
+            else         { default_construct_at(makeNonNull_Unchecked(p)); }
+        }
+        return {};
+    }
+
+    constexpr void swap(StableArrayList &other) noexcept
+    {
+        using std::swap;
+        _chunks.swap(other._chunks);
+        swap(_size, other._size);
+    }
+
+private:
+    [[nodiscard]] constexpr RE<void, SimpleError> add_chunk()
+    {
+        PL_TRY_ASSIGN(Span<T> new_chunk, alloc<T>(get_allocator(), ChunkSize));
+        if (RE<void, SimpleError> pushed = _chunks.push_back(new_chunk.data()); !pushed)
+        {
+            free(get_allocator(), new_chunk);
+            return {tags::error, std::move(pushed).error()};
+        }
+        return {};
+    }
+
+    // Destroys the elements from index first onwards, a chunk at a time.
+    constexpr void destroy_from(size_type first) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_type i = first; i < _size;)
+            {
+                T        *first_in_chunk = _chunks[i / ChunkSize] + i % ChunkSize;
+                size_type chunk_end      = std::min(_size, (i / ChunkSize + 1) * ChunkSize);
+                std::ranges::destroy(first_in_chunk, first_in_chunk + (chunk_end - i));
+                i = chunk_end;
+            }
+        }
+    }
+
+    constexpr void release() noexcept
+    {
+        destroy_from(0);
+        for (T *c : _chunks) free(get_allocator(), Span<T>(c, ChunkSize));
+        _chunks.clear();
+        _size = 0;
+    }
+
+    Chunks    _chunks;
+    size_type _size = 0;
+};
+} // export namespace pl
@@ -0,0 +1,338 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include <pl/macro.hpp>
+
+export module pl.core:thread_caching_allocator;
+
+import :error;
+import :memory;
+import :null;
+import :numeric;
+import :result_error;
+import :singleton;
+
+namespace pl::thread_caching_allocator_
+{
+// Blocks are grouped in power of two size classes, from minBlockSize to maxBlockSize.
+// Anything larger goes straight to the upstream allocator.
+constexpr std::size_t minBlockSize   = 16;
+constexpr std::size_t maxBlockSize   = 32 * 1024;
+constexpr std::size_t numSizeClasses = std::bit_width(maxBlockSize / minBlockSize);
+constexpr std::size_t chunkSize      = 256 * 1024;
+
+static_assert(minBlockSize % alignof(std::max_align_t) == 0,
+    "Every block must be suitably aligned for any scalar type");
+
+[[nodiscard]]
+constexpr std::size_t sizeClassOf(std::size_t size) noexcept
+{
+    return std::bit_width((std::max(size, minBlockSize) - 1) / minBlockSize);
+}
+
+[[nodiscard]]
+constexpr std::size_t blockSizeOf(std::size_t sizeClass) noexcept
+{
+    return minBlockSize << sizeClass;
+}
+
+// Number of blocks moved between a thread cache and the central heap at once.
+[[nodiscard]]
+constexpr std::size_t batchSizeOf(std::size_t sizeClass) noexcept
+{
+    return std::clamp<std::size_t>(64 * 1024 / blockSizeOf(sizeClass), 2, 64);
+}
+
+static_assert(sizeClassOf(minBlockSize) == 0);
+static_assert(sizeClassOf(minBlockSize + 1) == 1);
+static_assert(sizeClassOf(maxBlockSize) == numSizeClasses - 1);
+static_assert(blockSizeOf(numSizeClasses - 1) == maxBlockSize);
+
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+class SpinLock
+{
+public:
+    void lock() noexcept
+    {
+        while (_flag.test_and_set(std::memory_order_acquire))
+            _flag.wait(true, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        _flag.clear(std::memory_order_release);
+        _flag.notify_one();
+    }
+
+private:
+    std::atomic_flag _flag;
+};
+
+// Shared heap that every thread cache refills from and flushes to.
+// Chunks are never returned upstream, and the heap is trivially destructible so that it is never
+// destroyed either: blocks may still be freed into it by static and thread_local destructors at exit.
+class CentralHeap : public Singleton
+{
+public:
+    [[nodiscard]] constexpr CentralHeap(auto singleton_tag) noexcept : Singleton(singleton_tag) {}
+
+    // Pops up to count blocks of sizeClass as a list linked through FreeBlock::next.
+    // Returns the number of blocks popped, which is never zero.
+    [[nodiscard]]
+    RE<std::size_t, SimpleError> fetch(std::size_t sizeClass, std::size_t count, FreeBlock *&list) noexcept
+    {
+        SizeClass &c = _classes[sizeClass];
+        std::size_t blockSize = blockSizeOf(sizeClass);
+        std::size_t n = 0;
+        list = nullptr;
+
+        std::lock_guard guard(c.lock);
+        for (; n < count && c.freeList; ++n)
+        {
+            FreeBlock *block = c.freeList;
+            c.freeList = block->next;
+            block->next = list;
+            list = block;
+        }
+
+        for (; n < count; ++n)
+        {
+            if (c.carve == c.carveEnd)
+            {
+                if (n != 0) break;
+                PL_TRY_ASSIGN(c.carve, allocChunk());
+                c.carveEnd = c.carve + (chunkSize - chunkHeaderSize) / blockSize * blockSize;
+            }
+            list = std::construct_at(static_cast<FreeBlock *>(static_cast<void *>(c.carve)), list);
+            c.carve += blockSize;
+        }
+
+        return n;
+    }
+
+    // Pushes the list of blocks from first to last onto the free list of sizeClass.
+    void release(std::size_t sizeClass, FreeBlock *first, FreeBlock *last) noexcept
+    {
+        SizeClass &c = _classes[sizeClass];
+        std::lock_guard guard(c.lock);
+        last->next = c.freeList;
+        c.freeList = first;
+    }
+
+private:
+    struct Chunk
+    {
+        Chunk *next;
+    };
+
+    struct SizeClass
+    {
+        SpinLock   lock;
+        FreeBlock *freeList = {};
+        std::byte *carve    = {};
+        std::byte *carveEnd = {};
+    };
+
+    static constexpr std::size_t chunkHeaderSize = alignUp(sizeof(Chunk), minBlockSize);
+
+    // Returns the first usable byte of a new chunk.
+    [[nodiscard]]
+    RE<std::byte *, SimpleError> allocChunk() noexcept
+    {
+        PL_TRY_ASSIGN(Ptr<void> memory, Mallocator::alloc(
+                makeNonZero_Unchecked(chunkSize),
+                makeNonZero_Unchecked(alignof(std::max_align_t))));
+
+        std::lock_guard guard(_chunksLock);
+        _chunks = std::construct_at(static_cast<Chunk *>(static_cast<void *>(memory)), _chunks);
+        return reinterpret_cast<std::byte *>(_chunks) + chunkHeaderSize;
+    }
+
+    SizeClass _classes[numSizeClasses];
+    SpinLock  _chunksLock;
+    Chunk    *_chunks = {};
+};
+
+static_assert(std::is_trivially_destructible_v<CentralHeap>, "The central heap must outlive every thread cache");
+
+[[nodiscard]]
+inline CentralHeap &central() noexcept
+{
+    return getSingletonMut<CentralHeap>();
+}
+
+// Per-thread cache state.
+// It is kept trivially destructible so that it remains usable while the thread is exiting,
+// e.g. by destructors of other thread_local objects that free memory.
+struct ThreadCache
+{
+    struct List
+    {
+        FreeBlock  *head;
+        std::size_t count;
+    };
+
+    List lists[numSizeClasses];
+    bool exiting;
+};
+
+constinit thread_local ThreadCache threadCache = {};
+
+void flush(std::size_t sizeClass, std::size_t count) noexcept
+{
+    auto &list = threadCache.lists[sizeClass];
+    assert(count != 0 && count <= list.count);
+
+    FreeBlock *first = list.head;
+    FreeBlock *last  = first;
+    for (std::size_t i = 1; i < count; ++i) last = last->next;
+
+    list.head   = last->next;
+    list.count -= count;
+    central().release(sizeClass, first, last);
+}
+
+// Returns every cached block to the central heap once its thread exits.
+struct ThreadCacheFlusher
+{
+    ~ThreadCacheFlusher()
+    {
+        for (std::size_t c = 0; c < numSizeClasses; ++c)
+        {
+            if (threadCache.lists[c].count != 0)
+                flush(c, threadCache.lists[c].count);
+        }
+        threadCache.exiting = true;
+    }
+};
+
+thread_local ThreadCacheFlusher threadCacheFlusher;
+
+[[nodiscard]]
+RE<Ptr<void>, SimpleError> refillAndAlloc(std::size_t sizeClass) noexcept
+{
+    auto &list = threadCache.lists[sizeClass];
+    if (threadCache.exiting)
+    {
+        // The cache has already been flushed, so bypass it.
+        FreeBlock *block;
+        PL_TRY_DISCARD(central().fetch(sizeClass, 1, block));
+        return makeNonNull_Unchecked(static_cast<void *>(block));
+    }
+
+    // Registers the flusher for this thread.
+    (void) &threadCacheFlusher;
+
+    PL_TRY_ASSIGN(list.count, central().fetch(sizeClass, batchSizeOf(sizeClass), list.head));
+    FreeBlock *block = list.head;
+    list.head = block->next;
+    --list.count;
+    return makeNonNull_Unchecked(static_cast<void *>(block));
+}
+
+[[nodiscard]]
+inline RE<Ptr<void>, SimpleError> cachedAlloc(std::size_t sizeClass) noexcept
+{
+    auto &list = threadCache.lists[sizeClass];
+    if (!list.head) return refillAndAlloc(sizeClass);
+
+    FreeBlock *block = list.head;
+    list.head = block->next;
+    --list.count;
+    return makeNonNull_Unchecked(static_cast<void *>(block));
+}
+
+// Blocks freed by any thread go into that thread's own cache, since every block belongs to
+// the shared central heap. This is what makes cross-thread frees cheap.
+inline void cachedFree(void *memory, std::size_t sizeClass) noexcept
+{
+    auto *block = std::construct_at(static_cast<FreeBlock *>(memory), nullptr);
+    if (threadCache.exiting)
+    {
+        central().release(sizeClass, block, block);
+        return;
+    }
+
+    auto &list = threadCache.lists[sizeClass];
+    // A thread may only ever free, so the flusher is registered here too, whenever a list starts filling up.
+    if (!list.head) (void) &threadCacheFlusher;
+
+    block->next = list.head;
+    list.head = block;
+    if (++list.count > 2 * batchSizeOf(sizeClass))
+        flush(sizeClass, batchSizeOf(sizeClass));
+}
+} // namespace pl::thread_caching_allocator_
+
+export namespace pl
+{
+// General purpose allocator for multi-threaded code.
+// Small allocations are served from per-thread caches of size-classed blocks,
+// which are refilled from and flushed to a shared central heap in batches,
+// so the common path never takes a lock.
+// Allocations larger than the biggest size class go straight to Mallocator.
+class ThreadCachingAllocator
+{
+public:
+    [[nodiscard]]
+    static RE<Ptr<void>, SimpleError> alloc(
+                         NonZero<std::size_t> size,
+        [[maybe_unused]] NonZero<std::size_t> alignment)
+        noexcept
+    {
+        namespace tca = thread_caching_allocator_;
+        assert(alignment <= alignof(std::max_align_t) && isValidAlignment(alignment));
+        if (size > tca::maxBlockSize)
+            return Mallocator::alloc(size, alignment);
+        else
+            return tca::cachedAlloc(tca::sizeClassOf(size));
+    }
+
+    static void free(
+                         Ptr<void> memory,
+                         NonZero<std::size_t> size,
+        [[maybe_unused]] NonZero<std::size_t> alignment)
+        noexcept
+    {
+        namespace tca = thread_caching_allocator_;
+        assert(alignment <= alignof(std::max_align_t) && isValidAlignment(alignment));
+        if (size > tca::maxBlockSize)
+            Mallocator::free(memory, size, alignment);
+        else
+            tca::cachedFree(memory, tca::sizeClassOf(size));
+    }
+
+    // Succeeds as long as the new size falls into the same size class.
+    [[nodiscard]]
+    static bool expand(
+        [[maybe_unused]] Ptr<void> memory,
+                         NonZero<std::size_t> oldSize,
+                         NonZero<std::size_t> newSize,
+        [[maybe_unused]] NonZero<std::size_t> alignment)
+        noexcept
+    {
+        namespace tca = thread_caching_allocator_;
+        assert(alignment <= alignof(std::max_align_t) && isValidAlignment(alignment));
+        return oldSize <= tca::maxBlockSize
+            && newSize <= tca::maxBlockSize
+            && tca::sizeClassOf(oldSize) == tca::sizeClassOf(newSize);
+    }
+};
+} // export namespace pl
+
+namespace pl
+{
+static_assert(allocator<ThreadCachingAllocator>, "ThreadCachingAllocator must be an allocator");
+static_assert(expanding_allocator<ThreadCachingAllocator>, "ThreadCachingAllocator must support expand");
+} // namespace pl
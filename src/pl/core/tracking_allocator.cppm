@@ -0,0 +1,323 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <ostream>
+
+#include <pl/macro.hpp>
+
+export module pl.core:tracking_allocator;
+
+import :error;
+import :memory;
+import :null;
+import :numeric;
+import :result_error;
+
+export namespace pl
+{
+// Allocation tracking is on by default in debug builds only.
+// When it is off, TrackingAllocator forwards straight to its upstream allocator,
+// and every statistic reads as zero.
+constexpr bool allocationTrackingEnabled = PL_TRACK_ALLOCATIONS;
+
+// Tags name the statistics that a TrackingAllocator reports to, e.g.
+//
+// struct RendererAllocations
+// {
+//     static constexpr char const name[] = "vulkan.renderer";
+// };
+template<class T>
+concept allocation_tag = requires
+{
+    { T::name } -> std::convertible_to<char const *>;
+};
+
+// Statistics of every TrackingAllocator sharing a tag.
+// Counters are relaxed atomics, so they are cheap to update from any thread,
+// but a report taken while other threads allocate is not an exact snapshot.
+class AllocationStats
+{
+public:
+    // Bucket i counts allocations of size in (2^(i-1), 2^i], the last bucket also counts every larger size.
+    static constexpr std::size_t numSizeBuckets = 24;
+
+    [[nodiscard]] explicit constexpr AllocationStats(char const *name) noexcept : _name(name) {}
+
+    AllocationStats           (AllocationStats const &) = delete;
+    AllocationStats &operator=(AllocationStats const &) = delete;
+
+    [[nodiscard]] constexpr char const *name() const noexcept { return _name; }
+
+    [[nodiscard]] std::size_t liveBytes()  const noexcept { return load(_liveBytes);  }
+    [[nodiscard]] std::size_t peakBytes()  const noexcept { return load(_peakBytes);  }
+    [[nodiscard]] std::size_t totalBytes() const noexcept { return load(_totalBytes); }
+    [[nodiscard]] std::size_t numAllocs()  const noexcept { return load(_numAllocs);  }
+    [[nodiscard]] std::size_t numFrees()   const noexcept { return load(_numFrees);   }
+    [[nodiscard]] std::size_t numResizes() const noexcept { return load(_numResizes); }
+
+    [[nodiscard]]
+    std::size_t numAllocsOfSize(std::size_t bucket) const noexcept
+    {
+        assert(bucket < numSizeBuckets);
+        return load(_sizeHistogram[bucket]);
+    }
+
+    [[nodiscard]]
+    static constexpr std::size_t sizeBucketOf(std::size_t size) noexcept
+    {
+        return std::min<std::size_t>(std::bit_width(size - 1), numSizeBuckets - 1);
+    }
+
+    // Restarts peak tracking from the current number of live bytes, e.g. at the start of a frame.
+    void resetPeak() noexcept
+    {
+        _peakBytes.store(_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Every tag that has allocated at least once, in no particular order.
+    [[nodiscard]]
+    static AllocationStats const *first() noexcept
+    {
+        return _head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]]
+    AllocationStats const *next() const noexcept
+    {
+        return _next;
+    }
+
+private:
+    template<allocator A, allocation_tag Tag>
+    friend class TrackingAllocator;
+
+    [[nodiscard]]
+    static std::size_t load(std::atomic<std::size_t> const &counter) noexcept
+    {
+        if constexpr (allocationTrackingEnabled)
+            return counter.load(std::memory_order_relaxed);
+        else
+            return 0;
+    }
+
+    void recordAlloc(std::size_t size) noexcept
+    {
+        link();
+        addLive(size);
+        _totalBytes.fetch_add(size, std::memory_order_relaxed);
+        _numAllocs.fetch_add(1, std::memory_order_relaxed);
+        _sizeHistogram[sizeBucketOf(size)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordFree(std::size_t size) noexcept
+    {
+        _liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        _numFrees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordResize(std::size_t oldSize, std::size_t newSize) noexcept
+    {
+        if (newSize > oldSize)
+        {
+            addLive(newSize - oldSize);
+            _totalBytes.fetch_add(newSize - oldSize, std::memory_order_relaxed);
+        }
+        else
+        {
+            _liveBytes.fetch_sub(oldSize - newSize, std::memory_order_relaxed);
+        }
+        _numResizes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void addLive(std::size_t size) noexcept
+    {
+        std::size_t live = _liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        std::size_t peak = _peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+    }
+
+    // Links the statistics into the list read by writeAllocationReport, on the first allocation.
+    void link() noexcept
+    {
+        if (_linked.test(std::memory_order_relaxed) || _linked.test_and_set(std::memory_order_relaxed))
+            return;
+
+        AllocationStats *head = _head.load(std::memory_order_relaxed);
+        do _next = head;
+        while (!_head.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    char const                  *_name;
+    AllocationStats             *_next = {};
+    std::atomic_flag             _linked;
+    std::atomic<std::size_t>     _liveBytes  = 0;
+    std::atomic<std::size_t>     _peakBytes  = 0;
+    std::atomic<std::size_t>     _totalBytes = 0;
+    std::atomic<std::size_t>     _numAllocs  = 0;
+    std::atomic<std::size_t>     _numFrees   = 0;
+    std::atomic<std::size_t>     _numResizes = 0;
+    std::atomic<std::size_t>     _sizeHistogram[numSizeBuckets] = {};
+
+    static constinit inline std::atomic<AllocationStats *> _head = nullptr;
+};
+} // export namespace pl
+
+namespace pl::tracking_allocator_
+{
+template<allocation_tag Tag>
+constinit inline AllocationStats stats(Tag::name);
+} // namespace pl::tracking_allocator_
+
+export namespace pl
+{
+template<allocation_tag Tag>
+[[nodiscard]]
+AllocationStats const &getAllocationStats() noexcept
+{
+    return tracking_allocator_::stats<Tag>;
+}
+
+// Allocator decorator that records every allocation made through it in the statistics of Tag.
+// It supports expand and realloc whenever A does.
+template<allocator A, allocation_tag Tag>
+class TrackingAllocator
+{
+public:
+    using upstream_type = A;
+    using tag_type      = Tag;
+
+    [[nodiscard]] TrackingAllocator() = default;
+
+    [[nodiscard]] explicit constexpr TrackingAllocator(A const &upstream) noexcept
+    : _upstream(upstream) {}
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        RE<Ptr<void>, SimpleError> result = _upstream.alloc(size, alignment);
+        if constexpr (allocationTrackingEnabled)
+        {
+            if (result) stats().recordAlloc(size);
+        }
+        return result;
+    }
+
+    void free(
+        Ptr<void>            memory,
+        NonZero<std::size_t> size,
+        NonZero<std::size_t> alignment)
+        noexcept
+    {
+        _upstream.free(memory, size, alignment);
+        if constexpr (allocationTrackingEnabled)
+            stats().recordFree(size);
+    }
+
+    [[nodiscard]]
+    bool expand(
+        Ptr<void>            memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+        noexcept
+    requires expanding_allocator<A>
+    {
+        bool expanded = _upstream.expand(memory, oldSize, newSize, alignment);
+        if constexpr (allocationTrackingEnabled)
+        {
+            if (expanded) stats().recordResize(oldSize, newSize);
+        }
+        return expanded;
+    }
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> realloc(
+        Ptr<void>            memory,
+        NonZero<std::size_t> oldSize,
+        NonZero<std::size_t> newSize,
+        NonZero<std::size_t> alignment)
+        noexcept
+    requires reallocating_allocator<A>
+    {
+        RE<Ptr<void>, SimpleError> result = _upstream.realloc(memory, oldSize, newSize, alignment);
+        if constexpr (allocationTrackingEnabled)
+        {
+            if (result) stats().recordResize(oldSize, newSize);
+        }
+        return result;
+    }
+
+    [[nodiscard]]
+    constexpr A const &upstream() const noexcept
+    {
+        return _upstream;
+    }
+
+private:
+    [[nodiscard]]
+    static AllocationStats &stats() noexcept
+    {
+        return tracking_allocator_::stats<Tag>;
+    }
+
+    [[no_unique_address]] A _upstream = {};
+};
+
+// Writes the statistics of every tag that has allocated so far.
+void writeAllocationReport(std::ostream &os) noexcept
+{
+    if constexpr (!allocationTrackingEnabled)
+    {
+        os << "Allocation tracking is disabled\n";
+        return;
+    }
+
+    for (AllocationStats const *s = AllocationStats::first(); s; s = s->next())
+    {
+        os
+            << s->name() << ":\n"
+            << "    live bytes:  " << s->liveBytes()  << '\n'
+            << "    peak bytes:  " << s->peakBytes()  << '\n'
+            << "    total bytes: " << s->totalBytes() << '\n'
+            << "    allocations: " << s->numAllocs()  << '\n'
+            << "    frees:       " << s->numFrees()   << '\n'
+            << "    resizes:     " << s->numResizes() << '\n'
+            << "    sizes:\n";
+
+        for (std::size_t b = 0; b < AllocationStats::numSizeBuckets; ++b)
+        {
+            if (std::size_t n = s->numAllocsOfSize(b); n != 0)
+            {
+                os << (b + 1 == AllocationStats::numSizeBuckets ? "        > " : "        <= ")
+                   << (std::size_t(1) << (b + 1 == AllocationStats::numSizeBuckets ? b - 1 : b))
+                   << ": " << n << '\n';
+            }
+        }
+    }
+}
+} // export namespace pl
+
+namespace pl
+{
+struct TrackingAllocatorTestTag
+{
+    static constexpr char const name[] = "test";
+};
+
+static_assert(allocator<TrackingAllocator<Mallocator, TrackingAllocatorTestTag>>,
+    "TrackingAllocator must be an allocator");
+static_assert(reallocating_allocator<TrackingAllocator<Mallocator, TrackingAllocatorTestTag>>,
+    "TrackingAllocator must support realloc if its upstream does");
+static_assert(!expanding_allocator<TrackingAllocator<Mallocator, TrackingAllocatorTestTag>>,
+    "TrackingAllocator must not support expand if its upstream does not");
+static_assert(AllocationStats::sizeBucketOf(1)  == 0);
+static_assert(AllocationStats::sizeBucketOf(16) == 4);
+static_assert(AllocationStats::sizeBucketOf(17) == 5);
+} // namespace pl
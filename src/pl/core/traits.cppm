@@ -93,6 +93,14 @@ template<class T>
 constexpr bool is_move_assignable_or_void_v =
     std::is_void_v<T> || std::is_move_assignable_v<T>;
 
+template<class T>
+constexpr bool is_trivially_copyable_or_void_v =
+    std::is_void_v<T> || std::is_trivially_copyable_v<T>;
+
+template<class T>
+constexpr bool is_trivially_destructible_or_void_v =
+    std::is_void_v<T> || std::is_trivially_destructible_v<T>;
+
 
 template<class T, class U>
 constexpr bool is_nothrow_constructible_or_void_v =
@@ -0,0 +1,4 @@
+export module pl.ecs;
+
+export import :archetype;
+export import :world;
@@ -0,0 +1,175 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.ecs:archetype;
+
+import pl.core;
+
+namespace pl::ecs_
+{
+// Where the components of an entity are stored.
+struct EntityLocation
+{
+    std::uint32_t archetype;
+    std::uint32_t row;
+};
+
+constexpr std::uint32_t noArchetype = std::numeric_limits<std::uint32_t>::max();
+
+// Rows per chunk. Every column of an archetype uses the same chunk size, so chunk i of every column
+// holds the components of the same entities.
+constexpr std::size_t chunkRows = 1024;
+
+template<class T, class ...Ts>
+constexpr std::size_t indexOf = []
+{
+    constexpr bool same[] = {std::is_same_v<T, Ts>..., false};
+    std::size_t i = 0;
+    while (i < sizeof...(Ts) && !same[i]) ++i;
+    return i;
+}();
+
+template<class ...Ts>
+constexpr bool distinct = []
+{
+    constexpr std::size_t indices[] = {indexOf<Ts, Ts...>..., 0};
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+    {
+        if (indices[i] != i) return false;
+    }
+    return true;
+}();
+
+template<class ...Cs>
+using DefaultAllocator = std::conditional_t<
+        ((alignof(Cs) > alignof(std::max_align_t)) || ... || false),
+        AlignedAllocator,
+        Mallocator>;
+} // namespace pl::ecs_
+
+export namespace pl::ecs
+{
+// Generation-checked handle to an entity of a World.
+using Entity = SlotHandle<ecs_::EntityLocation>;
+} // export namespace pl::ecs
+
+namespace pl::ecs_
+{
+using ecs::Entity;
+
+// Table of every entity that has exactly the components in signature.
+//
+// Each component type has its own column, and columns are chunked: chunk i of every column holds
+// the same chunkRows entities, so a chunk is a structure of arrays that can be handed out as Spans.
+// Columns of component types outside of signature stay empty, and never allocate.
+// Rows are kept dense by moving the last row into the hole of a removed one.
+template<allocator A, class ...Cs>
+class Archetype
+{
+public:
+    using size_type = std::size_t;
+    using Signature = BitSet<sizeof...(Cs)>;
+
+    template<class C>
+    using Column = StableArrayList<C, chunkRows, A>;
+
+    template<std::size_t I>
+    using ComponentAt = std::tuple_element_t<I, std::tuple<Cs...>>;
+
+    // Calls f(std::integral_constant<std::size_t, I>()) for every component index I in signature.
+    template<class F>
+    static constexpr void forEachComponent(Signature const &signature, F &&f)
+    {
+        [&]<std::size_t ...I>(std::index_sequence<I...>)
+        {
+            ((signature.test(I) ? f(std::integral_constant<std::size_t, I>()) : void()), ...);
+        }(std::index_sequence_for<Cs...>());
+    }
+
+    [[nodiscard]] constexpr Archetype(Signature const &signature, A const &a) noexcept
+    :
+        _signature(signature),
+        _entities(a),
+        _columns(Column<Cs>(a)...)
+    {
+        for (std::size_t i = 0; i < sizeof...(Cs); ++i)
+        {
+            addEdges[i]    = noArchetype;
+            removeEdges[i] = noArchetype;
+        }
+    }
+
+    Archetype           (Archetype const &) = delete;
+    Archetype &operator=(Archetype const &) = delete;
+
+    [[nodiscard]] constexpr Signature const &signature() const noexcept { return _signature;              }
+    [[nodiscard]] constexpr size_type        size()      const noexcept { return _entities.size();        }
+    [[nodiscard]] constexpr size_type        numChunks() const noexcept { return _entities.num_chunks();  }
+
+    [[nodiscard]] constexpr Column<Entity>       &entities()       noexcept { return _entities; }
+    [[nodiscard]] constexpr Column<Entity> const &entities() const noexcept { return _entities; }
+
+    template<class C>
+    [[nodiscard]] constexpr Column<C> &column() noexcept
+    {
+        return std::get<Column<C>>(_columns);
+    }
+
+    template<class C>
+    [[nodiscard]] constexpr Column<C> const &column() const noexcept
+    {
+        return std::get<Column<C>>(_columns);
+    }
+
+    // Makes room for one more row, after which appending a row cannot fail.
+    [[nodiscard]] constexpr RE<void, SimpleError> reserveRow() noexcept
+    {
+        PL_TRY_DISCARD(_entities.reserve(1));
+        RE<void, SimpleError> result;
+        forEachComponent(_signature, [&]<std::size_t I>(std::integral_constant<std::size_t, I>)
+        {
+            if (result) result = column<ComponentAt<I>>().reserve(1);
+        });
+        return result;
+    }
+
+    // Removes the row by moving the last row into it.
+    // Returns the entity that was moved, which is null if row was the last one.
+    constexpr Entity swapRemove(size_type row) noexcept
+    {
+        PL_ASSERT(row < size());
+        size_type last = size() - 1;
+        forEachComponent(_signature, [&]<std::size_t I>(std::integral_constant<std::size_t, I>)
+        {
+            Column<ComponentAt<I>> &c = column<ComponentAt<I>>();
+            if (row != last) c[row] = std::move(c[last]);
+            c.pop_back();
+        });
+
+        Entity moved = {};
+        if (row != last)
+        {
+            moved = _entities[last];
+            _entities[row] = moved;
+        }
+        _entities.pop_back();
+        return moved;
+    }
+
+    // Archetypes reached by adding or removing the component at each index, noArchetype until first used.
+    std::uint32_t addEdges   [sizeof...(Cs)] = {};
+    std::uint32_t removeEdges[sizeof...(Cs)] = {};
+
+private:
+    Signature                 _signature;
+    Column<Entity>            _entities;
+    std::tuple<Column<Cs>...> _columns;
+};
+} // namespace pl::ecs_
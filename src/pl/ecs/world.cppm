@@ -0,0 +1,392 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include <pl/macro.hpp>
+
+export module pl.ecs:world;
+
+import pl.core;
+
+import :archetype;
+
+export namespace pl::ecs
+{
+template<allocator A, class ...Cs>
+requires (
+    sizeof...(Cs) != 0
+ && ecs_::distinct<Cs...>
+ && ((std::is_nothrow_move_constructible_v<Cs> && std::is_nothrow_move_assignable_v<Cs>) && ...))
+class BasicWorld;
+
+// Iterates over every entity that has at least the components Ts, a chunk at a time.
+//
+// Matching archetypes are cached, and archetypes created since the last iteration are checked
+// when the next one starts, so iterating costs nothing per archetype that does not match.
+// Components requested as const are handed out as Span<T const>.
+//
+// Entities must not be created or destroyed, and components must not be added or removed,
+// while a query iterates. The query refers to its world, which must outlive it.
+template<class World, class ...Ts>
+class Query
+{
+    using Archetype = World::Archetype;
+    using Signature = World::Signature;
+
+    struct ChunkRef
+    {
+        Archetype   *archetype;
+        std::size_t  chunk;
+    };
+
+public:
+    using size_type = std::size_t;
+
+    [[nodiscard]] explicit constexpr Query(World &world) noexcept
+    :
+        _world(&world),
+        _matches(world.get_allocator()),
+        _chunkRefs(world.get_allocator())
+    {
+        (_required.set(World::template component_index<std::remove_const_t<Ts>>), ...);
+    }
+
+    // Calls f(Span<Entity const> entities, Span<Ts>... components) for every chunk of every matching archetype.
+    // f returns either void or RE<void, SimpleError>, in which case iteration stops at the first error.
+    template<class F>
+    [[nodiscard]] constexpr RE<void, SimpleError> for_each_chunk(F &&f) noexcept
+    {
+        PL_TRY_DISCARD(refresh());
+        for (std::uint32_t index : _matches)
+        {
+            Archetype &archetype = _world->_archetypes[index];
+            for (size_type c = 0; c < archetype.numChunks(); ++c)
+            {
+                PL_TRY_DISCARD(invokeChunk(f, archetype, c));
+            }
+        }
+        return {};
+    }
+
+    // Calls f(Ts &...components), or f(Entity, Ts &...components), for every matching entity.
+    template<class F>
+    [[nodiscard]] constexpr RE<void, SimpleError> for_each(F &&f) noexcept
+    {
+        return for_each_chunk([&](Span<Entity const> entities, Span<Ts> ...components)
+        {
+            for (size_type i = 0; i < entities.size(); ++i)
+            {
+                if constexpr (std::is_invocable_v<F &, Entity, Ts &...>)
+                    std::invoke(f, entities[i], components[i]...);
+                else
+                    std::invoke(f, components[i]...);
+            }
+        });
+    }
+
+    // Like for_each_chunk, but chunks are processed in parallel by the workers of jobs.
+    // f is called concurrently for different chunks, so it must only write to the components of its chunk.
+    template<class F>
+    [[nodiscard]] RE<void, SimpleError> parallel_for_each_chunk(JobSystem &jobs, F &&f) noexcept
+    {
+        PL_TRY_DISCARD(refresh());
+        _chunkRefs.clear();
+        for (std::uint32_t index : _matches)
+        {
+            Archetype &archetype = _world->_archetypes[index];
+            for (size_type c = 0; c < archetype.numChunks(); ++c)
+            {
+                PL_TRY_DISCARD(_chunkRefs.push_back({&archetype, c}));
+            }
+        }
+
+        // A chunk is already a sizeable batch, so every chunk is its own job.
+        return jobs.parallel_for(
+            Span<ChunkRef>(_chunkRefs.data(), _chunkRefs.size()),
+            [&f](ChunkRef &ref) { return invokeChunk(f, *ref.archetype, ref.chunk); },
+            1);
+    }
+
+    // Number of entities that match, counted from the cached archetypes.
+    [[nodiscard]] constexpr RE<size_type, SimpleError> count() noexcept
+    {
+        PL_TRY_DISCARD(refresh());
+        size_type n = 0;
+        for (std::uint32_t index : _matches) n += _world->_archetypes[index].size();
+        return n;
+    }
+
+private:
+    // Checks the archetypes created since the last call.
+    [[nodiscard]] constexpr RE<void, SimpleError> refresh() noexcept
+    {
+        for (; _numChecked < _world->_archetypes.size(); ++_numChecked)
+        {
+            if ((_world->_archetypes[_numChecked].signature() & _required) == _required)
+            {
+                PL_TRY_DISCARD(_matches.push_back(std::uint32_t(_numChecked)));
+            }
+        }
+        return {};
+    }
+
+    template<class F>
+    [[nodiscard]]
+    static constexpr RE<void, SimpleError> invokeChunk(F &f, Archetype &archetype, size_type c) noexcept
+    {
+        auto call = [&]
+        {
+            return std::invoke(
+                f,
+                Span<Entity const>(archetype.entities().chunk(c)),
+                Span<Ts>(archetype.template column<std::remove_const_t<Ts>>().chunk(c))...);
+        };
+
+        if constexpr (std::is_void_v<decltype(call())>)
+        {
+            call();
+            return {};
+        }
+        else
+        {
+            return call();
+        }
+    }
+
+    World                                                  *_world;
+    Signature                                               _required;
+    ArrayList<std::uint32_t, typename World::allocator_type> _matches;
+    size_type                                               _numChecked = 0;
+    ArrayList<ChunkRef, typename World::allocator_type>      _chunkRefs;
+};
+
+// Archetype-based storage of entities and their components, for the component types Cs.
+//
+// Entities that have the same set of components share an archetype, a table that stores each
+// component type in its own chunked column, so that systems iterate over tightly packed arrays
+// of only the components they use. Creating and destroying an entity is O(1), destruction moving
+// the last entity of its archetype into the hole. Adding or removing a component moves the entity
+// to another archetype, found through edges cached on the archetype after the first time.
+//
+// Entity handles are generation-checked, so handles to destroyed entities are detected.
+// A world must not move, as queries and archetypes refer to it.
+template<allocator A, class ...Cs>
+requires (
+    sizeof...(Cs) != 0
+ && ecs_::distinct<Cs...>
+ && ((std::is_nothrow_move_constructible_v<Cs> && std::is_nothrow_move_assignable_v<Cs>) && ...))
+class BasicWorld
+{
+public:
+    using allocator_type = A;
+    using size_type      = std::size_t;
+    using Archetype      = ecs_::Archetype<A, Cs...>;
+    using Signature      = Archetype::Signature;
+
+    template<class C>
+    static constexpr bool is_component = ecs_::indexOf<C, Cs...> != sizeof...(Cs);
+
+    template<class C>
+    requires is_component<C>
+    static constexpr size_type component_index = ecs_::indexOf<C, Cs...>;
+
+    [[nodiscard]] BasicWorld() = default;
+
+    [[nodiscard]] explicit constexpr BasicWorld(allocator_type const &a) noexcept
+    :
+        _locations(a),
+        _archetypes(a)
+    {}
+
+    BasicWorld           (BasicWorld const &) = delete;
+    BasicWorld &operator=(BasicWorld const &) = delete;
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+    {
+        return _locations.get_allocator();
+    }
+
+    // Number of live entities.
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return _locations.size();
+    }
+
+    [[nodiscard]] constexpr size_type num_archetypes() const noexcept
+    {
+        return _archetypes.size();
+    }
+
+    [[nodiscard]] constexpr bool contains(Entity entity) const noexcept
+    {
+        return _locations.contains(entity);
+    }
+
+    // Creates an entity with the given components.
+    template<class ...Ts>
+    requires ((is_component<std::remove_cvref_t<Ts>> && ...) && ecs_::distinct<std::remove_cvref_t<Ts>...>)
+    [[nodiscard]] constexpr RE<Entity, SimpleError> create(Ts &&...components) noexcept
+    {
+        Signature signature;
+        (signature.set(component_index<std::remove_cvref_t<Ts>>), ...);
+        PL_TRY_ASSIGN(std::uint32_t index, findOrCreateArchetype(signature));
+
+        Archetype &archetype = _archetypes[index];
+        PL_TRY_DISCARD(archetype.reserveRow());
+        PL_TRY_ASSIGN(Entity entity, _locations.emplace(ecs_::EntityLocation{index, std::uint32_t(archetype.size())}));
+
+        // Cannot fail, as every column has reserved room for one more.
+        (void) archetype.entities().push_back(entity);
+        ((void) archetype.template column<std::remove_cvref_t<Ts>>().emplace_back(std::forward<Ts>(components)), ...);
+        return entity;
+    }
+
+    [[nodiscard]] constexpr RE<void, SimpleError> destroy(Entity entity) noexcept
+    {
+        if (!contains(entity)) return {tags::error, getSingleton<StaleHandle>()};
+
+        removeRow(_locations[entity]);
+        return _locations.erase(entity);
+    }
+
+    template<class C>
+    requires is_component<C>
+    [[nodiscard]] constexpr bool has(Entity entity) const noexcept
+    {
+        return contains(entity) && _archetypes[_locations[entity].archetype].signature().test(component_index<C>);
+    }
+
+    // Null if the entity is stale or does not have C.
+    // The pointer is invalidated once an entity of the same archetype is destroyed, or changes archetype.
+    template<class C>
+    requires is_component<C>
+    [[nodiscard]] constexpr Opt<Ptr<C>> get(Entity entity) noexcept
+    {
+        if (!has<C>(entity)) return {};
+        ecs_::EntityLocation location = _locations[entity];
+        return makeNonNull_Unchecked(&_archetypes[location.archetype].template column<C>()[location.row]);
+    }
+
+    template<class C>
+    requires is_component<C>
+    [[nodiscard]] constexpr Opt<Ptr<C const>> get(Entity entity) const noexcept
+    {
+        if (!has<C>(entity)) return {};
+        ecs_::EntityLocation location = _locations[entity];
+        return makeNonNull_Unchecked(&_archetypes[location.archetype].template column<C>()[location.row]);
+    }
+
+    // Adds a C constructed from args to the entity, or replaces its C if it already has one.
+    template<class C, class ...Args>
+    requires (is_component<C> && std::is_constructible_v<C, Args...>)
+    [[nodiscard]] constexpr RE<void, SimpleError> add(Entity entity, Args &&...args) noexcept
+    {
+        if (!contains(entity)) return {tags::error, getSingleton<StaleHandle>()};
+
+        constexpr size_type  c        = component_index<C>;
+        ecs_::EntityLocation location = _locations[entity];
+        Archetype           &from     = _archetypes[location.archetype];
+        if (from.signature().test(c))
+        {
+            from.template column<C>()[location.row] = C(std::forward<Args>(args)...);
+            return {};
+        }
+
+        if (from.addEdges[c] == ecs_::noArchetype)
+        {
+            PL_TRY_ASSIGN(from.addEdges[c], findOrCreateArchetype(Signature(from.signature()).set(c)));
+        }
+        std::uint32_t to = from.addEdges[c];
+        PL_TRY_DISCARD(_archetypes[to].reserveRow());
+
+        std::uint32_t row = moveRow(location, to);
+        (void) _archetypes[to].template column<C>().emplace_back(std::forward<Args>(args)...);
+        removeRow(location);
+        _locations[entity] = {to, row};
+        return {};
+    }
+
+    // Does nothing if the entity does not have C.
+    template<class C>
+    requires is_component<C>
+    [[nodiscard]] constexpr RE<void, SimpleError> remove(Entity entity) noexcept
+    {
+        if (!contains(entity)) return {tags::error, getSingleton<StaleHandle>()};
+
+        constexpr size_type  c        = component_index<C>;
+        ecs_::EntityLocation location = _locations[entity];
+        Archetype           &from     = _archetypes[location.archetype];
+        if (!from.signature().test(c)) return {};
+
+        if (from.removeEdges[c] == ecs_::noArchetype)
+        {
+            PL_TRY_ASSIGN(from.removeEdges[c], findOrCreateArchetype(Signature(from.signature()).reset(c)));
+        }
+        std::uint32_t to = from.removeEdges[c];
+        PL_TRY_DISCARD(_archetypes[to].reserveRow());
+
+        std::uint32_t row = moveRow(location, to);
+        removeRow(location);
+        _locations[entity] = {to, row};
+        return {};
+    }
+
+    template<class ...Ts>
+    requires ((is_component<std::remove_const_t<Ts>> && ...) && ecs_::distinct<std::remove_const_t<Ts>...>)
+    [[nodiscard]] constexpr Query<BasicWorld, Ts...> query() noexcept
+    {
+        return Query<BasicWorld, Ts...>(*this);
+    }
+
+private:
+    template<class World, class ...Ts>
+    friend class Query;
+
+    // Archetypes are few, and adding or removing components goes through the cached edges,
+    // so a linear search only runs when creating entities.
+    [[nodiscard]] constexpr RE<std::uint32_t, SimpleError> findOrCreateArchetype(Signature const &signature) noexcept
+    {
+        for (size_type i = 0; i < _archetypes.size(); ++i)
+        {
+            if (_archetypes[i].signature() == signature) return std::uint32_t(i);
+        }
+
+        PL_ASSERT(_archetypes.size() < ecs_::noArchetype);
+        PL_TRY_DISCARD(_archetypes.emplace_back(signature, get_allocator()));
+        return std::uint32_t(_archetypes.size() - 1);
+    }
+
+    // Appends the entity and the components that both archetypes have to archetype to,
+    // which must have reserved a row, and returns the new row.
+    constexpr std::uint32_t moveRow(ecs_::EntityLocation location, std::uint32_t to) noexcept
+    {
+        Archetype &src = _archetypes[location.archetype];
+        Archetype &dst = _archetypes[to];
+        auto       row = std::uint32_t(dst.size());
+
+        Archetype::forEachComponent(src.signature() & dst.signature(), [&]<std::size_t I>(std::integral_constant<std::size_t, I>)
+        {
+            using C = Archetype::template ComponentAt<I>;
+            (void) dst.template column<C>().push_back(std::move(src.template column<C>()[location.row]));
+        });
+        (void) dst.entities().push_back(src.entities()[location.row]);
+        return row;
+    }
+
+    constexpr void removeRow(ecs_::EntityLocation location) noexcept
+    {
+        Entity moved = _archetypes[location.archetype].swapRemove(location.row);
+        if (!moved.is_null()) _locations[moved].row = location.row;
+    }
+
+    SlotMap<ecs_::EntityLocation, A> _locations;
+    // Archetypes never move, so references to them survive the creation of new ones.
+    StableArrayList<Archetype, 16, A> _archetypes;
+};
+
+template<class ...Cs>
+using World = BasicWorld<ecs_::DefaultAllocator<Cs...>, Cs...>;
+} // export namespace pl::ecs
@@ -19,7 +19,7 @@
 #define PL_TRY_ASSIGN_HELPER_1(counter, var, ...) \
     auto pl_try_expr_var_##counter = (__VA_ARGS__); \
     if (!pl_try_expr_var_##counter) \
-        return ::pl::ErrorResult(std::move(pl_try_expr_var_##counter).error()); \
+        return ::pl::ErrorResult(::pl::propagateError(std::move(pl_try_expr_var_##counter).error())); \
     PL_REMOVE_PAREN_IF_EXIST(var) = *std::move(pl_try_expr_var_##counter);
 
 #define PL_TRY_DISCARD(...)                   PL_TRY_DISCARD_HELPER_0(__COUNTER__, __VA_ARGS__)
@@ -27,7 +27,7 @@
 #define PL_TRY_DISCARD_HELPER_1(counter, ...) \
     auto pl_try_expr_var_##counter = (__VA_ARGS__); \
     if (!pl_try_expr_var_##counter) \
-        return ::pl::ErrorResult(std::move(pl_try_expr_var_##counter).error());
+        return ::pl::ErrorResult(::pl::propagateError(std::move(pl_try_expr_var_##counter).error()));
 
 #ifdef NDEBUG
 #   define PL_ASSERT(...)
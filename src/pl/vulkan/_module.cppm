@@ -2,4 +2,7 @@ export module pl.vulkan;
 
 export import :config;
 export import :error;
+export import :memory;
+export import :mesh;
 export import :renderer;
+export import :staging;
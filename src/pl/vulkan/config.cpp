@@ -24,43 +24,48 @@ constexpr auto deviceExtensions = makeArray<char const *>(
 });
 } // namespace
 
-Config const g::config   = {
-    .window              = {
-        .width           = 800,
-        .height          = 600,
-        .title           = "Vulkan Window",
+Config const g::config      = {
+    .window                 = {
+        .width              = 800,
+        .height             = 600,
+        .title              = "Vulkan Window",
     },
-    .applicationName     = "Vulkan Application",
-    .applicationVersion  = VK_MAKE_API_VERSION(0, 1, 0, 0),
-    .engineName          = "No Engine",
-    .engineVersion       = VK_MAKE_API_VERSION(0, 1, 0, 0),
-    .apiVersion          = VK_MAKE_API_VERSION(0, 1, 3, 0),
-    .maxFramesInFlight   = 2,
+    .applicationName        = "Vulkan Application",
+    .applicationVersion     = VK_MAKE_API_VERSION(0, 1, 0, 0),
+    .engineName             = "No Engine",
+    .engineVersion          = VK_MAKE_API_VERSION(0, 1, 0, 0),
+    .apiVersion             = VK_MAKE_API_VERSION(0, 1, 3, 0),
+    .maxFramesInFlight      = 2,
+    .frameArenaBlockSize    = 1 << 20,
+    .stagingBufferSize      = 16 << 20,
+    .geometryVertexCapacity = 1 << 20,
+    .geometryIndexCapacity  = 1 << 22,
+    .sceneInstanceCount     = 100'000,
     .debug = {
 #ifdef NDEBUG
-        .enabled         = false,
+        .enabled            = false,
 #else
-        .enabled         = true,
+        .enabled            = true,
 #endif
-        .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT
-                         | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
-                         | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
-        .messageType     = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT
-                         | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT
-                         | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
-        .instance        = {
-            .layers      = debugInstanceLayers,
-            .extensions  = debugInstanceExtensions,
+        .messageSeverity    = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT
+                            | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
+                            | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+        .messageType        = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT
+                            | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT
+                            | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
+        .instance           = {
+            .layers         = debugInstanceLayers,
+            .extensions     = debugInstanceExtensions,
         },
-        .device          = {
-            .layers      = debugDeviceLayers,
+        .device             = {
+            .layers         = debugDeviceLayers,
         },
     },
 
     .instance = {},
 
-    .device              = {
-        .extensions      = deviceExtensions,
+    .device                 = {
+        .extensions         = deviceExtensions,
     },
 };
 } // namespace pl::vulkan
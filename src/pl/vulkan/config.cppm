@@ -1,4 +1,5 @@
 module;
+#include <cstddef>
 #include <vulkan/vulkan.h>
 
 export module pl.vulkan:config;
@@ -16,12 +17,21 @@ struct Config
         char const *title;
     } window;
 
-    char const *applicationName;
-    uint32_t    applicationVersion;
-    char const *engineName;
-    uint32_t    engineVersion;
-    uint32_t    apiVersion;
-    uint32_t    maxFramesInFlight;
+    char const  *applicationName;
+    uint32_t     applicationVersion;
+    char const  *engineName;
+    uint32_t     engineVersion;
+    uint32_t     apiVersion;
+    uint32_t     maxFramesInFlight;
+    // Block size of the scratch arena of each frame in flight.
+    std::size_t  frameArenaBlockSize;
+    // Size of the ring that uploads to device local memory are staged in.
+    VkDeviceSize stagingBufferSize;
+    // Capacity of the vertex and index buffers shared by every mesh, in elements.
+    uint32_t     geometryVertexCapacity;
+    uint32_t     geometryIndexCapacity;
+    // Number of instances drawn by the placeholder scene.
+    uint32_t     sceneInstanceCount;
 
     struct
     {
@@ -10,4 +10,5 @@ export namespace pl::vulkan
 PL_DECLARE_ERROR_TYPE(void, VulkanError, "VulkanError");
 PL_DECLARE_ERROR_TYPE(void, GLFWError, "GLFWError");
 PL_DECLARE_ERROR_TYPE(void, SystemError, "SystemError");
+PL_DECLARE_ERROR_TYPE(void, StagingRingFull, "StagingRingFull");
 } // export namespace pl::vulkan
@@ -0,0 +1,400 @@
+module;
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vulkan/vulkan.h>
+#include <vulkan/vk_enum_string_helper.h>
+#include <pl/macro.hpp>
+
+module pl.vulkan;
+
+import pl.core;
+
+namespace pl::vulkan
+{
+RE<void, SimpleError> DeviceMemoryAllocator::init(VkPhysicalDevice physicalDevice, VkDevice device) noexcept
+{
+    _physicalDevice = physicalDevice;
+    _device         = device;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_properties);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    _bufferImageGranularity = std::max<VkDeviceSize>(properties.limits.bufferImageGranularity, 1);
+    _nonCoherentAtomSize    = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize,    1);
+
+    for (DeviceMemoryStats &stats : _stats) stats = {};
+    return {};
+}
+
+
+void DeviceMemoryAllocator::deinit() noexcept
+{
+    if (DeviceMemoryStats total = totalStats(); total.numAllocations != 0)
+        std::cerr << "DeviceMemoryAllocator still has " << total.numAllocations << " live allocations\n";
+
+    for (std::uint32_t memoryType = 0; memoryType < _properties.memoryTypeCount; ++memoryType)
+    {
+        for (Pool &pool : _pools[memoryType])
+        {
+            for (Block &block : pool.blocks)
+            {
+                if (block.memory)
+                    freeMemory(memoryType, block.ranges.capacity(), block.memory);
+            }
+            pool = Pool();
+        }
+    }
+}
+
+
+Opt<std::uint32_t> DeviceMemoryAllocator::findMemoryType(
+    std::uint32_t memoryTypeBits,
+    MemoryUsage   usage) const noexcept
+{
+    VkMemoryPropertyFlags required  = 0;
+    VkMemoryPropertyFlags preferred = 0;
+    VkMemoryPropertyFlags unwanted  = 0;
+    switch (usage)
+    {
+        case MemoryUsage::deviceLocal:
+            // Host visible device local memory is scarce on discrete GPUs, e.g. the 256 MiB BAR,
+            // so it is only picked when there is nothing else, as is the case on UMA.
+            preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            unwanted  = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            break;
+        case MemoryUsage::upload:
+            required  = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            preferred = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            unwanted  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            break;
+        case MemoryUsage::readback:
+            required  = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            unwanted  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            break;
+    }
+    VkMemoryPropertyFlags excluded = VK_MEMORY_PROPERTY_PROTECTED_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+    Opt<std::uint32_t> best;
+    int bestCost = std::numeric_limits<int>::max();
+    for (std::uint32_t i = 0; i < _properties.memoryTypeCount; ++i)
+    {
+        VkMemoryPropertyFlags flags = memoryTypeFlags(i);
+        if (!(memoryTypeBits & (1u << i)) || (flags & required) != required || (flags & excluded))
+            continue;
+
+        // Missing a preferred property costs more than having an unwanted one.
+        int cost = 2 * std::popcount(preferred & ~flags) + std::popcount(unwanted & flags);
+        if (cost < bestCost)
+        {
+            best     = i;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+
+DeviceMemoryStats DeviceMemoryAllocator::totalStats() const noexcept
+{
+    DeviceMemoryStats total = {};
+    for (std::uint32_t memoryType = 0; memoryType < _properties.memoryTypeCount; ++memoryType)
+    {
+        total.numBlocks      += _stats[memoryType].numBlocks;
+        total.numAllocations += _stats[memoryType].numAllocations;
+        total.blockBytes     += _stats[memoryType].blockBytes;
+        total.allocatedBytes += _stats[memoryType].allocatedBytes;
+    }
+    return total;
+}
+
+
+VkDeviceSize DeviceMemoryAllocator::blockSizeOf(std::uint32_t memoryType) const noexcept
+{
+    VkDeviceSize heapSize = _properties.memoryHeaps[_properties.memoryTypes[memoryType].heapIndex].size;
+    return heapSize > smallHeapSize ? largeHeapBlockSize : heapSize / 8;
+}
+
+
+RE<std::byte *, SimpleError> DeviceMemoryAllocator::allocMemory(
+    std::uint32_t   memoryType,
+    VkDeviceSize    size,
+    VkDeviceMemory *memory) noexcept
+{
+    VkMemoryAllocateInfo allocateInfo = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext           = {},
+        .allocationSize  = size,
+        .memoryTypeIndex = memoryType,
+    };
+
+    VkResult result = vkAllocateMemory(_device, &allocateInfo, {}, memory);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to allocate Vulkan device memory: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+
+    void *mapped = nullptr;
+    if (memoryTypeFlags(memoryType) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        result = vkMapMemory(_device, *memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        if (result != VK_SUCCESS)
+        {
+            std::cerr << "Failed to map Vulkan device memory: " << ::string_VkResult(result) << '\n';
+            vkFreeMemory(_device, *memory, {});
+            return {tags::error, getSingleton<VulkanError>()};
+        }
+    }
+
+    ++_stats[memoryType].numBlocks;
+    _stats[memoryType].blockBytes += size;
+    return static_cast<std::byte *>(mapped);
+}
+
+
+void DeviceMemoryAllocator::freeMemory(std::uint32_t memoryType, VkDeviceSize size, VkDeviceMemory memory) noexcept
+{
+    // Freeing memory unmaps it as well.
+    vkFreeMemory(_device, memory, {});
+    --_stats[memoryType].numBlocks;
+    _stats[memoryType].blockBytes -= size;
+}
+
+
+RE<std::uint32_t, SimpleError> DeviceMemoryAllocator::addBlock(Pool &pool, std::uint32_t memoryType) noexcept
+{
+    auto slot = std::uint32_t(std::ranges::find(pool.blocks, VkDeviceMemory(), &Block::memory) - pool.blocks.begin());
+    if (slot == pool.blocks.size())
+        PL_TRY_DISCARD(pool.blocks.push_back({}));
+
+    VkDeviceSize size = blockSizeOf(memoryType);
+    Block &block = pool.blocks[slot];
+    PL_TRY_ASSIGN(block.mapped, allocMemory(memoryType, size, &block.memory));
+    block.ranges = RangeAllocator<DeviceMemoryBookkeepingAllocator<std::byte>>(size);
+    ++pool.numLiveBlocks;
+    return slot;
+}
+
+
+RE<DeviceAllocation, SimpleError> DeviceMemoryAllocator::alloc(
+    VkMemoryRequirements const &requirements,
+    MemoryUsage                 usage,
+    ResourceKind                kind) noexcept
+{
+    Opt<std::uint32_t> found = findMemoryType(requirements.memoryTypeBits, usage);
+    if (!found)
+    {
+        std::cerr << "No Vulkan memory type suits the requested memory usage\n";
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+    std::uint32_t memoryType = *found;
+
+    VkDeviceSize size      = requirements.size;
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+    // Flushes of non-coherent memory work in whole atoms, which must not spill into a neighbour.
+    if ((memoryTypeFlags(memoryType) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !isCoherent(memoryType))
+    {
+        alignment = std::max(alignment, _nonCoherentAtomSize);
+        size      = alignUp(size, _nonCoherentAtomSize);
+    }
+
+    DeviceAllocation allocation = {
+        .memory     = {},
+        .offset     = 0,
+        .size       = size,
+        .mapped     = {},
+        .memoryType = memoryType,
+        .kind       = kind,
+        .block      = dedicatedBlock,
+        .range      = {},
+    };
+
+    if (size > blockSizeOf(memoryType) / 2)
+    {
+        PL_TRY_ASSIGN(allocation.mapped, allocMemory(memoryType, size, &allocation.memory));
+    }
+    else
+    {
+        Pool &pool = poolOf(memoryType, kind);
+        for (std::uint32_t i = 0; i < pool.blocks.size() && allocation.block == dedicatedBlock; ++i)
+        {
+            if (!pool.blocks[i].memory) continue;
+            if (auto range = pool.blocks[i].ranges.alloc(size, alignment); range)
+            {
+                allocation.block = i;
+                allocation.range = *range;
+            }
+        }
+
+        if (allocation.block == dedicatedBlock)
+        {
+            PL_TRY_ASSIGN(allocation.block, addBlock(pool, memoryType));
+            PL_TRY_ASSIGN(allocation.range, pool.blocks[allocation.block].ranges.alloc(size, alignment));
+        }
+
+        Block const &block = pool.blocks[allocation.block];
+        allocation.memory = block.memory;
+        allocation.offset = allocation.range.offset;
+        allocation.mapped = block.mapped ? block.mapped + allocation.offset : nullptr;
+    }
+
+    ++_stats[memoryType].numAllocations;
+    _stats[memoryType].allocatedBytes += size;
+    return allocation;
+}
+
+
+void DeviceMemoryAllocator::free(DeviceAllocation const &allocation) noexcept
+{
+    --_stats[allocation.memoryType].numAllocations;
+    _stats[allocation.memoryType].allocatedBytes -= allocation.size;
+
+    if (allocation.block == dedicatedBlock)
+    {
+        freeMemory(allocation.memoryType, allocation.size, allocation.memory);
+        return;
+    }
+
+    Pool &pool = poolOf(allocation.memoryType, allocation.kind);
+    Block &block = pool.blocks[allocation.block];
+    block.ranges.free(allocation.range);
+
+    // The last block is kept even when empty, so that a resource recreated every frame does not
+    // allocate device memory every frame.
+    if (block.ranges.empty() && pool.numLiveBlocks > 1)
+    {
+        freeMemory(allocation.memoryType, block.ranges.capacity(), block.memory);
+        block = {};
+        --pool.numLiveBlocks;
+    }
+}
+
+
+VkMappedMemoryRange DeviceMemoryAllocator::mappedRangeOf(DeviceAllocation const &allocation) const noexcept
+{
+    // Non-coherent allocations are aligned to, and sized in, whole atoms.
+    return {
+        .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .pNext  = {},
+        .memory = allocation.memory,
+        .offset = allocation.offset,
+        .size   = allocation.size,
+    };
+}
+
+
+RE<void, SimpleError> DeviceMemoryAllocator::flush(DeviceAllocation const &allocation) noexcept
+{
+    if (!allocation.mapped || isCoherent(allocation.memoryType)) return {};
+
+    VkMappedMemoryRange range = mappedRangeOf(allocation);
+    VkResult result = vkFlushMappedMemoryRanges(_device, 1, &range);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to flush Vulkan device memory: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+    return {};
+}
+
+
+RE<void, SimpleError> DeviceMemoryAllocator::invalidate(DeviceAllocation const &allocation) noexcept
+{
+    if (!allocation.mapped || isCoherent(allocation.memoryType)) return {};
+
+    VkMappedMemoryRange range = mappedRangeOf(allocation);
+    VkResult result = vkInvalidateMappedMemoryRanges(_device, 1, &range);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to invalidate Vulkan device memory: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+    return {};
+}
+
+
+RE<Buffer, SimpleError> DeviceMemoryAllocator::createBuffer(
+    VkBufferCreateInfo const &info,
+    MemoryUsage               usage) noexcept
+{
+    bool success = false;
+    Buffer buffer;
+
+    VkResult result = vkCreateBuffer(_device, &info, {}, &buffer.buffer);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create Vulkan buffer: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+    PL_DEFER(if (!success) vkDestroyBuffer(_device, buffer.buffer, {}));
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(_device, buffer.buffer, &requirements);
+    PL_TRY_ASSIGN(buffer.allocation, alloc(requirements, usage, ResourceKind::linear));
+    PL_DEFER(if (!success) free(buffer.allocation));
+
+    result = vkBindBufferMemory(_device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to bind Vulkan buffer memory: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+
+    success = true;
+    return buffer;
+}
+
+
+void DeviceMemoryAllocator::destroyBuffer(Buffer const &buffer) noexcept
+{
+    vkDestroyBuffer(_device, buffer.buffer, {});
+    free(buffer.allocation);
+}
+
+
+RE<Image, SimpleError> DeviceMemoryAllocator::createImage(
+    VkImageCreateInfo const &info,
+    MemoryUsage              usage) noexcept
+{
+    bool success = false;
+    Image image;
+
+    VkResult result = vkCreateImage(_device, &info, {}, &image.image);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create Vulkan image: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+    PL_DEFER(if (!success) vkDestroyImage(_device, image.image, {}));
+
+    ResourceKind kind = info.tiling == VK_IMAGE_TILING_OPTIMAL ? ResourceKind::optimal : ResourceKind::linear;
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(_device, image.image, &requirements);
+    PL_TRY_ASSIGN(image.allocation, alloc(requirements, usage, kind));
+    PL_DEFER(if (!success) free(image.allocation));
+
+    result = vkBindImageMemory(_device, image.image, image.allocation.memory, image.allocation.offset);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << "Failed to bind Vulkan image memory: " << ::string_VkResult(result) << '\n';
+        return {tags::error, getSingleton<VulkanError>()};
+    }
+
+    success = true;
+    return image;
+}
+
+
+void DeviceMemoryAllocator::destroyImage(Image const &image) noexcept
+{
+    vkDestroyImage(_device, image.image, {});
+    free(image.allocation);
+}
+} // namespace pl::vulkan
@@ -0,0 +1,198 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include <pl/macro.hpp>
+
+export module pl.vulkan:memory;
+
+import pl.core;
+
+import :error;
+
+export namespace pl::vulkan
+{
+// Bookkeeping of device memory is reported under this tag.
+struct DeviceMemoryAllocations
+{
+    static constexpr char const name[] = "vulkan.memory";
+};
+
+template<class T>
+using DeviceMemoryBookkeepingAllocator = TrackingAllocator<default_allocator_t<T>, DeviceMemoryAllocations>;
+
+template<class T>
+using DeviceMemoryList = ArrayList<T, DeviceMemoryBookkeepingAllocator<T>>;
+
+enum class MemoryUsage
+{
+    deviceLocal,    // Only accessed by the GPU. Still mapped if the memory happens to be host visible, e.g. on UMA.
+    upload,         // Written by the CPU and read by the GPU, e.g. staging buffers.
+    readback,       // Written by the GPU and read by the CPU.
+};
+
+// Resources whose memory must be kept bufferImageGranularity apart when they are neighbours.
+enum class ResourceKind
+{
+    linear,         // Buffers and linearly tiled images.
+    optimal,        // Optimally tiled images.
+};
+
+struct DeviceAllocation
+{
+    VkDeviceMemory  memory;
+    VkDeviceSize    offset;
+    VkDeviceSize    size;
+    // Start of the allocation if its memory is host visible, null otherwise.
+    // Memory stays mapped for as long as it is allocated.
+    std::byte      *mapped;
+
+    std::uint32_t   memoryType;
+    ResourceKind    kind;
+    // Block the allocation was carved from, or dedicatedBlock if it has its own VkDeviceMemory.
+    std::uint32_t   block;
+    RangeAllocation range;
+};
+
+struct DeviceMemoryStats
+{
+    std::size_t  numBlocks;
+    std::size_t  numAllocations;
+    VkDeviceSize blockBytes;        // Allocated from the driver.
+    VkDeviceSize allocatedBytes;    // Handed out to resources.
+};
+
+struct Buffer
+{
+    VkBuffer         buffer;
+    DeviceAllocation allocation;
+};
+
+struct Image
+{
+    VkImage          image;
+    DeviceAllocation allocation;
+};
+
+// Sub-allocates resources out of large VkDeviceMemory blocks, since drivers only allow few allocations,
+// and make each of them slow.
+//
+// Every memory type has its own blocks, which are sub-allocated by RangeAllocator (TLSF).
+// If the device has a bufferImageGranularity above 1, linear and optimal resources get blocks of their own,
+// so neighbours never straddle a granularity page. Allocations larger than half a block get a dedicated
+// VkDeviceMemory. Host visible memory is mapped once when allocated, and stays mapped.
+//
+// Only needs a device, not a surface, so it can be used headless, e.g. against lavapipe.
+// Not thread safe.
+class DeviceMemoryAllocator
+{
+public:
+    static constexpr std::uint32_t dedicatedBlock = ~std::uint32_t(0);
+
+    // Block size of heaps larger than smallHeapSize. Smaller heaps use an eighth of their size.
+    static constexpr VkDeviceSize largeHeapBlockSize = VkDeviceSize(256) << 20;
+    static constexpr VkDeviceSize smallHeapSize      = VkDeviceSize(1)   << 30;
+
+    DeviceMemoryAllocator() = default;
+
+    DeviceMemoryAllocator           (DeviceMemoryAllocator const &) = delete;
+    DeviceMemoryAllocator &operator=(DeviceMemoryAllocator const &) = delete;
+
+    RE<void, SimpleError> init(VkPhysicalDevice physicalDevice, VkDevice device) noexcept;
+    // Frees every block. Resources still living in them become invalid.
+    void deinit() noexcept;
+
+    [[nodiscard]]
+    RE<DeviceAllocation, SimpleError> alloc(
+        VkMemoryRequirements const &requirements,
+        MemoryUsage                 usage,
+        ResourceKind                kind) noexcept;
+
+    void free(DeviceAllocation const &allocation) noexcept;
+
+    // Makes CPU writes to non-coherent memory visible to the GPU. Does nothing for coherent memory.
+    RE<void, SimpleError> flush(DeviceAllocation const &allocation) noexcept;
+    // Makes GPU writes to non-coherent memory visible to the CPU. Does nothing for coherent memory.
+    RE<void, SimpleError> invalidate(DeviceAllocation const &allocation) noexcept;
+
+    [[nodiscard]]
+    RE<Buffer, SimpleError> createBuffer(VkBufferCreateInfo const &info, MemoryUsage usage) noexcept;
+    void destroyBuffer(Buffer const &buffer) noexcept;
+
+    [[nodiscard]]
+    RE<Image, SimpleError> createImage(VkImageCreateInfo const &info, MemoryUsage usage) noexcept;
+    void destroyImage(Image const &image) noexcept;
+
+    // Memory type an allocation with these requirements would be made from.
+    [[nodiscard]]
+    Opt<std::uint32_t> findMemoryType(std::uint32_t memoryTypeBits, MemoryUsage usage) const noexcept;
+
+    [[nodiscard]]
+    VkMemoryPropertyFlags memoryTypeFlags(std::uint32_t memoryType) const noexcept
+    {
+        return _properties.memoryTypes[memoryType].propertyFlags;
+    }
+
+    [[nodiscard]]
+    DeviceMemoryStats const &stats(std::uint32_t memoryType) const noexcept
+    {
+        return _stats[memoryType];
+    }
+
+    [[nodiscard]]
+    DeviceMemoryStats totalStats() const noexcept;
+
+private:
+    struct Block
+    {
+        // Null while the block is unused, and its slot is free for the next block.
+        VkDeviceMemory                                              memory = {};
+        std::byte                                                  *mapped = {};
+        RangeAllocator<DeviceMemoryBookkeepingAllocator<std::byte>> ranges;
+    };
+
+    struct Pool
+    {
+        DeviceMemoryList<Block> blocks;
+        std::size_t             numLiveBlocks = 0;
+    };
+
+    [[nodiscard]]
+    bool isCoherent(std::uint32_t memoryType) const noexcept
+    {
+        return memoryTypeFlags(memoryType) & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+
+    [[nodiscard]]
+    Pool &poolOf(std::uint32_t memoryType, ResourceKind kind) noexcept
+    {
+        return _pools[memoryType][_bufferImageGranularity > 1 && kind == ResourceKind::optimal];
+    }
+
+    [[nodiscard]]
+    VkDeviceSize blockSizeOf(std::uint32_t memoryType) const noexcept;
+
+    [[nodiscard]]
+    RE<std::byte *, SimpleError> allocMemory(
+        std::uint32_t   memoryType,
+        VkDeviceSize    size,
+        VkDeviceMemory *memory) noexcept;
+
+    void freeMemory(std::uint32_t memoryType, VkDeviceSize size, VkDeviceMemory memory) noexcept;
+
+    [[nodiscard]]
+    RE<std::uint32_t, SimpleError> addBlock(Pool &pool, std::uint32_t memoryType) noexcept;
+
+    [[nodiscard]]
+    VkMappedMemoryRange mappedRangeOf(DeviceAllocation const &allocation) const noexcept;
+
+    VkPhysicalDevice                 _physicalDevice         = {};
+    VkDevice                         _device                 = {};
+    VkPhysicalDeviceMemoryProperties _properties             = {};
+    VkDeviceSize                     _bufferImageGranularity = 1;
+    VkDeviceSize                     _nonCoherentAtomSize    = 1;
+
+    Pool              _pools[VK_MAX_MEMORY_TYPES][2];
+    DeviceMemoryStats _stats[VK_MAX_MEMORY_TYPES] = {};
+};
+} // export namespace pl::vulkan
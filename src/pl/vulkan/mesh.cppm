@@ -0,0 +1,90 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+export module pl.vulkan:mesh;
+
+import pl.core;
+
+export namespace pl::vulkan
+{
+// Layout of vertex and instance buffers, which must match the inputs of shader.vert.
+struct Vertex
+{
+    float position[2];
+    float color[3];
+};
+
+// Per-instance data, read from a second vertex buffer at instance rate.
+struct Instance
+{
+    float offset[2];
+    float scale;
+    float tint[3];
+};
+
+constexpr std::uint32_t vertexBindingIndex   = 0;
+constexpr std::uint32_t instanceBindingIndex = 1;
+
+constexpr auto vertexBindings = makeArray<VkVertexInputBindingDescription>(
+{
+    {
+        .binding   = vertexBindingIndex,
+        .stride    = sizeof(Vertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+    },
+    {
+        .binding   = instanceBindingIndex,
+        .stride    = sizeof(Instance),
+        .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
+    },
+});
+
+constexpr auto vertexAttributes = makeArray<VkVertexInputAttributeDescription>(
+{
+    {
+        .location = 0,
+        .binding  = vertexBindingIndex,
+        .format   = VK_FORMAT_R32G32_SFLOAT,
+        .offset   = offsetof(Vertex, position),
+    },
+    {
+        .location = 1,
+        .binding  = vertexBindingIndex,
+        .format   = VK_FORMAT_R32G32B32_SFLOAT,
+        .offset   = offsetof(Vertex, color),
+    },
+    {
+        .location = 2,
+        .binding  = instanceBindingIndex,
+        .format   = VK_FORMAT_R32G32_SFLOAT,
+        .offset   = offsetof(Instance, offset),
+    },
+    {
+        .location = 3,
+        .binding  = instanceBindingIndex,
+        .format   = VK_FORMAT_R32_SFLOAT,
+        .offset   = offsetof(Instance, scale),
+    },
+    {
+        .location = 4,
+        .binding  = instanceBindingIndex,
+        .format   = VK_FORMAT_R32G32B32_SFLOAT,
+        .offset   = offsetof(Instance, tint),
+    },
+});
+
+using Index = std::uint32_t;
+
+constexpr VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+
+// Meshes share the vertex and index buffers of the renderer, so that draws of different meshes
+// only differ in their offsets, and can be packed into a single indirect draw.
+// Ranges are in elements, not bytes. An empty index range means no mesh.
+struct Mesh
+{
+    RangeAllocation vertices;
+    RangeAllocation indices;
+};
+} // export namespace pl::vulkan
@@ -1,5 +1,6 @@
 module;
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cerrno>
 #include <cstddef>
@@ -72,7 +73,7 @@ RE<void, SimpleError> SurfaceInfo::query(VkPhysicalDevice device, VkSurfaceKHR s
             << ::string_VkResult(result) << '\n';
         return {tags::error, getSingleton<VulkanError>()};
     }
-    PL_TRY_DISCARD(formats.resize(count));
+    PL_TRY_DISCARD(formats.resize_for_overwrite(count));
     result = vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &count, formats.data());
     if (result != VK_SUCCESS)
     {
@@ -90,7 +91,7 @@ RE<void, SimpleError> SurfaceInfo::query(VkPhysicalDevice device, VkSurfaceKHR s
             << ::string_VkResult(result) << '\n';
         return {tags::error, getSingleton<VulkanError>()};
     }
-    PL_TRY_DISCARD(presentModes.resize(count));
+    PL_TRY_DISCARD(presentModes.resize_for_overwrite(count));
     result = vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &count, presentModes.data());
     if (result != VK_SUCCESS)
     {
@@ -175,7 +176,7 @@ RE<void, SimpleError> DeviceInfo::query(VkPhysicalDevice device, VkSurfaceKHR su
         return {tags::error, getSingleton<VulkanError>()};
     }
 
-    PL_TRY_DISCARD(extensions.resize(count));
+    PL_TRY_DISCARD(extensions.resize_for_overwrite(count));
     result = vkEnumerateDeviceExtensionProperties(device, {}, &count, extensions.data());
     if (result != VK_SUCCESS)
     {
@@ -185,9 +186,31 @@ RE<void, SimpleError> DeviceInfo::query(VkPhysicalDevice device, VkSurfaceKHR su
         return {tags::error, getSingleton<VulkanError>()};
     }
 
+    extensionNames.clear();
+    PL_TRY_DISCARD(extensionNames.reserve(extensions.size()));
+    for (auto &extension : extensions)
+    {
+        PL_TRY_ASSIGN(Name name, Name::intern(extension.extensionName));
+        PL_TRY_DISCARD(extensionNames.insert(name));
+    }
+
     vkGetPhysicalDeviceFeatures(device, &features);
+    drawIndirectCount = false;
+    if (properties.apiVersion >= VK_API_VERSION_1_2)
+    {
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 features2 = {
+            .sType    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext    = &vulkan12Features,
+            .features = {},
+        };
+        vkGetPhysicalDeviceFeatures2(device, &features2);
+        drawIndirectCount = vulkan12Features.drawIndirectCount;
+    }
+
     vkGetPhysicalDeviceQueueFamilyProperties(device, &count, {});
-    PL_TRY_DISCARD(queueFamiliesProperties.resize(count));
+    PL_TRY_DISCARD(queueFamiliesProperties.resize_for_overwrite(count));
     vkGetPhysicalDeviceQueueFamilyProperties(device, &count, queueFamiliesProperties.data());
 
     PL_TRY_DISCARD(queues.query(device, surface, queueFamiliesProperties));
@@ -200,18 +223,11 @@ bool DeviceInfo::isSuitable() const noexcept
 {
     for (char const *extension : g::config.device.extensions)
     {
-        bool found = false;
-        for (auto &available : extensions)
-        {
-            if (std::strcmp(extension, available.extensionName) == 0)
-            {
-                found = true;
-                break;
-            }
-        }
-        if (!found) return false;
+        Opt<Name> name = Name::find(extension);
+        if (!name || !extensionNames.contains(*name)) return false;
     }
-    return queues.isComplete();
+    // Draws of batches start at their instances through firstInstance.
+    return features.drawIndirectFirstInstance && queues.isComplete();
 }
 
 
@@ -228,14 +244,121 @@ RE<ArrayList<std::byte>, SimpleError> loadFile(char const *filename) noexcept
 
     ArrayList<std::byte> buffer;
     auto fileSize = file.tellg();
-    PL_TRY_DISCARD(buffer.resize((std::size_t) fileSize));
     file.seekg(0);
-    file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+    PL_TRY_DISCARD(buffer.append_and_overwrite((std::size_t) fileSize, [&](Span<std::byte> bytes)
+    {
+        file.read(reinterpret_cast<char*>(bytes.data()), std::streamsize(bytes.size()));
+        return (std::size_t) file.gcount();
+    }));
 
     return buffer;
 }
 
 
+RE<void, SimpleError> DrawList::add(Mesh const &mesh, Instance const &instance) noexcept
+{
+    PL_TRY_ASSIGN(Batch *batch, batchOf(mesh));
+    PL_TRY_DISCARD(batch->instances.push_back(instance));
+    ++_numInstances;
+    ++_generation;
+    return {};
+}
+
+
+RE<void, SimpleError> DrawList::add(Mesh const &mesh, Span<Instance const> instances) noexcept
+{
+    if (instances.empty()) return {};
+
+    PL_TRY_ASSIGN(Batch *batch, batchOf(mesh));
+    PL_TRY_DISCARD(batch->instances.append(instances.begin(), instances.end()));
+    _numInstances += instances.size();
+    ++_generation;
+    return {};
+}
+
+
+void DrawList::clear() noexcept
+{
+    for (Batch &batch : _batches) batch.instances.clear();
+    _numInstances = 0;
+    ++_generation;
+}
+
+
+std::uint32_t DrawList::write(Span<Instance> instances, Span<VkDrawIndexedIndirectCommand> commands) const noexcept
+{
+    PL_ASSERT(instances.size() >= _numInstances && commands.size() >= _batches.size());
+
+    uint32_t numCommands   = 0;
+    uint32_t firstInstance = 0;
+    for (Batch const &batch : _batches)
+    {
+        if (batch.instances.empty()) continue;
+
+        std::memcpy(instances.data() + firstInstance, batch.instances.data(), sizeof(Instance) * batch.instances.size());
+        commands[numCommands++] = {
+            .indexCount    = (uint32_t) batch.mesh.indices.size,
+            .instanceCount = (uint32_t) batch.instances.size(),
+            .firstIndex    = (uint32_t) batch.mesh.indices.offset,
+            .vertexOffset  = (int32_t) batch.mesh.vertices.offset,
+            .firstInstance = firstInstance,
+        };
+        firstInstance += (uint32_t) batch.instances.size();
+    }
+    return numCommands;
+}
+
+
+RE<DrawList::Batch *, SimpleError> DrawList::batchOf(Mesh const &mesh) noexcept
+{
+    PL_ASSERT(mesh.indices.size != 0);
+
+    if (_lastBatch >= _batches.size() || _batches[_lastBatch].mesh.indices.offset != mesh.indices.offset)
+    {
+        if (auto it = _batchIndices.find(mesh.indices.offset); it != _batchIndices.end())
+        {
+            _lastBatch = it->second;
+        }
+        else
+        {
+            PL_TRY_DISCARD(_batches.push_back(Batch{.mesh = mesh, .instances = RendererList<Instance>()}));
+            auto inserted = _batchIndices.try_emplace(mesh.indices.offset, (uint32_t) _batches.size() - 1);
+            if (!inserted)
+            {
+                _batches.pop_back();
+                return {tags::error, std::move(inserted).error()};
+            }
+            _lastBatch = (uint32_t) _batches.size() - 1;
+        }
+    }
+
+    // A mesh destroyed and created again may reuse the indices of an old one, but not its vertices.
+    Batch &batch = _batches[_lastBatch];
+    batch.mesh   = mesh;
+    return &batch;
+}
+
+
+namespace
+{
+// Placeholder scene, until meshes are loaded from files.
+constexpr Vertex triangleVertices[] = {
+    {.position = { 0.0f, -0.5f}, .color = {1.0f, 0.0f, 0.0f}},
+    {.position = { 0.5f,  0.5f}, .color = {0.0f, 1.0f, 0.0f}},
+    {.position = {-0.5f,  0.5f}, .color = {0.0f, 0.0f, 1.0f}},
+};
+constexpr Index triangleIndices[] = {0, 1, 2};
+
+constexpr Vertex quadVertices[] = {
+    {.position = {-0.5f, -0.5f}, .color = {1.0f, 1.0f, 0.0f}},
+    {.position = { 0.5f, -0.5f}, .color = {0.0f, 1.0f, 1.0f}},
+    {.position = { 0.5f,  0.5f}, .color = {1.0f, 0.0f, 1.0f}},
+    {.position = {-0.5f,  0.5f}, .color = {1.0f, 1.0f, 1.0f}},
+};
+constexpr Index quadIndices[] = {0, 1, 2, 2, 3, 0};
+} // namespace
+
+
 RE<void, SimpleError> Renderer::init() noexcept
 {
     bool success = false;
@@ -268,6 +391,9 @@ RE<void, SimpleError> Renderer::init() noexcept
         &_presentQueue));
     PL_DEFER(if (!success) vkDestroyDevice(_device, {}));
 
+    PL_TRY_DISCARD(_deviceMemory.init(_physicalDevice, _device));
+    PL_DEFER(if (!success) _deviceMemory.deinit());
+
     PL_TRY_DISCARD(createCommandPool(
         _deviceInfo, 
         _device, 
@@ -337,6 +463,33 @@ RE<void, SimpleError> Renderer::init() noexcept
         _imageAvailableSemaphores.clear();
     });
 
+    PL_TRY_DISCARD(createFrameArenas(&_frameArenas));
+
+    PL_TRY_DISCARD(_staging.init(&_deviceMemory, g::config.stagingBufferSize, g::config.maxFramesInFlight));
+    PL_DEFER(if (!success) _staging.deinit());
+
+    PL_TRY_DISCARD(createGeometryBuffers());
+    PL_DEFER(
+    if (!success)
+    {
+        _deviceMemory.destroyBuffer(_indexBuffer);
+        _deviceMemory.destroyBuffer(_vertexBuffer);
+    });
+
+    PL_TRY_DISCARD(_frameDraws.resize(g::config.maxFramesInFlight));
+    PL_DEFER(
+    if (!success)
+    {
+        for (FrameDraws &draws : _frameDraws)
+        {
+            if (draws.commands.buffer)  _deviceMemory.destroyBuffer(draws.commands);
+            if (draws.instances.buffer) _deviceMemory.destroyBuffer(draws.instances);
+        }
+        _frameDraws.clear();
+    });
+
+    PL_TRY_DISCARD(createScene());
+
     success = true;
     return {};
 }
@@ -361,6 +514,16 @@ void Renderer::deinit() noexcept
 
     vkDestroySwapchainKHR(_device, _swapchain, {});
     vkDestroyCommandPool(_device, _commandPool, {});
+    for (FrameDraws &draws : _frameDraws)
+    {
+        if (draws.commands.buffer)  _deviceMemory.destroyBuffer(draws.commands);
+        if (draws.instances.buffer) _deviceMemory.destroyBuffer(draws.instances);
+    }
+    for (Mesh const &mesh : _sceneMeshes) destroyMesh(mesh);
+    _deviceMemory.destroyBuffer(_indexBuffer);
+    _deviceMemory.destroyBuffer(_vertexBuffer);
+    _staging.deinit();
+    _deviceMemory.deinit();
     vkDestroyDevice(_device, {});
     vkDestroySurfaceKHR(_instance, _surface, {});
 
@@ -369,6 +532,15 @@ void Renderer::deinit() noexcept
 
     vkDestroyInstance(_instance, {});
     glfwDestroyWindow(_window);
+
+    _frameArenas  = FrameArenaList();
+    _frameDraws   = PerFrameList<FrameDraws>();
+    _drawList     = DrawList();
+    _vertexRanges = GeometryRanges();
+    _indexRanges  = GeometryRanges();
+
+    if constexpr (allocationTrackingEnabled)
+        writeAllocationReport(std::clog);
 }
 
 
@@ -462,7 +634,7 @@ RE<void, SimpleError> Renderer::createInstance(
     uint32_t count = 0;
     VkResult result;
 
-    ArrayList<VkLayerProperties> layerProperties;
+    RendererList<VkLayerProperties> layerProperties;
     result = vkEnumerateInstanceLayerProperties(&count, {});
     if (result != VK_SUCCESS)
     {
@@ -471,7 +643,7 @@ RE<void, SimpleError> Renderer::createInstance(
             ::string_VkResult(result) << '\n';
         return {tags::error, getSingleton<VulkanError>()};
     }
-    PL_TRY_DISCARD(layerProperties.resize(count));
+    PL_TRY_DISCARD(layerProperties.resize_for_overwrite(count));
     result = vkEnumerateInstanceLayerProperties(&count, layerProperties.data());
     if (result != VK_SUCCESS)
     {
@@ -485,7 +657,15 @@ RE<void, SimpleError> Renderer::createInstance(
     for (auto &p : layerProperties) std::clog << '\t' << p.layerName << '\n';
     std::clog << '\n';
 
-    ArrayList<VkExtensionProperties> extensionProperties;
+    RendererHashSet<Name> layerNames;
+    PL_TRY_DISCARD(layerNames.reserve(layerProperties.size()));
+    for (auto &p : layerProperties)
+    {
+        PL_TRY_ASSIGN(Name name, Name::intern(p.layerName));
+        PL_TRY_DISCARD(layerNames.insert(name));
+    }
+
+    RendererList<VkExtensionProperties> extensionProperties;
     result = vkEnumerateInstanceExtensionProperties({}, &count, {});
     if (result != VK_SUCCESS)
     {
@@ -494,7 +674,7 @@ RE<void, SimpleError> Renderer::createInstance(
             ::string_VkResult(result) << '\n';
         return {tags::error, getSingleton<VulkanError>()};
     }
-    PL_TRY_DISCARD(extensionProperties.resize(count));
+    PL_TRY_DISCARD(extensionProperties.resize_for_overwrite(count));
     result = vkEnumerateInstanceExtensionProperties({}, &count, extensionProperties.data());
     if (result != VK_SUCCESS)
     {
@@ -508,6 +688,14 @@ RE<void, SimpleError> Renderer::createInstance(
     for (auto &p : extensionProperties) std::clog << '\t' << p.extensionName << '\n';
     std::clog << '\n';
 
+    RendererHashSet<Name> extensionNames;
+    PL_TRY_DISCARD(extensionNames.reserve(extensionProperties.size()));
+    for (auto &p : extensionProperties)
+    {
+        PL_TRY_ASSIGN(Name name, Name::intern(p.extensionName));
+        PL_TRY_DISCARD(extensionNames.insert(name));
+    }
+
     ArrayList<char const *> layers;
 #ifndef NDEBUG
     auto &debugLayers = c.debug.instance.layers;
@@ -521,10 +709,7 @@ RE<void, SimpleError> Renderer::createInstance(
     std::clog << "Checking for available layers...\n";
     for (auto &layer : layers)
     {
-        if (std::find_if(
-            layerProperties.begin(), layerProperties.end(),
-            [&](auto &p) { return std::strcmp(layer, p.layerName) == 0; })
-            != layerProperties.end())
+        if (Opt<Name> name = Name::find(layer); name && layerNames.contains(*name))
         {
             std::clog << "FOUND " << layer << '\n';
         }
@@ -550,10 +735,7 @@ RE<void, SimpleError> Renderer::createInstance(
     std::clog << "Checking for available extensions...\n";
     for (auto &ext : extensions)
     {
-        if (std::find_if(
-            extensionProperties.begin(), extensionProperties.end(),
-            [&](auto &p) { return std::strcmp(ext, p.extensionName) == 0; })
-            != extensionProperties.end())
+        if (Opt<Name> name = Name::find(ext); name && extensionNames.contains(*name))
         {
             std::clog << "FOUND " << ext << '\n';
         }
@@ -659,8 +841,8 @@ RE<void, SimpleError> Renderer::createDevice(
 
     uint32_t count = 0;
     vkEnumeratePhysicalDevices(instance, &count, {});
-    ArrayList<VkPhysicalDevice> devices;
-    PL_TRY_DISCARD(devices.resize(count));
+    SmallRendererList<VkPhysicalDevice, 4> devices;
+    PL_TRY_DISCARD(devices.resize_for_overwrite(count));
     vkEnumeratePhysicalDevices(instance, &count, devices.data());
 
     bool found = false;
@@ -695,7 +877,7 @@ RE<void, SimpleError> Renderer::createDevice(
             .pQueuePriorities = &queuePriority,
         };
     };
-    ArrayList<VkDeviceQueueCreateInfo> queueInfos;
+    SmallRendererList<VkDeviceQueueCreateInfo, 2> queueInfos;
     auto &queueIndices = deviceInfo->queues.indices;
     PL_TRY_DISCARD(queueInfos.push_back(createQueueInfo(queueIndices.graphicsFamily)));
     if (queueIndices.graphicsFamily != queueIndices.presentFamily)
@@ -703,12 +885,21 @@ RE<void, SimpleError> Renderer::createDevice(
         PL_TRY_DISCARD(queueInfos.push_back(createQueueInfo(queueIndices.presentFamily)));
     }
 
+    // Only what batched indirect draws use is enabled. Without multiDrawIndirect, batches are drawn one by one.
+    VkPhysicalDeviceFeatures supported = deviceInfo->features;
     VkPhysicalDeviceFeatures features{};
+    features.multiDrawIndirect         = supported.multiDrawIndirect;
+    features.drawIndirectFirstInstance = supported.drawIndirectFirstInstance;
     deviceInfo->features = features;
 
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.drawIndirectCount = deviceInfo->drawIndirectCount;
+
     VkDeviceCreateInfo deviceCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = {},
+        // Only devices of Vulkan 1.2 and later know of Vulkan12Features.
+        .pNext = deviceInfo->properties.apiVersion >= VK_API_VERSION_1_2 ? &vulkan12Features : nullptr,
         .flags = {},
         .queueCreateInfoCount = (uint32_t) queueInfos.size(),
         .pQueueCreateInfos = queueInfos.data(),
@@ -741,10 +932,10 @@ RE<void, SimpleError> Renderer::createDevice(
 
 
 RE<void, SimpleError> Renderer::createCommandPool(
-    DeviceInfo const           &deviceInfo,
-    VkDevice                    device,
-    VkCommandPool              *commandPool,
-    ArrayList<VkCommandBuffer> *commandBuffers) noexcept
+    DeviceInfo const              &deviceInfo,
+    VkDevice                       device,
+    VkCommandPool                 *commandPool,
+    PerFrameList<VkCommandBuffer> *commandBuffers) noexcept
 {
     bool success = false;
     VkResult result;
@@ -763,7 +954,7 @@ RE<void, SimpleError> Renderer::createCommandPool(
     }
     PL_DEFER(if (!success) vkDestroyCommandPool(device, *commandPool, {}));
 
-    PL_TRY_DISCARD(commandBuffers->resize(g::config.maxFramesInFlight));
+    PL_TRY_DISCARD(commandBuffers->resize_for_overwrite(g::config.maxFramesInFlight));
     VkCommandBufferAllocateInfo allocInfo = {
         .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .commandPool        = *commandPool,
@@ -790,8 +981,8 @@ RE<void, SimpleError> Renderer::createSwapchain(
     SwapchainConfiguration const &config,
     VkDevice                      device,
     VkSwapchainKHR               *swapchain,
-    ArrayList<VkImage>           *swapchainImages,
-    ArrayList<VkImageView>       *swapchainImageViews) noexcept
+    RendererList<VkImage>        *swapchainImages,
+    RendererList<VkImageView>    *swapchainImageViews) noexcept
 {
     bool success = false;
 
@@ -844,7 +1035,7 @@ RE<void, SimpleError> Renderer::createSwapchain(
         std::cerr << "Failed to retrieve Vulkan swapchain images: " << ::string_VkResult(result) << '\n';
         return {tags::error, getSingleton<VulkanError>()};
     }
-    PL_TRY_DISCARD(swapchainImages->resize(count));
+    PL_TRY_DISCARD(swapchainImages->resize_for_overwrite(count));
     result = vkGetSwapchainImagesKHR(device, *swapchain, &count, swapchainImages->data());
     if (result != VK_SUCCESS)
     {
@@ -852,7 +1043,7 @@ RE<void, SimpleError> Renderer::createSwapchain(
         return {tags::error, getSingleton<VulkanError>()};
     }
 
-    PL_TRY_DISCARD(swapchainImageViews->resize(swapchainImages->size()));
+    PL_TRY_DISCARD(swapchainImageViews->resize_for_overwrite(swapchainImages->size()));
     unsigned numImageViewsCreated = 0;
     PL_DEFER(
     if (!success)
@@ -934,7 +1125,7 @@ RE<void, SimpleError> Renderer::createGraphicsPipeline(
     SwapchainConfiguration const &swapchainConfig,
     Span<VkImageView const>         swapchainImageViews,
     VkRenderPass                 *renderPass,
-    ArrayList<VkFramebuffer>     *swapchainFramebuffers,
+    RendererList<VkFramebuffer>  *swapchainFramebuffers,
     VkPipelineLayout             *pipelineLayout,
     VkPipeline                   *pipeline) noexcept
 {
@@ -1005,7 +1196,7 @@ RE<void, SimpleError> Renderer::createGraphicsPipeline(
         .layers = 1,
     };
 
-    PL_TRY_DISCARD(swapchainFramebuffers->resize(swapchainImageViews.size()));
+    PL_TRY_DISCARD(swapchainFramebuffers->resize_for_overwrite(swapchainImageViews.size()));
     unsigned numSwapchainFramebuffersCreated = 0;
     PL_DEFER(
     if (!success)
@@ -1082,10 +1273,10 @@ RE<void, SimpleError> Renderer::createGraphicsPipeline(
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext = {},
         .flags = {},
-        .vertexBindingDescriptionCount = {},
-        .pVertexBindingDescriptions = {},
-        .vertexAttributeDescriptionCount = {},
-        .pVertexAttributeDescriptions = {},
+        .vertexBindingDescriptionCount = (uint32_t) vertexBindings.size(),
+        .pVertexBindingDescriptions = vertexBindings.data(),
+        .vertexAttributeDescriptionCount = (uint32_t) vertexAttributes.size(),
+        .pVertexAttributeDescriptions = vertexAttributes.data(),
     };
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembleInfo = {
@@ -1203,11 +1394,29 @@ RE<void, SimpleError> Renderer::createGraphicsPipeline(
 }
 
 
+RE<void, SimpleError> Renderer::createFrameArenas(FrameArenaList *frameArenas) noexcept
+{
+    bool success = false;
+    PL_DEFER(if (!success) frameArenas->clear());
+
+    PL_TRY_DISCARD(frameArenas->reserve(g::config.maxFramesInFlight));
+    for (uint32_t i = 0; i < g::config.maxFramesInFlight; ++i)
+    {
+        PL_TRY_DISCARD(frameArenas->emplace_back(g::config.frameArenaBlockSize));
+        // Allocate the first block now, so that not even the first frames allocate.
+        PL_TRY_DISCARD(frameArenas->back().reserve());
+    }
+
+    success = true;
+    return {};
+}
+
+
 RE<void, SimpleError> Renderer::createSynchronizationObjects(
     VkDevice     device,
-    ArrayList<VkSemaphore> *imageAvailableSemaphores,
-    ArrayList<VkSemaphore> *renderFinishedSemaphores,
-    ArrayList<VkFence>     *inFlightFences) noexcept
+    PerFrameList<VkSemaphore> *imageAvailableSemaphores,
+    PerFrameList<VkSemaphore> *renderFinishedSemaphores,
+    PerFrameList<VkFence>     *inFlightFences) noexcept
 {
     bool success = false;
     VkSemaphoreCreateInfo semaphoreInfo = {
@@ -1224,9 +1433,9 @@ RE<void, SimpleError> Renderer::createSynchronizationObjects(
 
     VkResult result;
 
-    PL_TRY_DISCARD(imageAvailableSemaphores->resize(g::config.maxFramesInFlight));
-    PL_TRY_DISCARD(renderFinishedSemaphores->resize(g::config.maxFramesInFlight));
-    PL_TRY_DISCARD(inFlightFences          ->resize(g::config.maxFramesInFlight));
+    PL_TRY_DISCARD(imageAvailableSemaphores->resize_for_overwrite(g::config.maxFramesInFlight));
+    PL_TRY_DISCARD(renderFinishedSemaphores->resize_for_overwrite(g::config.maxFramesInFlight));
+    PL_TRY_DISCARD(inFlightFences          ->resize_for_overwrite(g::config.maxFramesInFlight));
 
     uint32_t numImageAvailableSemaphoresCreated = 0;
     uint32_t numRenderFinishedSemaphoresCreated = 0;
@@ -1305,6 +1514,8 @@ RE<void, SimpleError> Renderer::recordCommandBuffer(
         return {tags::error, getSingleton<VulkanError>()};
     }
 
+    PL_TRY_DISCARD(_staging.record(commandBuffer, _currentFrame));
+
     VkClearValue clearColor = {.color{.float32 = {0.0f, 0.0f, 0.0f, 1.0f}}};
     VkRenderPassBeginInfo renderPassInfo = {
         .sType       = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
@@ -1338,7 +1549,7 @@ RE<void, SimpleError> Renderer::recordCommandBuffer(
     };
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    recordDraws(commandBuffer, _frameDraws[_currentFrame]);
 
     vkCmdEndRenderPass(commandBuffer);
 
@@ -1363,6 +1574,11 @@ RE<void, SimpleError> Renderer::drawFrame() noexcept
         return {tags::error, getSingleton<VulkanError>()};
     }
 
+    // The GPU is done with this frame in flight, and so with everything allocated for it.
+    _frameArenas[_currentFrame].reset();
+    _staging.beginFrame(_currentFrame);
+    PL_TRY_DISCARD(writeDraws(&_frameDraws[_currentFrame]));
+
     result = vkResetFences(_device, 1, &_inFlightFences[_currentFrame]);
     if (result != VK_SUCCESS)
     {
@@ -1439,6 +1655,211 @@ RE<void, SimpleError> Renderer::drawFrame() noexcept
 }
 
 
+RE<void, SimpleError> Renderer::upload(
+    Buffer const         &destination,
+    VkDeviceSize          offset,
+    Span<std::byte const> data) noexcept
+{
+    if (data.empty()) return {};
+
+    if (std::byte *mapped = destination.allocation.mapped; mapped)
+    {
+        // Device local memory that is also host visible, e.g. on UMA, needs no staging copy.
+        std::memcpy(mapped + offset, data.data(), data.size());
+        return _deviceMemory.flush(destination.allocation);
+    }
+    return _staging.stage(destination.buffer, offset, data);
+}
+
+
+RE<Mesh, SimpleError> Renderer::createMesh(Span<Vertex const> vertices, Span<Index const> indices) noexcept
+{
+    PL_ASSERT(!vertices.empty() && !indices.empty());
+
+    bool success = false;
+    Mesh mesh = {};
+
+    PL_TRY_ASSIGN(mesh.vertices, _vertexRanges.alloc(vertices.size()));
+    PL_DEFER(if (!success) _vertexRanges.free(mesh.vertices));
+    PL_TRY_ASSIGN(mesh.indices, _indexRanges.alloc(indices.size()));
+    PL_DEFER(if (!success) _indexRanges.free(mesh.indices));
+
+    // Copies into ranges that are about to be handed out again must not be recorded.
+    StagingRing::Mark mark = _staging.mark();
+    PL_DEFER(if (!success) _staging.rollback(mark));
+
+    PL_TRY_DISCARD(upload(_vertexBuffer, sizeof(Vertex) * mesh.vertices.offset, {
+            reinterpret_cast<std::byte const *>(vertices.data()), sizeof(Vertex) * vertices.size()}));
+    PL_TRY_DISCARD(upload(_indexBuffer, sizeof(Index) * mesh.indices.offset, {
+            reinterpret_cast<std::byte const *>(indices.data()), sizeof(Index) * indices.size()}));
+
+    success = true;
+    return mesh;
+}
+
+
+void Renderer::destroyMesh(Mesh const &mesh) noexcept
+{
+    if (mesh.indices.size == 0) return;
+
+    _indexRanges.free(mesh.indices);
+    _vertexRanges.free(mesh.vertices);
+}
+
+
+RE<void, SimpleError> Renderer::createGeometryBuffers() noexcept
+{
+    bool success = false;
+    auto &c = g::config;
+
+    VkBufferCreateInfo bufferInfo = {
+        .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext                 = {},
+        .flags                 = {},
+        .size                  = sizeof(Vertex) * VkDeviceSize(c.geometryVertexCapacity),
+        .usage                 = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = {},
+        .pQueueFamilyIndices   = {},
+    };
+    PL_TRY_ASSIGN(_vertexBuffer, _deviceMemory.createBuffer(bufferInfo, MemoryUsage::deviceLocal));
+    PL_DEFER(if (!success) _deviceMemory.destroyBuffer(_vertexBuffer));
+
+    bufferInfo.size  = sizeof(Index) * VkDeviceSize(c.geometryIndexCapacity);
+    bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    PL_TRY_ASSIGN(_indexBuffer, _deviceMemory.createBuffer(bufferInfo, MemoryUsage::deviceLocal));
+
+    _vertexRanges = GeometryRanges(c.geometryVertexCapacity);
+    _indexRanges  = GeometryRanges(c.geometryIndexCapacity);
+
+    success = true;
+    return {};
+}
+
+
+RE<void, SimpleError> Renderer::createScene() noexcept
+{
+    PL_TRY_ASSIGN(_sceneMeshes[0], createMesh(triangleVertices, triangleIndices));
+    PL_TRY_ASSIGN(_sceneMeshes[1], createMesh(quadVertices, quadIndices));
+
+    // A square grid of instances over the whole window, with rows alternating between the meshes.
+    uint32_t count = g::config.sceneInstanceCount;
+    uint32_t side  = 1;
+    while (side * side < count) ++side;
+
+    float cell = 2.0f / float(side);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t x = i % side;
+        uint32_t y = i / side;
+        Instance instance = {
+            .offset = {-1.0f + cell * (float(x) + 0.5f), -1.0f + cell * (float(y) + 0.5f)},
+            .scale  = cell * 0.8f,
+            .tint   = {0.5f + 0.5f * float(x) / float(side), 0.5f + 0.5f * float(y) / float(side), 1.0f},
+        };
+        PL_TRY_DISCARD(_drawList.add(_sceneMeshes[y % 2], instance));
+    }
+    return {};
+}
+
+
+RE<void, SimpleError> Renderer::reserveFrameBuffer(
+    Buffer             *buffer,
+    VkDeviceSize       *capacity,
+    VkDeviceSize        size,
+    VkBufferUsageFlags  usage) noexcept
+{
+    if (size <= *capacity) return {};
+
+    // Grows geometrically, so that a growing draw list is not reallocated every frame.
+    VkDeviceSize newCapacity = std::max(std::bit_ceil(size), VkDeviceSize(4096));
+    VkBufferCreateInfo bufferInfo = {
+        .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext                 = {},
+        .flags                 = {},
+        .size                  = newCapacity,
+        .usage                 = usage,
+        .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = {},
+        .pQueueFamilyIndices   = {},
+    };
+    PL_TRY_ASSIGN(Buffer newBuffer, _deviceMemory.createBuffer(bufferInfo, MemoryUsage::upload));
+    if (buffer->buffer) _deviceMemory.destroyBuffer(*buffer);
+
+    *buffer   = newBuffer;
+    *capacity = newCapacity;
+    return {};
+}
+
+
+RE<void, SimpleError> Renderer::writeDraws(FrameDraws *draws) noexcept
+{
+    if (draws->generation == _drawList.generation()) return {};
+
+    std::size_t numInstances = _drawList.numInstances();
+    std::size_t numBatches   = _drawList.numBatches();
+
+    draws->numCommands = 0;
+    if (numInstances != 0)
+    {
+        PL_TRY_DISCARD(reserveFrameBuffer(
+            &draws->instances,
+            &draws->instancesCapacity,
+            sizeof(Instance) * numInstances,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT));
+        PL_TRY_DISCARD(reserveFrameBuffer(
+            &draws->commands,
+            &draws->commandsCapacity,
+            drawCommandsOffset + sizeof(VkDrawIndexedIndirectCommand) * numBatches,
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT));
+
+        // Upload memory is always mapped. Host writes are visible to the GPU once the frame is submitted.
+        std::byte *commands = draws->commands.allocation.mapped;
+        draws->numCommands  = _drawList.write(
+            {reinterpret_cast<Instance *>(draws->instances.allocation.mapped), numInstances},
+            {reinterpret_cast<VkDrawIndexedIndirectCommand *>(commands + drawCommandsOffset), numBatches});
+        std::memcpy(commands, &draws->numCommands, sizeof(draws->numCommands));
+
+        PL_TRY_DISCARD(_deviceMemory.flush(draws->instances.allocation));
+        PL_TRY_DISCARD(_deviceMemory.flush(draws->commands.allocation));
+    }
+
+    draws->generation = _drawList.generation();
+    return {};
+}
+
+
+void Renderer::recordDraws(VkCommandBuffer commandBuffer, FrameDraws const &draws) noexcept
+{
+    if (draws.numCommands == 0) return;
+
+    VkBuffer     vertexBuffers[] = {_vertexBuffer.buffer, draws.instances.buffer};
+    VkDeviceSize vertexOffsets[] = {0, 0};
+    vkCmdBindVertexBuffers(commandBuffer, vertexBindingIndex, 2, vertexBuffers, vertexOffsets);
+    vkCmdBindIndexBuffer(commandBuffer, _indexBuffer.buffer, 0, indexType);
+
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (_deviceInfo.drawIndirectCount)
+    {
+        // The count is read by the GPU, so that culling on the GPU can lower it later on.
+        vkCmdDrawIndexedIndirectCount(
+            commandBuffer,
+            draws.commands.buffer, drawCommandsOffset,
+            draws.commands.buffer, 0,
+            draws.numCommands, stride);
+    }
+    else if (_deviceInfo.features.multiDrawIndirect)
+    {
+        vkCmdDrawIndexedIndirect(commandBuffer, draws.commands.buffer, drawCommandsOffset, draws.numCommands, stride);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < draws.numCommands; ++i)
+            vkCmdDrawIndexedIndirect(commandBuffer, draws.commands.buffer, drawCommandsOffset + i * stride, 1, stride);
+    }
+}
+
+
 RE<void, SimpleError> Renderer::regenerateSwapchain() noexcept
 {
     vkDeviceWaitIdle(_device);
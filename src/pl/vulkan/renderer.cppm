@@ -1,8 +1,12 @@
 module;
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <functional>
 #include <limits>
+#include <type_traits>
 #include <utility>
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
@@ -13,9 +17,48 @@ export module pl.vulkan:renderer;
 import pl.core;
 
 import :error;
+import :memory;
+import :mesh;
+import :staging;
 
 export namespace pl::vulkan
 {
+// Every allocation made by the renderer is reported under this tag.
+struct RendererAllocations
+{
+    static constexpr char const name[] = "vulkan.renderer";
+};
+
+template<class T>
+using RendererAllocator = TrackingAllocator<default_allocator_t<T>, RendererAllocations>;
+
+template<class T>
+using RendererList = ArrayList<T, RendererAllocator<T>>;
+
+template<class T, std::size_t N>
+using SmallRendererList = SmallArrayList<T, N, RendererAllocator<T>>;
+
+template<class T>
+using RendererHashSet = HashSet<T, Hash<T>, std::equal_to<>, RendererAllocator<T>>;
+
+template<class K, class V>
+using RendererHashMap = HashMap<K, V, Hash<K>, std::equal_to<>, RendererAllocator<std::pair<K, V>>>;
+
+// Per-frame lists hold maxFramesInFlight elements, which is rarely more than this,
+// so they are kept inline instead of being allocated.
+constexpr std::size_t inlineFramesInFlight = 3;
+
+template<class T>
+using PerFrameList = SmallRendererList<T, inlineFramesInFlight>;
+
+// Scratch memory of a frame in flight. Its blocks come from the renderer,
+// and are kept across frames, so that steady-state frames never allocate.
+using FrameArena     = Arena<RendererAllocator<std::byte>>;
+using FrameAllocator = ArenaAllocator<RendererAllocator<std::byte>>;
+
+template<class T>
+using FrameList = ArrayList<T, FrameAllocator>;
+
 struct DebugExtension
 {
 #define PL_VULKAN_DECL_PFN(name) PFN_##name name;
@@ -59,9 +102,9 @@ struct QueueInfo
 
 struct SurfaceInfo
 {
-    VkSurfaceCapabilitiesKHR      capabilities;
-    ArrayList<VkSurfaceFormatKHR> formats;
-    ArrayList<VkPresentModeKHR>   presentModes;
+    VkSurfaceCapabilitiesKHR                  capabilities;
+    SmallRendererList<VkSurfaceFormatKHR, 16> formats;
+    SmallRendererList<VkPresentModeKHR, 8>    presentModes;
 
     RE<void, SimpleError> query(VkPhysicalDevice device, VkSurfaceKHR surface) noexcept;
 
@@ -94,11 +137,16 @@ struct SwapchainConfiguration
 
 struct DeviceInfo
 {
-    VkPhysicalDeviceProperties         properties;
-    ArrayList<VkExtensionProperties>   extensions;
-    VkPhysicalDeviceFeatures           features;
-    ArrayList<VkQueueFamilyProperties> queueFamiliesProperties;
-    QueueInfo                          queues;
+    VkPhysicalDeviceProperties            properties;
+    RendererList<VkExtensionProperties>   extensions;
+    // Interned names of extensions.
+    RendererHashSet<Name>                 extensionNames;
+    // Supported features once queried, enabled features once the device is created.
+    VkPhysicalDeviceFeatures              features;
+    // VkPhysicalDeviceVulkan12Features::drawIndirectCount, which is chained separately.
+    bool                                  drawIndirectCount;
+    RendererList<VkQueueFamilyProperties> queueFamiliesProperties;
+    QueueInfo                             queues;
 
     RE<void, SimpleError> query(VkPhysicalDevice device, VkSurfaceKHR surface) noexcept;
 
@@ -107,6 +155,58 @@ struct DeviceInfo
 
 RE<ArrayList<std::byte>, SimpleError> loadFile(char const *filename) noexcept;
 
+// Instances to draw, grouped into one batch per mesh. Each batch becomes one instanced indirect draw,
+// so recording a hundred thousand instances of a few meshes costs as much as recording a few instances.
+// Batches keep their memory when cleared, so refilling a similar list does not allocate.
+class DrawList
+{
+public:
+    RE<void, SimpleError> add(Mesh const &mesh, Instance const &instance) noexcept;
+    RE<void, SimpleError> add(Mesh const &mesh, Span<Instance const> instances) noexcept;
+
+    // Removes every instance, but keeps the batches and their memory.
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t numInstances() const noexcept
+    {
+        return _numInstances;
+    }
+
+    // Upper bound of the number of draws written by write.
+    [[nodiscard]] std::size_t numBatches() const noexcept
+    {
+        return _batches.size();
+    }
+
+    // Changes whenever instances are added or cleared, so that unchanged lists need not be written again.
+    [[nodiscard]] std::uint64_t generation() const noexcept
+    {
+        return _generation;
+    }
+
+    // Writes the instances of every batch one after another, and one draw per non-empty batch
+    // whose firstInstance points at them. Returns the number of draws written.
+    // instances MUST hold numInstances() elements, and commands numBatches().
+    std::uint32_t write(Span<Instance> instances, Span<VkDrawIndexedIndirectCommand> commands) const noexcept;
+
+private:
+    struct Batch
+    {
+        Mesh                   mesh;
+        RendererList<Instance> instances;
+    };
+
+    RE<Batch *, SimpleError> batchOf(Mesh const &mesh) noexcept;
+
+    RendererList<Batch>                           _batches;
+    // Batch of each mesh, by the offset of its indices, which no two live meshes share.
+    RendererHashMap<std::uint64_t, std::uint32_t> _batchIndices;
+    // Instances tend to be added mesh by mesh, so the last batch is checked before the map.
+    std::uint32_t                                 _lastBatch    = 0;
+    std::size_t                                   _numInstances = 0;
+    std::uint64_t                                 _generation   = 0;
+};
+
 class Renderer
 {
 public:
@@ -120,7 +220,78 @@ public:
 
     RE<void, SimpleError> run() noexcept;
 
+    [[nodiscard]] DeviceMemoryAllocator &deviceMemory() noexcept
+    {
+        return _deviceMemory;
+    }
+
+    // Writes data into destination at offset. Host visible memory is written directly,
+    // anything else goes through the staging ring, and is copied at the start of the next frame.
+    // The GPU must not be reading that part of destination in any frame in flight.
+    RE<void, SimpleError> upload(
+        Buffer const         &destination,
+        VkDeviceSize          offset,
+        Span<std::byte const> data) noexcept;
+
+    // Allocates the mesh from the shared vertex and index buffers, and uploads it.
+    // Indices are relative to the first vertex of the mesh.
+    [[nodiscard]]
+    RE<Mesh, SimpleError> createMesh(Span<Vertex const> vertices, Span<Index const> indices) noexcept;
+    // No frame in flight may be drawing the mesh anymore, and the draw list must not hold instances of it.
+    void destroyMesh(Mesh const &mesh) noexcept;
+
+    // Drawn by every frame. It is only written to the GPU again by frames that find it changed.
+    [[nodiscard]] DrawList &drawList() noexcept
+    {
+        return _drawList;
+    }
+
+    // Allocates from the scratch arena of the current frame in flight.
+    // Everything allocated from it stays valid until the fence of this frame in flight
+    // is waited on again, i.e. until the GPU is done with whatever was recorded from it.
+    [[nodiscard]] FrameAllocator frameAllocator() noexcept
+    {
+        return FrameAllocator(_frameArenas[_currentFrame]);
+    }
+
+    template<class T>
+    [[nodiscard]] FrameList<T> makeFrameList() noexcept
+    {
+        return FrameList<T>(frameAllocator());
+    }
+
+    // Uninitialized storage for count objects that only have to live as long as the current frame,
+    // such as data waiting to be uploaded.
+    template<class T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] RE<Span<T>, SimpleError> allocFrameData(std::size_t count) noexcept
+    {
+        return alloc<T>(frameAllocator(), count);
+    }
+
 private:
+    // Arenas are referred to by FrameAllocators, so they must never move.
+    using FrameArenaList = StableArrayList<FrameArena, std::bit_ceil(inlineFramesInFlight), RendererAllocator<FrameArena>>;
+
+    // Sub-allocates the shared vertex and index buffers, in elements.
+    using GeometryRanges = RangeAllocator<RendererAllocator<std::byte>>;
+
+    // The draw list as written for one frame in flight. Host visible, and only rewritten
+    // once the GPU is done with the frame, so it needs no staging.
+    struct FrameDraws
+    {
+        Buffer        instances         = {};
+        VkDeviceSize  instancesCapacity = 0;
+        // Draw count, followed by the indirect commands at drawCommandsOffset.
+        Buffer        commands          = {};
+        VkDeviceSize  commandsCapacity  = 0;
+        std::uint32_t numCommands       = 0;
+        // Generation of the draw list that was written.
+        std::uint64_t generation        = ~std::uint64_t(0);
+    };
+
+    static constexpr VkDeviceSize drawCommandsOffset = sizeof(std::uint32_t);
+
     static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -151,10 +322,10 @@ private:
         VkQueue                *presentQueue) noexcept;
 
     static RE<void, SimpleError> createCommandPool(
-        DeviceInfo const           &deviceInfo,
-        VkDevice                    device,
-        VkCommandPool              *commandPool,
-        ArrayList<VkCommandBuffer> *commandBuffers) noexcept;
+        DeviceInfo const              &deviceInfo,
+        VkDevice                       device,
+        VkCommandPool                 *commandPool,
+        PerFrameList<VkCommandBuffer> *commandBuffers) noexcept;
 
     static RE<void, SimpleError> createSwapchain(
         VkSurfaceKHR                  surface,
@@ -163,8 +334,8 @@ private:
         SwapchainConfiguration const &config,
         VkDevice                      device,
         VkSwapchainKHR               *swapchain,
-        ArrayList<VkImage>           *swapchainImages,
-        ArrayList<VkImageView>       *swapchainImageViews) noexcept;
+        RendererList<VkImage>        *swapchainImages,
+        RendererList<VkImageView>    *swapchainImageViews) noexcept;
 
     static RE<VkShaderModule, SimpleError> createShaderModule(
         VkDevice              device,
@@ -175,15 +346,32 @@ private:
         SwapchainConfiguration const &swapchainConfig,
         Span<VkImageView const>       swapchainImageViews,
         VkRenderPass                 *renderPass,
-        ArrayList<VkFramebuffer>     *swapchainFramebuffers,
+        RendererList<VkFramebuffer>  *swapchainFramebuffers,
         VkPipelineLayout             *pipelineLayout,
         VkPipeline                   *pipeline) noexcept;
 
+    static RE<void, SimpleError> createFrameArenas(FrameArenaList *frameArenas) noexcept;
+
+    RE<void, SimpleError> createGeometryBuffers() noexcept;
+
+    RE<void, SimpleError> createScene() noexcept;
+
+    // Grows buffer to hold at least size bytes. Its contents are lost.
+    RE<void, SimpleError> reserveFrameBuffer(
+        Buffer             *buffer,
+        VkDeviceSize       *capacity,
+        VkDeviceSize        size,
+        VkBufferUsageFlags  usage) noexcept;
+
+    RE<void, SimpleError> writeDraws(FrameDraws *draws) noexcept;
+
+    void recordDraws(VkCommandBuffer commandBuffer, FrameDraws const &draws) noexcept;
+
     static RE<void, SimpleError> createSynchronizationObjects(
         VkDevice     device,
-        ArrayList<VkSemaphore>       *imageAvailableSemaphore,
-        ArrayList<VkSemaphore>       *renderFinishedSemaphore,
-        ArrayList<VkFence>           *inFlightFence) noexcept;
+        PerFrameList<VkSemaphore>    *imageAvailableSemaphore,
+        PerFrameList<VkSemaphore>    *renderFinishedSemaphore,
+        PerFrameList<VkFence>        *inFlightFence) noexcept;
 
     RE<void, SimpleError> recordCommandBuffer(
         VkCommandBuffer commandBuffer,
@@ -193,31 +381,41 @@ private:
 
     RE<void, SimpleError> regenerateSwapchain() noexcept;
 
-    GLFWwindow                *_window                   = {};
-    VkInstance                 _instance                 = {};
-    DebugExtension             _debugExtension;
-    VkDebugUtilsMessengerEXT   _debugMessenger           = {};
-    VkSurfaceKHR               _surface                  = {};
-    VkPhysicalDevice           _physicalDevice           = {};
-    DeviceInfo                 _deviceInfo;
-    SurfaceInfo                _surfaceInfo;
-    SwapchainConfiguration     _swapchainConfig;
-    VkDevice                   _device                   = {};
-    VkQueue                    _graphicsQueue            = {};
-    VkQueue                    _presentQueue             = {};
-    VkCommandPool              _commandPool              = {};
-    ArrayList<VkCommandBuffer> _commandBuffers;
-    VkSwapchainKHR             _swapchain                = {};
-    ArrayList<VkImage>         _swapchainImages;
-    ArrayList<VkImageView>     _swapchainImageViews;
-    VkRenderPass               _renderPass               = {};
-    ArrayList<VkFramebuffer>   _swapchainFramebuffers;   
-    VkPipelineLayout           _pipelineLayout           = {};
-    VkPipeline                 _pipeline                 = {};
-
-    ArrayList<VkSemaphore>     _imageAvailableSemaphores;
-    ArrayList<VkSemaphore>     _renderFinishedSemaphores;
-    ArrayList<VkFence>         _inFlightFences;
-    uint32_t                   _currentFrame = 0;
+    GLFWwindow                   *_window                   = {};
+    VkInstance                    _instance                 = {};
+    DebugExtension                _debugExtension;
+    VkDebugUtilsMessengerEXT      _debugMessenger           = {};
+    VkSurfaceKHR                  _surface                  = {};
+    VkPhysicalDevice              _physicalDevice           = {};
+    DeviceInfo                    _deviceInfo;
+    SurfaceInfo                   _surfaceInfo;
+    SwapchainConfiguration        _swapchainConfig;
+    VkDevice                      _device                   = {};
+    VkQueue                       _graphicsQueue            = {};
+    VkQueue                       _presentQueue             = {};
+    DeviceMemoryAllocator         _deviceMemory;
+    StagingRing                   _staging;
+    Buffer                        _vertexBuffer             = {};
+    Buffer                        _indexBuffer              = {};
+    GeometryRanges                _vertexRanges;
+    GeometryRanges                _indexRanges;
+    VkCommandPool                 _commandPool              = {};
+    PerFrameList<VkCommandBuffer> _commandBuffers;
+    VkSwapchainKHR                _swapchain                = {};
+    RendererList<VkImage>         _swapchainImages;
+    RendererList<VkImageView>     _swapchainImageViews;
+    VkRenderPass                  _renderPass               = {};
+    RendererList<VkFramebuffer>   _swapchainFramebuffers;
+    VkPipelineLayout              _pipelineLayout           = {};
+    VkPipeline                    _pipeline                 = {};
+    Mesh                          _sceneMeshes[2]           = {};
+    DrawList                      _drawList;
+
+    PerFrameList<VkSemaphore>     _imageAvailableSemaphores;
+    PerFrameList<VkSemaphore>     _renderFinishedSemaphores;
+    PerFrameList<VkFence>         _inFlightFences;
+    FrameArenaList                _frameArenas;
+    PerFrameList<FrameDraws>      _frameDraws;
+    uint32_t                      _currentFrame = 0;
 };
 } // namespace pl::vulkan
@@ -0,0 +1,144 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vulkan/vulkan.h>
+#include <pl/macro.hpp>
+
+module pl.vulkan;
+
+import pl.core;
+
+namespace pl::vulkan
+{
+RE<void, SimpleError> StagingRing::init(
+    DeviceMemoryAllocator *deviceMemory,
+    VkDeviceSize           size,
+    std::uint32_t          maxFramesInFlight) noexcept
+{
+    _deviceMemory = deviceMemory;
+    // Data wrapping around to the start of the ring must stay aligned.
+    _size = alignUp(size, alignment);
+    _head = 0;
+    _tail = 0;
+    PL_TRY_DISCARD(_frameEnds.resize(maxFramesInFlight));
+
+    VkBufferCreateInfo bufferInfo = {
+        .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext                 = {},
+        .flags                 = {},
+        .size                  = _size,
+        .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = {},
+        .pQueueFamilyIndices   = {},
+    };
+    PL_TRY_ASSIGN(_buffer, deviceMemory->createBuffer(bufferInfo, MemoryUsage::upload));
+    return {};
+}
+
+
+void StagingRing::deinit() noexcept
+{
+    if (_buffer.buffer)
+        _deviceMemory->destroyBuffer(_buffer);
+    _buffer = {};
+
+    _frameEnds    = DeviceMemoryList<VkDeviceSize>();
+    _destinations = DeviceMemoryList<VkBuffer>();
+    _regions      = DeviceMemoryList<VkBufferCopy>();
+}
+
+
+void StagingRing::beginFrame(std::uint32_t frame) noexcept
+{
+    // Frames complete in order, so everything staged before this frame was recorded is free as well.
+    _tail = std::max(_tail, _frameEnds[frame]);
+}
+
+
+RE<void, SimpleError> StagingRing::stage(
+    VkBuffer              destination,
+    VkDeviceSize          destinationOffset,
+    Span<std::byte const> data) noexcept
+{
+    if (data.empty()) return {};
+
+    VkDeviceSize size  = data.size();
+    VkDeviceSize start = alignUp(_head, alignment);
+    // Staged data is never split across the end of the ring, so that it takes a single copy.
+    if (start % _size + size > _size)
+        start += _size - start % _size;
+    if (start + size - _tail > _size)
+        return {tags::error, getSingleton<StagingRingFull>()};
+
+    PL_TRY_DISCARD(_destinations.reserve(1));
+    PL_TRY_DISCARD(_regions.reserve(1));
+
+    std::memcpy(_buffer.allocation.mapped + start % _size, data.data(), size);
+    (void) _destinations.push_back(destination);
+    (void) _regions.push_back({
+        .srcOffset = start % _size,
+        .dstOffset = destinationOffset,
+        .size      = size,
+    });
+    _head = start + size;
+    return {};
+}
+
+
+void StagingRing::rollback(Mark const &mark) noexcept
+{
+    _head = mark.head;
+    while (_regions.size() > mark.numCopies)
+    {
+        _regions.pop_back();
+        _destinations.pop_back();
+    }
+}
+
+
+RE<void, SimpleError> StagingRing::record(VkCommandBuffer commandBuffer, std::uint32_t frame) noexcept
+{
+    _frameEnds[frame] = _head;
+    if (_regions.empty()) return {};
+
+    PL_TRY_DISCARD(_deviceMemory->flush(_buffer.allocation));
+
+    for (std::size_t begin = 0; begin < _regions.size();)
+    {
+        std::size_t end = begin + 1;
+        while (end < _regions.size() && _destinations[end] == _destinations[begin]) ++end;
+
+        vkCmdCopyBuffer(
+            commandBuffer,
+            _buffer.buffer,
+            _destinations[begin],
+            uint32_t(end - begin),
+            _regions.data() + begin);
+        begin = end;
+    }
+
+    VkMemoryBarrier barrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext         = {},
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                       | VK_ACCESS_INDEX_READ_BIT
+                       | VK_ACCESS_SHADER_READ_BIT,
+    };
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        {},
+        1, &barrier,
+        0, {},
+        0, {});
+
+    _destinations.clear();
+    _regions.clear();
+    return {};
+}
+} // namespace pl::vulkan
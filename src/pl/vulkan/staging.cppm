@@ -0,0 +1,84 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include <pl/macro.hpp>
+
+export module pl.vulkan:staging;
+
+import pl.core;
+
+import :error;
+import :memory;
+
+export namespace pl::vulkan
+{
+// Persistently mapped upload buffer that data is written through on its way to device local buffers.
+//
+// Staged data is carved out of the buffer as a ring, and the copies to their destinations are queued,
+// to be recorded all at once at the start of the frame, followed by a single barrier.
+// Space used by a frame in flight is reclaimed once its fence has been waited on,
+// which beginFrame must then be told about.
+class StagingRing
+{
+public:
+    StagingRing() = default;
+
+    StagingRing           (StagingRing const &) = delete;
+    StagingRing &operator=(StagingRing const &) = delete;
+
+    RE<void, SimpleError> init(
+        DeviceMemoryAllocator *deviceMemory,
+        VkDeviceSize           size,
+        std::uint32_t          maxFramesInFlight) noexcept;
+    void deinit() noexcept;
+
+    // Reclaims everything staged by the previous use of this frame in flight.
+    void beginFrame(std::uint32_t frame) noexcept;
+
+    // Fails with StagingRingFull if the frames in flight still use too much of the ring,
+    // in which case nothing is staged.
+    [[nodiscard]]
+    RE<void, SimpleError> stage(
+        VkBuffer              destination,
+        VkDeviceSize          destinationOffset,
+        Span<std::byte const> data) noexcept;
+
+    // Point that stage calls made after it can be rolled back to, as long as nothing was recorded in between.
+    struct Mark
+    {
+        VkDeviceSize head;
+        std::size_t  numCopies;
+    };
+
+    [[nodiscard]] Mark mark() const noexcept
+    {
+        return {_head, _regions.size()};
+    }
+
+    // Forgets everything staged since mark, e.g. because the destination of the copies is gone.
+    void rollback(Mark const &mark) noexcept;
+
+    // Records the copies staged since the last call, and makes them visible to vertex input and shaders.
+    // Must be recorded outside of a render pass.
+    RE<void, SimpleError> record(VkCommandBuffer commandBuffer, std::uint32_t frame) noexcept;
+
+private:
+    // Copies into the ring are aligned to this, which keeps them aligned for any element type.
+    static constexpr VkDeviceSize alignment = 16;
+
+    DeviceMemoryAllocator *_deviceMemory = {};
+    Buffer                 _buffer       = {};
+    VkDeviceSize           _size         = 0;
+
+    // Both only ever grow, and are taken modulo _size to get a position in the ring.
+    VkDeviceSize           _head         = 0;
+    VkDeviceSize           _tail         = 0;
+    // Head of the ring when each frame in flight was last recorded.
+    DeviceMemoryList<VkDeviceSize> _frameEnds;
+
+    // Queued copies, with runs to the same destination merged into a single vkCmdCopyBuffer.
+    DeviceMemoryList<VkBuffer>     _destinations;
+    DeviceMemoryList<VkBufferCopy> _regions;
+};
+} // export namespace pl::vulkan
@@ -1,3 +1,4 @@
 export module pl.core.test;
 
+export import :harness;
 export import :side_effects;
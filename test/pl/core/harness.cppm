@@ -0,0 +1,57 @@
+module;
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+export module pl.core.test:harness;
+
+export namespace pl_test
+{
+// Tests of whatever cannot be checked in a constant expression, such as allocators of raw memory.
+// A test returns whether it passed.
+class TestRegistration
+{
+public:
+    using Function = bool (*)();
+
+    TestRegistration(char const *name, Function function) noexcept
+    :
+        _name(name),
+        _function(function),
+        _next(std::exchange(head(), this))
+    {}
+
+    TestRegistration           (TestRegistration const &) = delete;
+    TestRegistration &operator=(TestRegistration const &) = delete;
+
+    [[nodiscard]] char const       *name()     const noexcept { return _name;     }
+    [[nodiscard]] Function          function() const noexcept { return _function; }
+    [[nodiscard]] TestRegistration *next()     const noexcept { return _next;     }
+
+    // Registrations are linked intrusively, so registering a test never allocates.
+    [[nodiscard]]
+    static TestRegistration *&head() noexcept
+    {
+        static TestRegistration *head = nullptr;
+        return head;
+    }
+
+private:
+    char const       *_name;
+    Function          _function;
+    TestRegistration *_next;
+};
+
+// Runs every registered test, reports each failure to log, and returns how many failed.
+inline std::size_t runTests(std::ostream &log)
+{
+    std::size_t numFailed = 0;
+    for (auto *t = TestRegistration::head(); t; t = t->next())
+    {
+        if (t->function()()) continue;
+        log << t->name() << " failed\n";
+        ++numFailed;
+    }
+    return numFailed;
+}
+} // export namespace pl_test
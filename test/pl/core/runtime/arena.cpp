@@ -0,0 +1,98 @@
+module;
+#include <cstddef>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+// Counts what reaches the upstream allocator, whether or not allocation tracking is enabled.
+class CountingAllocator
+{
+public:
+    explicit CountingAllocator(std::size_t *numAllocs) noexcept
+    : _numAllocs(numAllocs) {}
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(NonZero<std::size_t> size, NonZero<std::size_t> alignment) noexcept
+    {
+        ++*_numAllocs;
+        return Mallocator().alloc(size, alignment);
+    }
+
+    void free(Ptr<void> memory, NonZero<std::size_t> size, NonZero<std::size_t> alignment) noexcept
+    {
+        Mallocator().free(memory, size, alignment);
+    }
+
+private:
+    std::size_t *_numAllocs;
+};
+
+constexpr std::size_t framesInFlight = 2;
+constexpr std::size_t numFrames      = 64;
+
+// Drives frames the way the renderer does: the arena of a frame in flight is reset once its frame
+// is done, and then fills scratch lists and arrays until the next time around.
+// Returns the number of upstream allocations made by every frame but the first of each arena.
+std::size_t runFrames(Arena<CountingAllocator> (&arenas)[framesInFlight], std::size_t const &numAllocs) noexcept
+{
+    std::size_t warmedUp = 0;
+    for (std::size_t frame = 0; frame < numFrames; ++frame)
+    {
+        Arena<CountingAllocator> &arena = arenas[frame % framesInFlight];
+        arena.reset();
+
+        ArenaAllocator<CountingAllocator> allocator(arena);
+        ArrayList<int, ArenaAllocator<CountingAllocator>> list(allocator);
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (!list.push_back(i)) return ~std::size_t(0);
+        }
+        if (!alloc<float>(allocator, 256)) return ~std::size_t(0);
+
+        if (frame + 1 == framesInFlight) warmedUp = numAllocs;
+    }
+    return numAllocs - warmedUp;
+}
+
+PL_TEST(test_arenaSteadyStateFramesDoNotAllocate)
+{
+    std::size_t numAllocs = 0;
+    Arena<CountingAllocator> arenas[framesInFlight] = {
+        Arena<CountingAllocator>(std::size_t(1) << 16, ArenaGrowth::chained, CountingAllocator(&numAllocs)),
+        Arena<CountingAllocator>(std::size_t(1) << 16, ArenaGrowth::chained, CountingAllocator(&numAllocs)),
+    };
+
+    // Blocks are only allocated by the first frame of each arena, and then kept across reset.
+    bool lazy = numAllocs == 0;
+    std::size_t steadyAllocs = runFrames(arenas, numAllocs);
+    return lazy && numAllocs == framesInFlight && steadyAllocs == 0;
+}
+
+PL_TEST(test_arenaReserve)
+{
+    std::size_t numAllocs = 0;
+    Arena<CountingAllocator> arenas[framesInFlight] = {
+        Arena<CountingAllocator>(std::size_t(1) << 16, ArenaGrowth::chained, CountingAllocator(&numAllocs)),
+        Arena<CountingAllocator>(std::size_t(1) << 16, ArenaGrowth::chained, CountingAllocator(&numAllocs)),
+    };
+
+    // reserve allocates the first block once, so that not even the first frame goes upstream.
+    for (auto &arena : arenas)
+    {
+        if (!arena.reserve() || !arena.reserve()) return false;
+    }
+    bool reserved = numAllocs == framesInFlight;
+
+    std::size_t steadyAllocs = runFrames(arenas, numAllocs);
+    return reserved && numAllocs == framesInFlight && steadyAllocs == 0;
+}
+} // namespace
+} // namespace pl_test
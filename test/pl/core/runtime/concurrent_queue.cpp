@@ -0,0 +1,186 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+template<class Queue>
+[[nodiscard]]
+bool isQueueFull(Queue &queue, std::uint64_t value) noexcept
+{
+    RE<void, SimpleError> pushed = queue.try_push(value);
+    return !pushed && &pushed.error().errorType() == &getSingleton<QueueFull>();
+}
+
+// Fills the queue up to capacity, and drains it again, checking both edges.
+template<class Queue>
+[[nodiscard]]
+bool fullAndEmpty() noexcept
+{
+    Queue queue;
+    if (!queue.init(5) || queue.capacity() != 8) return false;
+    if (queue.try_pop()) return false;
+
+    for (std::uint64_t i = 0; i < 8; ++i)
+    {
+        if (!queue.try_push(i)) return false;
+    }
+    if (queue.size_approx() != 8 || !isQueueFull(queue, 8)) return false;
+
+    for (std::uint64_t i = 0; i < 8; ++i)
+    {
+        Opt<std::uint64_t> value = queue.try_pop();
+        if (!value || *value != i) return false;
+    }
+    return !queue.try_pop() && queue.size_approx() == 0;
+}
+
+PL_TEST(test_spscQueueFullAndEmpty) { return fullAndEmpty<SPSCQueue<std::uint64_t>>(); }
+PL_TEST(test_mpmcQueueFullAndEmpty) { return fullAndEmpty<MPMCQueue<std::uint64_t>>(); }
+
+// Positions keep growing past the capacity, and must keep mapping onto the same cells in order.
+template<class Queue>
+[[nodiscard]]
+bool wrapAround() noexcept
+{
+    Queue queue;
+    if (!queue.init(4)) return false;
+
+    std::uint64_t pushed = 0;
+    std::uint64_t popped = 0;
+    for (std::size_t round = 0; round < 10; ++round)
+    {
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            if (!queue.try_push(pushed++)) return false;
+        }
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            Opt<std::uint64_t> value = queue.try_pop();
+            if (!value || *value != popped++) return false;
+        }
+    }
+
+    // Full again, with the positions now far past the capacity.
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        if (!queue.try_push(pushed++)) return false;
+    }
+    if (!isQueueFull(queue, pushed)) return false;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        Opt<std::uint64_t> value = queue.try_pop();
+        if (!value || *value != popped++) return false;
+    }
+    return !queue.try_pop();
+}
+
+PL_TEST(test_spscQueueWrapAround) { return wrapAround<SPSCQueue<std::uint64_t>>(); }
+PL_TEST(test_mpmcQueueWrapAround) { return wrapAround<MPMCQueue<std::uint64_t>>(); }
+
+// Threads yield whenever the queue is full or empty, so that the tests stay quick on few cores.
+constexpr std::size_t   queueCapacity = 64;
+constexpr std::uint64_t numItems      = 100'000;
+
+// The consumer sees every value, in the order it was pushed.
+PL_TEST(test_spscQueueProducerConsumer)
+{
+    SPSCQueue<std::uint64_t> queue;
+    if (!queue.init(queueCapacity)) return false;
+
+    bool inOrder = true;
+    std::thread consumer([&]
+    {
+        for (std::uint64_t expected = 0; expected < numItems;)
+        {
+            if (Opt<std::uint64_t> value = queue.try_pop(); value)
+            {
+                inOrder = inOrder && *value == expected;
+                ++expected;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (std::uint64_t i = 0; i < numItems;)
+    {
+        if (queue.try_push(i)) ++i;
+        else std::this_thread::yield();
+    }
+    consumer.join();
+    return inOrder && !queue.try_pop();
+}
+
+constexpr std::size_t numProducers = 4;
+constexpr std::size_t numConsumers = 4;
+
+// Every value pushed by any producer is popped by exactly one consumer.
+PL_TEST(test_mpmcQueueManyProducersAndConsumers)
+{
+    constexpr std::uint64_t total = numProducers * numItems;
+    static std::atomic<std::uint8_t> timesPopped[total];
+    for (auto &times : timesPopped) times.store(0, std::memory_order_relaxed);
+
+    MPMCQueue<std::uint64_t> queue;
+    if (!queue.init(queueCapacity)) return false;
+
+    std::atomic<std::uint64_t> count = 0;
+    std::atomic<std::uint64_t> sum   = 0;
+
+    std::thread threads[numProducers + numConsumers];
+    for (std::size_t p = 0; p < numProducers; ++p)
+    {
+        threads[p] = std::thread([&queue, p]
+        {
+            for (std::uint64_t i = p * numItems; i < (p + 1) * numItems;)
+            {
+                if (queue.try_push(i)) ++i;
+                else std::this_thread::yield();
+            }
+        });
+    }
+    for (std::size_t c = 0; c < numConsumers; ++c)
+    {
+        threads[numProducers + c] = std::thread([&]
+        {
+            std::uint64_t localSum = 0;
+            while (count.load(std::memory_order_relaxed) < total)
+            {
+                Opt<std::uint64_t> value = queue.try_pop();
+                if (!value)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                timesPopped[*value].fetch_add(1, std::memory_order_relaxed);
+                count.fetch_add(1, std::memory_order_relaxed);
+                localSum += *value;
+            }
+            sum.fetch_add(localSum, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread &thread : threads) thread.join();
+
+    for (auto &times : timesPopped)
+    {
+        if (times.load(std::memory_order_relaxed) != 1) return false;
+    }
+    return count == total && sum == total * (total - 1) / 2 && !queue.try_pop();
+}
+} // namespace
+} // namespace pl_test
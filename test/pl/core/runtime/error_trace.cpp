@@ -0,0 +1,139 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <pl/macro.hpp>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+class TestError : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "TestError";
+    }
+};
+
+// The lines the error is raised and propagated at, set by the functions as they run.
+std::uint_least32_t raiseLine;
+std::uint_least32_t middleLine;
+std::uint_least32_t outerLine;
+
+[[gnu::noinline]]
+RE<int, StacktracedError> leaf(int x) noexcept
+{
+    raiseLine = std::source_location::current().line() + 1;
+    if (x < 0) return {tags::error, errorSite<TestError>()};
+    return x + 1;
+}
+
+[[gnu::noinline]]
+RE<int, StacktracedError> middle(int x) noexcept
+{
+    middleLine = std::source_location::current().line() + 1;
+    PL_TRY_ASSIGN(int y, leaf(x));
+    return y * 2;
+}
+
+[[gnu::noinline]]
+RE<void, StacktracedError> outer(int x) noexcept
+{
+    outerLine = std::source_location::current().line() + 1;
+    PL_TRY_DISCARD(middle(x));
+    return {};
+}
+
+PL_TEST(test_errorTraceSites)
+{
+    if (!outer(1)) return false;
+
+    RE<void, StacktracedError> result = outer(-1);
+    if (result) return false;
+
+    StacktracedErrorInfo const &info = result.error().info();
+    ErrorTrace trace = info.trace();
+    return &info.errorType() == &getSingleton<TestError>()
+        && info.where().line() == raiseLine
+        && !trace.expired
+        && trace.numFrames > 0 && trace.frames[0] != nullptr
+        && trace.numSites == 2
+        && trace.sites[0].line() == middleLine
+        && trace.sites[1].line() == outerLine;
+}
+
+std::uint_least32_t recurseLine;
+
+[[gnu::noinline]]
+RE<void, StacktracedError> recurse(std::size_t depth) noexcept
+{
+    if (depth == 0) return {tags::error, errorSite<TestError>()};
+
+    recurseLine = std::source_location::current().line() + 1;
+    PL_TRY_DISCARD(recurse(depth - 1));
+    return {};
+}
+
+// Sites past maxSites are still counted, but only the first ones are kept.
+PL_TEST(test_errorTraceSiteOverflow)
+{
+    constexpr std::size_t depth = ErrorTrace::maxSites + 3;
+
+    RE<void, StacktracedError> result = recurse(depth);
+    if (result) return false;
+
+    ErrorTrace trace = result.error().info().trace();
+    if (trace.expired || trace.numSites != depth) return false;
+    for (std::uint32_t i = 0; i < ErrorTrace::maxSites; ++i)
+    {
+        if (trace.sites[i].line() != recurseLine) return false;
+    }
+    return true;
+}
+
+// Without stack capture, the sites are still recorded.
+PL_TEST(test_errorTraceDepth)
+{
+    setErrorTraceDepth(0);
+    RE<void, StacktracedError> result = outer(-1);
+    setErrorTraceDepth(ErrorTrace::maxFrames);
+    if (result) return false;
+
+    ErrorTrace trace = result.error().info().trace();
+    return !trace.expired && trace.numFrames == 0 && trace.numSites == 2;
+}
+
+// Each thread keeps the records of its last 32 errors.
+constexpr std::size_t ringSize = 32;
+
+PL_TEST(test_errorTraceExpires)
+{
+    RE<void, StacktracedError> result = outer(-1);
+    if (result) return false;
+
+    for (std::size_t i = 0; i + 1 < ringSize; ++i)
+    {
+        if (leaf(-1)) return false;
+    }
+    ErrorTrace before = result.error().info().trace();
+    if (before.expired || before.numSites != 2) return false;
+
+    // The next error reuses the record.
+    if (leaf(-1)) return false;
+    ErrorTrace after = result.error().info().trace();
+    return after.expired && after.numFrames == 0 && after.numSites == 0;
+}
+} // namespace
+} // namespace pl_test
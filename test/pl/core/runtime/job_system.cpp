@@ -0,0 +1,157 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <pl/macro.hpp>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+class TestError : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "TestError";
+    }
+};
+
+constexpr std::size_t threadCounts[] = {1, 2, 4};
+
+constexpr std::size_t numElements = 10'000;
+
+PL_TEST(test_jobSystemParallelForTouchesEveryElementOnce)
+{
+    static std::atomic<unsigned> timesTouched[numElements];
+    constexpr std::size_t grainSizes[] = {0, 1, 7, 1000, numElements, numElements + 5};
+
+    for (std::size_t numThreads : threadCounts)
+    {
+        JobSystem jobs;
+        if (!jobs.init(numThreads) || jobs.numWorkers() != numThreads) return false;
+
+        for (std::size_t grainSize : grainSizes)
+        {
+            for (auto &times : timesTouched) times.store(0, std::memory_order_relaxed);
+
+            RE<void, SimpleError> result = jobs.parallel_for(
+                Span<std::atomic<unsigned>>(timesTouched, numElements),
+                [](std::atomic<unsigned> &times) { times.fetch_add(1, std::memory_order_relaxed); },
+                grainSize);
+            if (!result) return false;
+
+            for (auto &times : timesTouched)
+            {
+                if (times.load(std::memory_order_relaxed) != 1) return false;
+            }
+        }
+    }
+    return true;
+}
+
+PL_TEST(test_jobSystemWaitReturnsAfterEveryJob)
+{
+    constexpr std::size_t numJobs = 1000;
+
+    for (std::size_t numThreads : threadCounts)
+    {
+        JobSystem jobs;
+        if (!jobs.init(numThreads)) return false;
+
+        std::atomic<std::size_t> numRun = 0;
+        JobCounter counter;
+        for (std::size_t i = 0; i < numJobs; ++i)
+        {
+            RE<void, SimpleError> submitted = jobs.submit(counter, [&numRun]
+            {
+                // Long enough that jobs are still running on other workers when wait is called.
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                numRun.fetch_add(1, std::memory_order_relaxed);
+            });
+            if (!submitted) return false;
+        }
+
+        if (!jobs.wait(counter) || numRun.load(std::memory_order_relaxed) != numJobs || !counter.done())
+            return false;
+    }
+    return true;
+}
+
+// Every job below the maximum depth submits two more jobs to the same counter, from whichever worker runs it.
+struct FanOut
+{
+    JobSystem                *jobs;
+    JobCounter               *counter;
+    std::atomic<std::size_t> *numRun;
+    std::size_t               depth;
+
+    static constexpr std::size_t maxDepth = 10;
+
+    RE<void, SimpleError> operator()() const noexcept
+    {
+        numRun->fetch_add(1, std::memory_order_relaxed);
+        if (depth == maxDepth) return {};
+
+        FanOut child = *this;
+        ++child.depth;
+        PL_TRY_DISCARD(jobs->submit(*counter, child));
+        PL_TRY_DISCARD(jobs->submit(*counter, child));
+        return {};
+    }
+};
+
+PL_TEST(test_jobSystemJobsSubmittingJobs)
+{
+    for (std::size_t numThreads : threadCounts)
+    {
+        JobSystem jobs;
+        if (!jobs.init(numThreads)) return false;
+
+        std::atomic<std::size_t> numRun = 0;
+        JobCounter counter;
+        if (!jobs.submit(counter, FanOut{&jobs, &counter, &numRun, 0})) return false;
+
+        // The parent of every job is still pending while it submits, so the counter never drops to zero early.
+        if (!jobs.wait(counter)) return false;
+        if (numRun.load(std::memory_order_relaxed) != (std::size_t(2) << FanOut::maxDepth) - 1) return false;
+    }
+    return true;
+}
+
+PL_TEST(test_jobSystemParallelForPropagatesErrors)
+{
+    static int values[numElements];
+
+    for (std::size_t numThreads : threadCounts)
+    {
+        JobSystem jobs;
+        if (!jobs.init(numThreads)) return false;
+
+        RE<void, SimpleError> result = jobs.parallel_for(Span<int>(values, numElements),
+            [](int &value) -> RE<void, SimpleError>
+            {
+                if (&value == &values[numElements / 2]) return {tags::error, getSingleton<TestError>()};
+                return {};
+            },
+            16);
+        if (result || &result.error().errorType() != &getSingleton<TestError>()) return false;
+
+        // The job system stays usable after a failure.
+        if (!jobs.parallel_for(Span<int>(values, numElements), [](int &value) { value = 1; })) return false;
+    }
+    return true;
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,89 @@
+module;
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+using namespace pl::literals;
+
+PL_TEST(test_nameInternFind)
+{
+    if (Name::find("test_nameInternFind"_name)) return false;
+
+    RE<Name, SimpleError> name = Name::intern("test_nameInternFind"_name);
+    if (!name || name->empty()) return false;
+
+    // The characters are copied, so the key does not need to outlive the name.
+    char chars[] = "test_nameInternFind";
+    RE<Name, SimpleError> again = Name::intern(NameKey(chars));
+    std::memset(chars, 0, sizeof(chars));
+
+    Opt<Name> found = Name::find("test_nameInternFind"_name);
+    return again && *again == *name
+        && found && *found == *name
+        && name->view() == "test_nameInternFind"
+        && std::strcmp(name->c_str(), "test_nameInternFind") == 0
+        && name->hash() == NameKey("test_nameInternFind").hash()
+        && *Name::intern("test_nameInternFindOther"_name) != *name;
+}
+
+PL_TEST(test_nameEmpty)
+{
+    RE<Name, SimpleError> name = Name::intern("");
+    Opt<Name> found = Name::find("");
+    return name && name->empty() && name->id() == 0
+        && found && *found == Name()
+        && Name().view().empty() && *Name().c_str() == '\0'
+        && Name().hash() == NameKey("").hash();
+}
+
+constexpr std::size_t numThreads = 8;
+constexpr std::size_t numStrings = 512;
+
+// Every thread interns the same strings, each in its own order, which must agree on a single id per string.
+PL_TEST(test_nameConcurrentIntern)
+{
+    static char strings[numStrings][40];
+    for (std::size_t i = 0; i < numStrings; ++i)
+        std::snprintf(strings[i], sizeof(strings[i]), "test_nameConcurrentIntern_%zu", i);
+
+    static Name::id_type ids[numThreads][numStrings];
+    std::thread threads[numThreads];
+    for (std::size_t t = 0; t < numThreads; ++t)
+    {
+        threads[t] = std::thread([t]
+        {
+            for (std::size_t k = 0; k < numStrings; ++k)
+            {
+                std::size_t i = (k * 7 + t * 61) % numStrings;
+                RE<Name, SimpleError> name = Name::intern(strings[i]);
+                ids[t][i] = name ? name->id() : 0;
+            }
+        });
+    }
+    for (std::thread &thread : threads) thread.join();
+
+    for (std::size_t i = 0; i < numStrings; ++i)
+    {
+        Opt<Name> found = Name::find(strings[i]);
+        if (!found || found->view() != std::string_view(strings[i])) return false;
+        for (std::size_t t = 0; t < numThreads; ++t)
+        {
+            if (ids[t][i] != found->id()) return false;
+        }
+    }
+    return true;
+}
+} // namespace
+} // namespace pl_test
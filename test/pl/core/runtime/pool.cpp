@@ -0,0 +1,200 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+[[nodiscard]]
+bool isBadPoolAlloc(RE<Ptr<void>, SimpleError> const &result) noexcept
+{
+    return !result && &result.error().errorType() == &getSingleton<BadPoolAlloc>();
+}
+
+// Hands out at most maxAllocs slabs, like an upstream that has run out of memory.
+class LimitedAllocator
+{
+public:
+    explicit LimitedAllocator(std::size_t maxAllocs) noexcept
+    : _maxAllocs(maxAllocs) {}
+
+    [[nodiscard]]
+    RE<Ptr<void>, SimpleError> alloc(NonZero<std::size_t> size, NonZero<std::size_t> alignment) noexcept
+    {
+        if (_maxAllocs == 0) return {tags::error, getSingleton<BadAlloc>()};
+        --_maxAllocs;
+        return AlignedAllocator().alloc(size, alignment);
+    }
+
+    void free(Ptr<void> memory, NonZero<std::size_t> size, NonZero<std::size_t> alignment) noexcept
+    {
+        AlignedAllocator().free(memory, size, alignment);
+    }
+
+private:
+    std::size_t _maxAllocs;
+};
+
+PL_TEST(test_poolRejectsWhatItCannotHold)
+{
+    Pool<24, 16> pool;
+    return isBadPoolAlloc(pool.alloc(makeNonZero_Unchecked(std::size_t(25)), makeNonZero_Unchecked(std::size_t(8))))
+        && isBadPoolAlloc(pool.alloc(makeNonZero_Unchecked(std::size_t(8)),  makeNonZero_Unchecked(std::size_t(32))))
+        && pool.alloc(makeNonZero_Unchecked(std::size_t(24)), makeNonZero_Unchecked(std::size_t(16)));
+}
+
+// Once upstream refuses another slab, allocation fails with its error, and freed blocks are still handed out.
+PL_TEST(test_poolExhausted)
+{
+    constexpr std::size_t blocksPerSlab = 4;
+    constexpr std::size_t numSlabs      = 2;
+    Pool<32, 16, LimitedAllocator> pool(blocksPerSlab, LimitedAllocator(numSlabs));
+
+    auto const size      = makeNonZero_Unchecked(std::size_t(32));
+    auto const alignment = makeNonZero_Unchecked(std::size_t(16));
+
+    void *blocks[blocksPerSlab * numSlabs];
+    for (void *&block : blocks)
+    {
+        RE<Ptr<void>, SimpleError> result = pool.alloc(size, alignment);
+        if (!result) return false;
+        block = *result;
+    }
+
+    RE<Ptr<void>, SimpleError> exhausted = pool.alloc(size, alignment);
+    if (exhausted || !exhausted.error().errorType().isSubtypeOf<BadAlloc>()) return false;
+
+    pool.free(makeNonNull_Unchecked(blocks[3]), size, alignment);
+    RE<Ptr<void>, SimpleError> reused = pool.alloc(size, alignment);
+    return reused && *reused == blocks[3] && !pool.alloc(size, alignment);
+}
+
+// The free list is last in, first out, so the most recently freed, and likely cached, block is reused first.
+PL_TEST(test_poolFreeListReuseOrder)
+{
+    Pool<16> pool;
+    auto const size      = makeNonZero_Unchecked(std::size_t(16));
+    auto const alignment = makeNonZero_Unchecked(std::size_t(8));
+
+    void *blocks[4];
+    for (void *&block : blocks)
+    {
+        RE<Ptr<void>, SimpleError> result = pool.alloc(size, alignment);
+        if (!result) return false;
+        block = *result;
+    }
+
+    pool.free(makeNonNull_Unchecked(blocks[1]), size, alignment);
+    pool.free(makeNonNull_Unchecked(blocks[3]), size, alignment);
+    pool.free(makeNonNull_Unchecked(blocks[0]), size, alignment);
+
+    RE<Ptr<void>, SimpleError> first  = pool.alloc(size, alignment);
+    RE<Ptr<void>, SimpleError> second = pool.alloc(size, alignment);
+    RE<Ptr<void>, SimpleError> third  = pool.alloc(size, alignment);
+    RE<Ptr<void>, SimpleError> fresh  = pool.alloc(size, alignment);
+    return first  && *first  == blocks[0]
+        && second && *second == blocks[3]
+        && third  && *third  == blocks[1]
+        && fresh  && std::find(std::begin(blocks), std::end(blocks), *fresh) == std::end(blocks);
+}
+
+// Every block is aligned and disjoint from the others, across several slabs.
+template<std::size_t BlockSize, std::size_t Align>
+[[nodiscard]]
+bool blocksAligned() noexcept
+{
+    using pool_type = Pool<BlockSize, Align>;
+    constexpr std::size_t numBlocks = 50;
+
+    pool_type pool(7);
+    auto const size      = makeNonZero_Unchecked(BlockSize);
+    auto const alignment = makeNonZero_Unchecked(Align);
+
+    std::uintptr_t addresses[numBlocks];
+    for (std::size_t i = 0; i < numBlocks; ++i)
+    {
+        RE<Ptr<void>, SimpleError> result = pool.alloc(size, alignment);
+        if (!result) return false;
+        addresses[i] = reinterpret_cast<std::uintptr_t>(static_cast<void *>(*result));
+        if (addresses[i] % pool_type::blockAlignment != 0) return false;
+        std::memset(*result, int(i), BlockSize);
+    }
+
+    std::sort(std::begin(addresses), std::end(addresses));
+    for (std::size_t i = 1; i < numBlocks; ++i)
+    {
+        if (addresses[i] - addresses[i - 1] < pool_type::blockSize) return false;
+    }
+    return true;
+}
+
+PL_TEST(test_poolBlockAlignment)
+{
+    return blocksAligned<1, 1>()
+        && blocksAligned<24, 8>()
+        && blocksAligned<24, 64>()
+        && blocksAligned<100, 32>()
+        && blocksAligned<4096, 4096>();
+}
+
+struct Tracked
+{
+    explicit Tracked(int value, int *numAlive) noexcept
+    : value(value), numAlive(numAlive)
+    {
+        ++*numAlive;
+    }
+
+    ~Tracked()
+    {
+        --*numAlive;
+    }
+
+    int  value;
+    int *numAlive;
+};
+
+struct TooBig
+{
+    char bytes[4 * sizeof(Tracked)];
+};
+
+PL_TEST(test_poolAllocatorNewDelete)
+{
+    Pool<sizeof(Tracked), alignof(Tracked)> pool;
+    PoolAllocator<sizeof(Tracked), alignof(Tracked)> allocator(pool);
+
+    int numAlive = 0;
+    RE<Ptr<Tracked>, SimpleError> a = new_<Tracked>(allocator, 1, &numAlive);
+    RE<Ptr<Tracked>, SimpleError> b = new_<Tracked>(allocator, 2, &numAlive);
+    if (!a || !b || numAlive != 2) return false;
+
+    Tracked *freed = *a;
+    if (freed->value != 1 || static_cast<Tracked *>(*b)->value != 2) return false;
+    delete_(allocator, *a);
+    if (numAlive != 1) return false;
+
+    // The copy of the allocator shares the pool, so it reuses the block just freed.
+    PoolAllocator<sizeof(Tracked), alignof(Tracked)> copy = allocator;
+    RE<Ptr<Tracked>, SimpleError> c = new_<Tracked>(copy, 3, &numAlive);
+    if (!c || static_cast<Tracked *>(*c) != freed || freed->value != 3 || &copy.pool() != &pool) return false;
+
+    delete_(copy, *c);
+    delete_(allocator, *b);
+
+    RE<Ptr<TooBig>, SimpleError> tooBig = new_<TooBig>(allocator);
+    return numAlive == 0
+        && !tooBig && &tooBig.error().errorType() == &getSingleton<BadPoolAlloc>();
+}
+} // namespace
+} // namespace pl_test
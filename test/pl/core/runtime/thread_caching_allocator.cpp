@@ -0,0 +1,137 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+constexpr auto maxAlignment = makeNonZero_Unchecked(alignof(std::max_align_t));
+
+[[nodiscard]]
+bool isMaxAligned(void const *memory) noexcept
+{
+    return reinterpret_cast<std::uintptr_t>(memory) % alignof(std::max_align_t) == 0;
+}
+
+// From the smallest size class to past the largest one, which goes to Mallocator instead.
+constexpr std::size_t sizes[] = {
+    1, 16, 17, 32, 33, 100, 1000, 4096, 4097, 16 * 1024, 32 * 1024 - 1, 32 * 1024, 32 * 1024 + 1, 1 << 20,
+};
+
+PL_TEST(test_threadCachingAllocatorAllocFree)
+{
+    for (std::size_t size : sizes)
+    {
+        auto nonZeroSize = makeNonZero_Unchecked(size);
+        RE<Ptr<void>, SimpleError> a = ThreadCachingAllocator::alloc(nonZeroSize, maxAlignment);
+        RE<Ptr<void>, SimpleError> b = ThreadCachingAllocator::alloc(nonZeroSize, maxAlignment);
+        if (!a || !b || *a == *b) return false;
+        if (!isMaxAligned(*a) || !isMaxAligned(*b)) return false;
+
+        // Overlapping blocks would overwrite each other.
+        std::memset(*a, 0xAA, size);
+        std::memset(*b, 0xBB, size);
+        auto *bytes = static_cast<unsigned char *>(static_cast<void *>(*a));
+        if (bytes[0] != 0xAA || bytes[size - 1] != 0xAA) return false;
+
+        ThreadCachingAllocator::free(*b, nonZeroSize, maxAlignment);
+        ThreadCachingAllocator::free(*a, nonZeroSize, maxAlignment);
+    }
+    return true;
+}
+
+PL_TEST(test_threadCachingAllocatorReusesFreedBlocks)
+{
+    auto size = makeNonZero_Unchecked(std::size_t(48));
+    RE<Ptr<void>, SimpleError> a = ThreadCachingAllocator::alloc(size, maxAlignment);
+    if (!a) return false;
+    void *freed = *a;
+    ThreadCachingAllocator::free(*a, size, maxAlignment);
+
+    // Any size of the same class gets the block that was just freed back from the thread cache.
+    RE<Ptr<void>, SimpleError> b = ThreadCachingAllocator::alloc(makeNonZero_Unchecked(std::size_t(64)), maxAlignment);
+    if (!b) return false;
+    bool reused = *b == freed;
+    ThreadCachingAllocator::free(*b, makeNonZero_Unchecked(std::size_t(64)), maxAlignment);
+    return reused;
+}
+
+PL_TEST(test_threadCachingAllocatorExpand)
+{
+    auto size = makeNonZero_Unchecked(std::size_t(40));
+    RE<Ptr<void>, SimpleError> memory = ThreadCachingAllocator::alloc(size, maxAlignment);
+    if (!memory) return false;
+
+    auto expand = [&](std::size_t oldSize, std::size_t newSize)
+    {
+        return ThreadCachingAllocator::expand(
+            *memory, makeNonZero_Unchecked(oldSize), makeNonZero_Unchecked(newSize), maxAlignment);
+    };
+    bool ok = expand(40, 64)                        // Within the size class of 33 to 64 bytes.
+           && expand(64, 33)
+           && !expand(40, 65)                       // Into the next size class.
+           && !expand(40, 32)
+           && !expand(32 * 1024, 32 * 1024 + 1)     // Past the largest size class.
+           && !expand(1 << 20, (1 << 20) + 1);
+
+    ThreadCachingAllocator::free(*memory, size, maxAlignment);
+    return ok;
+}
+
+// Only this test allocates blocks of this size class, so its free list in the central heap
+// holds nothing but what the test flushes back.
+constexpr std::size_t crossThreadSize     = 8 * 1024;
+constexpr std::size_t numCrossThreadFrees = 64;
+
+PL_TEST(test_threadCachingAllocatorCrossThreadFree)
+{
+    auto size = makeNonZero_Unchecked(crossThreadSize);
+    void *allocated[numCrossThreadFrees];
+    for (void *&memory : allocated)
+    {
+        RE<Ptr<void>, SimpleError> result = ThreadCachingAllocator::alloc(size, maxAlignment);
+        if (!result) return false;
+        memory = *result;
+    }
+
+    // The blocks go into the cache of the freeing thread, which flushes them to the central heap,
+    // partly while freeing, and the rest once it exits.
+    std::thread([&]
+    {
+        for (void *memory : allocated)
+            ThreadCachingAllocator::free(makeNonNull_Unchecked(memory), size, maxAlignment);
+    }).join();
+
+    // A fresh thread, with an empty cache, refills from the central heap, and so gets the same blocks.
+    void *reallocated[numCrossThreadFrees] = {};
+    bool ok = true;
+    std::thread([&]
+    {
+        for (void *&memory : reallocated)
+        {
+            RE<Ptr<void>, SimpleError> result = ThreadCachingAllocator::alloc(size, maxAlignment);
+            if (!result) { ok = false; return; }
+            memory = *result;
+        }
+        std::sort(std::begin(allocated), std::end(allocated));
+        std::sort(std::begin(reallocated), std::end(reallocated));
+        ok = std::equal(std::begin(allocated), std::end(allocated), std::begin(reallocated));
+
+        for (void *memory : reallocated)
+            ThreadCachingAllocator::free(makeNonNull_Unchecked(memory), size, maxAlignment);
+    }).join();
+    return ok;
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,84 @@
+module;
+#include <cstddef>
+#include <cstring>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+struct TestAllocations
+{
+    static constexpr char const name[] = "test_trackingAllocator";
+};
+
+using TestAllocator = TrackingAllocator<Mallocator, TestAllocations>;
+
+[[nodiscard]]
+bool isLinked(AllocationStats const &stats) noexcept
+{
+    for (AllocationStats const *s = AllocationStats::first(); s; s = s->next())
+    {
+        if (s == &stats) return true;
+    }
+    return false;
+}
+
+PL_TEST(test_trackingAllocatorStats)
+{
+    TestAllocator allocator;
+    AllocationStats const &stats = getAllocationStats<TestAllocations>();
+    auto const alignment = makeNonZero_Unchecked(alignof(std::max_align_t));
+
+    RE<Ptr<void>, SimpleError> a = allocator.alloc(makeNonZero_Unchecked(std::size_t(100)), alignment);
+    RE<Ptr<void>, SimpleError> b = allocator.alloc(makeNonZero_Unchecked(std::size_t(20)),  alignment);
+    if (!a || !b) return false;
+    std::memset(*a, 1, 100);
+
+    RE<Ptr<void>, SimpleError> grown = allocator.realloc(*a,
+        makeNonZero_Unchecked(std::size_t(100)), makeNonZero_Unchecked(std::size_t(300)), alignment);
+    if (!grown) return false;
+    RE<Ptr<void>, SimpleError> shrunk = allocator.realloc(*grown,
+        makeNonZero_Unchecked(std::size_t(300)), makeNonZero_Unchecked(std::size_t(50)), alignment);
+    if (!shrunk) return false;
+
+    allocator.free(*b,      makeNonZero_Unchecked(std::size_t(20)), alignment);
+    allocator.free(*shrunk, makeNonZero_Unchecked(std::size_t(50)), alignment);
+
+    if constexpr (!allocationTrackingEnabled)
+    {
+        // Allocations still go through, but nothing is recorded.
+        return stats.liveBytes() == 0 && stats.peakBytes() == 0 && stats.totalBytes() == 0
+            && stats.numAllocs() == 0 && stats.numFrees() == 0 && stats.numResizes() == 0
+            && !isLinked(stats);
+    }
+
+    // Live bytes went 100, 120, 320, 70, 50 and 0. Growing counts towards the total, shrinking does not.
+    bool recorded = stats.liveBytes()  == 0
+                 && stats.peakBytes()  == 320
+                 && stats.totalBytes() == 320
+                 && stats.numAllocs()  == 2
+                 && stats.numFrees()   == 2
+                 && stats.numResizes() == 2
+                 && isLinked(stats)
+                 && std::strcmp(stats.name(), TestAllocations::name) == 0;
+
+    // Only allocations are binned by size, not resizes.
+    std::size_t numBinned = 0;
+    for (std::size_t bucket = 0; bucket < AllocationStats::numSizeBuckets; ++bucket)
+        numBinned += stats.numAllocsOfSize(bucket);
+    bool binned = numBinned == 2
+        && stats.numAllocsOfSize(AllocationStats::sizeBucketOf(100)) == 1
+        && stats.numAllocsOfSize(AllocationStats::sizeBucketOf(20))  == 1
+        && AllocationStats::sizeBucketOf(100) == 7
+        && AllocationStats::sizeBucketOf(20)  == 5;
+    return recorded && binned;
+}
+} // namespace
+} // namespace pl_test
@@ -1,5 +1,6 @@
 module;
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <numeric>
@@ -231,5 +232,27 @@ PL_STATIC_ASSERTION_TEST(test_move)
 
     static_assert(result == 24);
 }
+
+PL_STATIC_ASSERTION_TEST(test_appendAndOverwrite)
+{
+    constexpr auto result = []
+    {
+        ArrayList<unsigned> arr;
+        (void) arr.resize_for_overwrite(2);
+        arr[0] = 1;
+        arr[1] = 2;
+
+        // Writes fewer elements than requested, the rest must be dropped.
+        (void) arr.append_and_overwrite(8, [](Span<unsigned> tail)
+        {
+            std::iota(tail.begin(), tail.begin() + 3, 3u);
+            return std::size_t(3);
+        });
+
+        return std::accumulate(arr.begin(), arr.end(), 0u) * 100 + arr.size();
+    }();
+
+    static_assert(result == 1505);
+}
 } // namespace
 } // namespace pl_test
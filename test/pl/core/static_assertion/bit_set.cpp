@@ -0,0 +1,123 @@
+module;
+#include <cstddef>
+
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+PL_STATIC_ASSERTION_TEST(test_bitSetSingleBits)
+{
+    static_assert([]
+    {
+        BitSet<130> b;
+        b.set(0).set(64).set(129).flip(3).flip(3);
+        return b.test(0) && b.test(64) && b.test(129) && !b.test(3) && b.count() == 3;
+    }());
+
+    static_assert([]
+    {
+        BitSet<130> b;
+        b.set();
+        b.reset(7);
+        // Bits past size() stay clear.
+        return b.count() == 129 && !b.all() && b.set(7).all() && (~b).none();
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_bitSetOperators)
+{
+    static_assert([]
+    {
+        BitSet<100> a;
+        BitSet<100> b;
+        a.set(1).set(70).set(99);
+        b.set(70).set(80);
+        return (a & b).count() == 1
+            && (a | b).count() == 4
+            && (a ^ b).count() == 3
+            && BitSet<100>(a).and_not(b).count() == 2
+            && (~a).count() == 97
+            && (a & b) == BitSet<100>().set(70);
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_bitSetFind)
+{
+    static_assert([]
+    {
+        BitSet<200> b;
+        b.set(5).set(64).set(199);
+        return b.find_first() == 5
+            && b.find_next(5) == 5
+            && b.find_next(6) == 64
+            && b.find_next(65) == 199
+            && b.find_next(200) == b.npos
+            && BitSet<200>().find_first() == b.npos;
+    }());
+
+    static_assert([]
+    {
+        BitSet<200> b;
+        b.set(5).set(64).set(199);
+        std::size_t sum   = 0;
+        std::size_t count = 0;
+        for (std::size_t i : b.set_bits())
+        {
+            sum += i;
+            ++count;
+        }
+        return count == 3 && sum == 268;
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_dynamicBitSetResize)
+{
+    static_assert([]
+    {
+        DynamicBitSet<> b;
+        if (!b.resize(70, true)) return false;
+        if (b.count() != 70 || !b.all()) return false;
+
+        if (!b.resize(200)) return false;
+        if (b.count() != 70 || b.find_next(70) != b.npos) return false;
+
+        // Shrinking clears the bits past the new size, so that growing again exposes zeros.
+        b.set(150);
+        if (!b.resize(10)) return false;
+        if (!b.resize(300)) return false;
+        return b.size() == 300 && b.count() == 10 && b.find_next(10) == b.npos;
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_dynamicBitSetOperators)
+{
+    static_assert([]
+    {
+        DynamicBitSet<> a;
+        DynamicBitSet<> b;
+        if (!a.resize(300) || !b.resize(300)) return false;
+        a.set(0).set(128).set(299);
+        b.set(128).set(200);
+
+        a ^= b;
+        if (a.count() != 3 || a.test(128)) return false;
+        a.and_not(b);
+        if (a.count() != 2) return false;
+        a.flip();
+        if (a.count() != 298) return false;
+
+        std::size_t sum = 0;
+        for (std::size_t i : b.set_bits()) sum += i;
+        return sum == 328;
+    }());
+}
+} // namespace
+} // namespace pl_test
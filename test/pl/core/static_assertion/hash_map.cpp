@@ -0,0 +1,93 @@
+module;
+#include <string_view>
+#include <utility>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+PL_STATIC_ASSERTION_TEST(test_hashMapInsertFindErase)
+{
+    constexpr auto result = []
+    {
+        HashMap<int, int> map;
+        for (int i = 0; i < 1000; ++i)
+            (void) map.try_emplace(i, i * 2);
+
+        // Erasing every other key leaves tombstones that lookups must probe past.
+        for (int i = 0; i < 1000; i += 2)
+            (void) map.erase(i);
+
+        int sum = 0;
+        for (auto &[key, value] : map) sum += value - 2 * key;
+
+        bool found =
+            map.contains(999)
+         && !map.contains(998)
+         && **map.get(501) == 1002
+         && !map.get(2000);
+
+        auto [it, inserted] = *map.try_emplace(501, 0);
+        return sum == 0 && found && !inserted && it->second == 1002 && map.size() == 500;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_hashMapInsertOrAssign)
+{
+    constexpr auto result = []
+    {
+        HashMap<int, int> map;
+        (void) map.insert_or_assign(1, 10);
+        (void) map.insert_or_assign(1, 20);
+        (void) map.insert({2, 30});
+        return **map.get(1) + **map.get(2) + int(map.size());
+    }();
+    static_assert(result == 52);
+}
+
+PL_STATIC_ASSERTION_TEST(test_hashSetHeterogeneousLookup)
+{
+    constexpr auto result = []
+    {
+        HashSet<std::string_view> set;
+        (void) set.insert("VK_KHR_swapchain");
+        (void) set.insert("VK_EXT_debug_utils");
+        bool inserted = set.insert(std::string_view("VK_KHR_swapchain"))->second;
+
+        char const *name = "VK_EXT_debug_utils";
+        return !inserted && set.contains(name) && !set.contains("VK_KHR_surface") && set.size() == 2;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_hashMapSideEffects)
+{
+    constexpr auto result = []
+    {
+        SideEffectResult result;
+        {
+            HashMap<int, SideEffects> map;
+            for (int i = 0; i < 100; ++i)
+                (void) map.try_emplace(i, result);
+            for (int i = 0; i < 100; i += 3)
+                (void) map.erase(i);
+
+            HashMap<int, SideEffects> moved = std::move(map);
+            moved.clear();
+            (void) moved.try_emplace(0, result);
+        }
+        return result;
+    }();
+    static_assert(result.numRegularConstructorCalls() == 101);
+    static_assert(result.numTotalConstructorCalls() == result.numDestructorCalls());
+}
+} // namespace
+} // namespace pl_test
@@ -1,4 +1,6 @@
 module;
+#include <concepts>
+#include <cstddef>
 #include <memory>
 #include <numeric>
 #include <pl/test_macro.hpp>
@@ -26,6 +28,41 @@ PL_STATIC_ASSERTION_TEST(test_isValidAlignment)
     static_assert(isValidAlignment(16));
 }
 
+PL_STATIC_ASSERTION_TEST(test_alignUp)
+{
+    static_assert(alignUp(0, 8) == 0);
+    static_assert(alignUp(1, 8) == 8);
+    static_assert(alignUp(8, 8) == 8);
+    static_assert(alignUp(9, 16) == 16);
+    static_assert(alignUp(33, 32) == 64);
+}
+
+PL_STATIC_ASSERTION_TEST(test_defaultAllocator)
+{
+    struct alignas(64) CacheLine { char c; };
+    static_assert(std::same_as<default_allocator_t<int>, Mallocator>);
+    static_assert(std::same_as<default_allocator_t<CacheLine>, AlignedAllocator>);
+    static_assert(std::same_as<ArrayList<CacheLine>::allocator_type, AlignedAllocator>);
+}
+
+PL_STATIC_ASSERTION_TEST(test_isTriviallyRelocatable)
+{
+    struct NonTrivial { NonTrivial(NonTrivial const &); };
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(is_trivially_relocatable_v<std::byte>);
+    static_assert(!is_trivially_relocatable_v<NonTrivial>);
+    static_assert(is_trivially_relocatable_v<ArrayList<NonTrivial>>);
+}
+
+PL_STATIC_ASSERTION_TEST(test_allocatorExtensions)
+{
+    static_assert(reallocating_allocator<Mallocator>);
+    static_assert(!expanding_allocator<Mallocator>);
+    static_assert(expanding_allocator<ArenaAllocator<>>);
+    static_assert(!reallocating_allocator<ArenaAllocator<>>);
+    static_assert(!expanding_allocator<PoolAllocator<16>>);
+}
+
 PL_STATIC_ASSERTION_TEST(test_allocSingle)
 {
     constexpr auto result = []
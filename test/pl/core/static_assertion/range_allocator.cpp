@@ -0,0 +1,96 @@
+module;
+#include <cstdint>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+PL_STATIC_ASSERTION_TEST(test_rangeAllocatorAllocFree)
+{
+    constexpr auto result = []
+    {
+        RangeAllocator<> ranges(1024);
+        RangeAllocation a = *ranges.alloc(100);
+        RangeAllocation b = *ranges.alloc(200);
+        RangeAllocation c = *ranges.alloc(300);
+
+        bool packed = a.offset == 0 && b.offset == 100 && c.offset == 300;
+        bool used   = ranges.used() == 600 && ranges.num_allocations() == 3;
+
+        // Freeing b and then a merges them back into a single range at the start,
+        // which is a better fit for d than what is left after c.
+        ranges.free(b);
+        ranges.free(a);
+        RangeAllocation d = *ranges.alloc(288);
+
+        ranges.free(c);
+        ranges.free(d);
+        return packed && used && d.offset == 0 && ranges.empty() && ranges.available() == 1024;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_rangeAllocatorAlignment)
+{
+    constexpr auto result = []
+    {
+        RangeAllocator<> ranges(4096);
+        RangeAllocation a = *ranges.alloc(3);
+        RangeAllocation b = *ranges.alloc(64, 256);
+        RangeAllocation c = *ranges.alloc(1);
+
+        // The padding before b stays free, and is reused by allocations that fit it.
+        bool aligned = b.offset == 256 && c.offset < 256 && c.offset >= 3;
+
+        ranges.free(a);
+        ranges.free(b);
+        ranges.free(c);
+
+        // Everything merged back, so the whole range can be allocated at once.
+        RangeAllocation whole = *ranges.alloc(4096);
+        return aligned && whole.offset == 0 && !ranges.alloc(1);
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_rangeAllocatorExhausted)
+{
+    constexpr auto result = []
+    {
+        RangeAllocator<> ranges(1000);
+        bool tooLarge  = !ranges.alloc(1001) && !ranges.alloc(1000, 1024);
+        bool exactFit  = static_cast<bool>(ranges.alloc(1000));
+        auto full      = ranges.alloc(1);
+        bool exhausted = !full && &full.error().errorType() == &getSingleton<RangeExhausted>();
+        return tooLarge && exactFit && exhausted;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_rangeAllocatorReuse)
+{
+    constexpr auto result = []
+    {
+        RangeAllocator<> ranges(std::uint64_t(1) << 32);
+        RangeAllocation allocations[64];
+        for (int round = 0; round < 4; ++round)
+        {
+            for (int i = 0; i < 64; ++i)
+                allocations[i] = *ranges.alloc(std::uint64_t(i + 1) * 4096, 4096);
+            // Free every other allocation first, so that merging happens on both sides.
+            for (int i = 0; i < 64; i += 2) ranges.free(allocations[i]);
+            for (int i = 1; i < 64; i += 2) ranges.free(allocations[i]);
+        }
+        return ranges.empty() && ranges.used() == 0 && ranges.alloc(std::uint64_t(1) << 32)->offset == 0;
+    }();
+    static_assert(result);
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,80 @@
+module;
+#include <type_traits>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+class TestError : public SuberrorType<>
+{
+public:
+    using SuberrorType::SuberrorType;
+
+    [[nodiscard]]
+    constexpr char const *name() const noexcept override
+    {
+        return "TestError";
+    }
+};
+
+PL_STATIC_ASSERTION_TEST(test_resultErrorLayout)
+{
+    static_assert(sizeof(RE<Ptr<int>, SimpleError>) == 2 * sizeof(void *));
+    static_assert(sizeof(RE<void, SimpleError>) == sizeof(void *));
+    static_assert(sizeof(Opt<SimpleError>) == sizeof(void *));
+    static_assert(sizeof(Opt<NonZero<int>>) == sizeof(int));
+
+    // Trivially copyable results are returned in registers.
+    static_assert(std::is_trivially_copyable_v<RE<int, SimpleError>>);
+    static_assert(std::is_trivially_copyable_v<RE<Ptr<int>, SimpleError>>);
+    static_assert(std::is_trivially_copyable_v<RE<void, SimpleError>>);
+}
+
+PL_STATIC_ASSERTION_TEST(test_resultErrorVoid)
+{
+    static_assert([]
+    {
+        RE<void, SimpleError> re;
+        return re.has_value();
+    }());
+
+    static_assert([]
+    {
+        RE<void, SimpleError> re{tags::error, getSingleton<TestError>()};
+        return !re && &re.error().errorType() == &getSingleton<TestError>();
+    }());
+
+    static_assert([]
+    {
+        RE<void, SimpleError> re;
+        re = ErrorResult(SimpleError(getSingleton<TestError>()));
+        RE<void, SimpleError> copy = re;
+        return !copy && &copy.error().errorType() == &getSingleton<TestError>();
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_resultErrorTrivial)
+{
+    static_assert([]
+    {
+        RE<int, SimpleError> re = 42;
+        RE<int, SimpleError> copy = re;
+        copy = RE<int, SimpleError>(tags::error, getSingleton<TestError>());
+        return *re == 42 && !copy;
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_optionalNonZero)
+{
+    static_assert(![] { return Opt<NonZero<int>>().has_value(); }());
+    static_assert([] { return *Opt<NonZero<int>>(makeNonZero<3>()) == 3; }());
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,99 @@
+module;
+#include <cstddef>
+#include <cstdint>
+
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+// The scalar paths run in constant evaluation, both unrolled for static extents and looped for dynamic ones.
+
+PL_STATIC_ASSERTION_TEST(test_simdFillCopy)
+{
+    static_assert([]
+    {
+        int a[20] = {};
+        int b[20] = {};
+        simd::fill(Span(a), 7);
+        simd::copy(Span<int const>(a), Span<int>(b));
+        return b[0] == 7 && b[19] == 7;
+    }());
+
+    static_assert([]
+    {
+        int a[4] = {};
+        int b[4] = {};
+        simd::fill(Span(a), 3);
+        simd::copy(Span<int const, 4>(a), Span(b));
+        return b[0] == 3 && b[3] == 3;
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_simdTransform)
+{
+    static_assert([]
+    {
+        int a[5] = {1, 2, 3, 4, 5};
+        simd::transform(Span(a), Span(a), [](int x) { return x * x; });
+        return a[0] == 1 && a[4] == 25;
+    }());
+
+    static_assert([]
+    {
+        int const a[20] = {1, 2, 3};
+        int const b[20] = {4, 5, 6};
+        int c[20] = {};
+        simd::transform(Span<int const>(a), Span<int const>(b), Span<int>(c), [](int x, int y) { return x + y; });
+        return c[0] == 5 && c[2] == 9 && c[19] == 0;
+    }());
+}
+
+PL_STATIC_ASSERTION_TEST(test_simdReductions)
+{
+    static constexpr float f[5]  = {3.0f, -1.0f, 4.0f, 1.0f, -5.0f};
+    static constexpr int   i[20] = {3, -1, 4, 1, -5, 9, 2, 6};
+
+    static_assert(int(simd::sum(Span(f))) == 2);
+    static_assert(simd::sum(Span<int const>(i)) == 19);
+    static_assert(int(simd::min(Span(f))) == -5);
+    static_assert(simd::min(Span<int const>(i)) == -5);
+    static_assert(int(simd::max(Span(f))) == 4);
+    static_assert(simd::max(Span<int const>(i)) == 9);
+    static_assert(int(simd::dot(Span(f), Span(f))) == 52);
+    static_assert(simd::dot(Span<int const>(i), Span<int const>(i)) == 173);
+    static_assert(int(simd::reduce(Span(f), 1.0f, [](float a, float b) { return a * b; })) == 60);
+}
+
+PL_STATIC_ASSERTION_TEST(test_simdInclusiveScan)
+{
+    static_assert([]
+    {
+        int a[5] = {1, 2, 3, 4, 5};
+        simd::inclusive_scan(Span(a), Span(a));
+        return a[0] == 1 && a[1] == 3 && a[4] == 15;
+    }());
+
+    static_assert([]
+    {
+        float const a[20] = {1.0f, 2.0f, 3.0f};
+        float b[20] = {};
+        simd::inclusive_scan(Span<float const>(a), Span<float>(b));
+        return int(b[2]) == 6 && int(b[19]) == 6;
+    }());
+}
+PL_STATIC_ASSERTION_TEST(test_simdPopcount)
+{
+    static constexpr std::uint64_t words[3] = {0b1011, ~std::uint64_t(0), 0};
+    static_assert(simd::popcount(Span(words)) == 67);
+    static_assert(simd::popcount(Span<std::uint64_t const>(words)) == 67);
+}
+} // namespace
+} // namespace pl_test
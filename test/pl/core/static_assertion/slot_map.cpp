@@ -0,0 +1,81 @@
+module;
+#include <cstdint>
+#include <utility>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+PL_STATIC_ASSERTION_TEST(test_slotMapInsertErase)
+{
+    constexpr auto result = []
+    {
+        SlotMap<int> map;
+        SlotMap<int>::handle_type handles[8];
+        for (int i = 0; i < 8; ++i)
+            handles[i] = *map.insert(i);
+
+        (void) map.erase(handles[2]);
+        (void) map.erase(handles[5]);
+
+        int sum = 0;
+        for (int v : map) sum += v;
+
+        // Slot 5 is reused, but the handle to the erased value must not alias the new one.
+        auto reused = *map.insert(100);
+        bool stale =
+            !map.contains(handles[5])
+         && !map.get(handles[5])
+         && !map.erase(handles[2])
+         && reused.index() == handles[5].index();
+
+        return sum * 1000 + map[reused] + map[handles[7]] + int(map.size()) * stale;
+    }();
+    static_assert(result == 21 * 1000 + 100 + 7 + 7);
+}
+
+PL_STATIC_ASSERTION_TEST(test_slotMapHandleAt)
+{
+    constexpr auto result = []
+    {
+        SlotMap<int, Mallocator, std::uint32_t> map;
+        auto a = *map.insert(1);
+        auto b = *map.insert(2);
+        auto c = *map.insert(3);
+        (void) map.erase(a);
+
+        // c now lives where a used to.
+        return map.handle_at(0) == c && map.handle_at(1) == b && SlotMap<int>::handle_type().is_null();
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_slotMapUniqueHandle)
+{
+    constexpr auto result = []
+    {
+        SideEffectResult result;
+        {
+            SlotMap<SideEffects> map;
+            {
+                auto owned = *map.emplace_unique(result);
+                auto moved = std::move(owned);
+                (void) map.emplace(result);
+                if (owned || !moved || map.size() != 2) return SideEffectResult();
+            }
+            if (map.size() != 1) return SideEffectResult();
+        }
+        return result;
+    }();
+    static_assert(result.numRegularConstructorCalls() == 2);
+    static_assert(result.numTotalConstructorCalls() == result.numDestructorCalls());
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,93 @@
+module;
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+namespace rng = std::ranges;
+
+PL_STATIC_ASSERTION_TEST(test_smallInsertTrivial)
+{
+    constexpr auto result = []
+    {
+        SmallArrayList<int, 4> arr;
+        int a[] = {53, 43};
+        (void) arr.insert(arr.end(), std::begin(a), std::end(a));
+        int b[] = {12, 22, 67, 87, 34, 65};
+        (void) arr.insert(arr.begin() + 1, std::begin(b), std::end(b));
+        int answer[] = {53, 12, 22, 67, 87, 34, 65, 43};
+        return rng::equal(arr, answer);
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_smallInsertNonTrivial)
+{
+    constexpr auto result = []
+    {
+        SideEffectResult result;
+        {
+            SmallArrayList<SideEffects, 4> arr;
+            for (unsigned i = 0; i < 10; ++i)
+            {
+                Mallocator a;
+                auto effects = *new_<SideEffects>[2 * i](a, SideEffectsConstructor(result));
+
+                (void) arr.insert(arr.begin() + arr.size() / 2, effects.begin(), effects.end());
+                delete_(a, effects);
+            }
+            (void) arr.shrink_to_fit();
+        }
+        return result;
+    }();
+    static_assert(result.numTotalConstructorCalls() == result.numDestructorCalls());
+}
+
+PL_STATIC_ASSERTION_TEST(test_smallResize)
+{
+    constexpr auto result = []
+    {
+        SmallArrayList<unsigned, 2> arr;
+        (void) arr.resize(5);
+        std::iota(arr.begin(), arr.end(), 1u);
+        (void) arr.resize(3);
+        return std::accumulate(arr.begin(), arr.end(), 0u) + arr.size();
+    }();
+    static_assert(result == 9);
+}
+
+PL_STATIC_ASSERTION_TEST(test_smallMoveAndSwap)
+{
+    constexpr auto result = []
+    {
+        SmallArrayList<unsigned, 2> arr;
+        {
+            SmallArrayList<unsigned, 2> arr2;
+            int arr3[] = {3, 6, 2, 5, 8};
+            (void) arr2.append(std::begin(arr3), std::end(arr3));
+            arr = std::move(arr2);
+        }
+
+        SmallArrayList<unsigned, 2> arr4;
+        (void) arr4.push_back(100);
+        arr.swap(arr4);
+
+        return std::accumulate(arr4.begin(), arr4.end(), 0u) * 1000
+             + std::accumulate(arr.begin(), arr.end(), 0u);
+    }();
+
+    static_assert(result == 24100);
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,75 @@
+module;
+#include <numeric>
+#include <utility>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+
+PL_STATIC_ASSERTION_TEST(test_soaPushBackAndColumns)
+{
+    constexpr auto result = []
+    {
+        SoAArrayList<int, double> arr;
+        for (int i = 0; i < 10; ++i)
+            (void) arr.push_back(i, i * 0.5);
+
+        auto ints    = arr.column<0>();
+        auto doubles = arr.column<1>();
+        return std::accumulate(ints.begin(), ints.end(), 0)
+             + int(std::accumulate(doubles.begin(), doubles.end(), 0.0));
+    }();
+    static_assert(result == 45 + 22);
+}
+
+PL_STATIC_ASSERTION_TEST(test_soaRows)
+{
+    constexpr auto result = []
+    {
+        SoAArrayList<int, int> arr;
+        (void) arr.resize(5);
+        int i = 0;
+        for (auto [a, b] : arr)
+        {
+            a = i;
+            b = i * i;
+            ++i;
+        }
+        arr.swap_remove(1);
+
+        int sum = 0;
+        for (auto [a, b] : std::as_const(arr)) sum += a * 100 + b;
+        return sum + int(arr.size());
+    }();
+    // Rows 0, 4, 2, 3 remain.
+    static_assert(result == 900 + 29 + 4);
+}
+
+PL_STATIC_ASSERTION_TEST(test_soaSideEffects)
+{
+    constexpr auto result = []
+    {
+        SideEffectResult result;
+        {
+            SoAArrayList<SideEffects, int> arr;
+            for (int i = 0; i < 20; ++i)
+                (void) arr.emplace_back(result, i);
+            arr.pop_back();
+            arr.swap_remove(3);
+
+            SoAArrayList<SideEffects, int> moved = std::move(arr);
+            (void) moved.shrink_to_fit();
+        }
+        return result;
+    }();
+    static_assert(result.numTotalConstructorCalls() == result.numDestructorCalls());
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,102 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+namespace rng = std::ranges;
+
+static_assert(std::random_access_iterator<StableArrayList<int>::iterator>);
+static_assert(std::random_access_iterator<StableArrayList<int>::const_iterator>);
+static_assert(rng::random_access_range<StableArrayList<int>>);
+
+PL_STATIC_ASSERTION_TEST(test_stablePushBack)
+{
+    constexpr auto result = []
+    {
+        StableArrayList<int, 4> arr;
+        for (int i = 0; i < 10; ++i) (void) arr.push_back(i);
+        int answer[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        return rng::equal(arr, answer) && arr[9] == 9 && arr.back() == 9 && arr.capacity() == 12;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_stableNoRelocation)
+{
+    constexpr auto result = []
+    {
+        StableArrayList<int, 4> arr;
+        (void) arr.push_back(42);
+        int *first = &arr.front();
+        auto it    = arr.begin();
+        for (int i = 0; i < 100; ++i) (void) arr.push_back(i);
+        return first == &arr[0] && &*it == first && *first == 42;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_stableChunks)
+{
+    constexpr auto result = []
+    {
+        StableArrayList<int, 4> arr;
+        for (int i = 0; i < 10; ++i) (void) arr.push_back(i);
+        if (arr.num_chunks() != 3 || arr.chunk(0).size() != 4 || arr.chunk(2).size() != 2) return false;
+        if (arr.chunk(1)[0] != 4) return false;
+
+        int sum = 0;
+        arr.for_each_chunk([&](Span<int> chunk) { for (int x : chunk) sum += x; });
+        return sum == 45;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_stableResize)
+{
+    constexpr auto result = []
+    {
+        StableArrayList<int, 4> arr;
+        (void) arr.resize(9);
+        if (arr.size() != 9 || arr[8] != 0) return false;
+        (void) arr.resize(3);
+        arr.shrink_to_fit();
+        if (arr.size() != 3 || arr.capacity() != 4) return false;
+        arr.clear();
+        return arr.empty() && arr.capacity() == 4;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_stableNonTrivial)
+{
+    constexpr auto result = []
+    {
+        SideEffectResult result;
+        {
+            StableArrayList<SideEffects, 4> arr;
+            for (int i = 0; i < 10; ++i) (void) arr.emplace_back(result);
+            arr.pop_back();
+
+            StableArrayList<SideEffects, 4> moved = std::move(arr);
+            (void) arr.emplace_back(result);
+            arr = std::move(moved);
+        }
+        return result;
+    }();
+    // Moving the list never moves its elements.
+    static_assert(result.numTotalConstructorCalls() == 11);
+    static_assert(result.numTotalConstructorCalls() == result.numDestructorCalls());
+}
+} // namespace
+} // namespace pl_test
@@ -0,0 +1,105 @@
+module;
+#include <cstddef>
+
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+import pl.ecs;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+using namespace pl::ecs;
+
+struct Position { int x, y; };
+struct Velocity { int x, y; };
+struct Frozen   {};
+
+using TestWorld = World<Position, Velocity, Frozen>;
+
+PL_STATIC_ASSERTION_TEST(test_worldCreateDestroy)
+{
+    constexpr auto result = []
+    {
+        TestWorld world;
+        Entity a = *world.create(Position{1, 2}, Velocity{3, 4});
+        Entity b = *world.create(Position{5, 6});
+        Entity c = *world.create(Velocity{0, 0}, Position{7, 8});
+        if (world.size() != 3 || world.num_archetypes() != 2) return false;
+
+        // Destroying a moves c into its row, which must keep c reachable.
+        if (!world.destroy(a)) return false;
+        if (world.destroy(a) || world.contains(a)) return false;
+
+        Position const *p = *world.get<Position>(c);
+        return p->x == 7 && world.has<Velocity>(c) && !world.has<Velocity>(b) && world.size() == 2;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_worldAddRemove)
+{
+    constexpr auto result = []
+    {
+        TestWorld world;
+        Entity a = *world.create(Position{1, 1});
+        Entity b = *world.create(Position{2, 2});
+
+        if (!world.add<Velocity>(a, 5, 5)) return false;
+        if (!world.has<Velocity>(a) || world.num_archetypes() != 2) return false;
+
+        // Goes through the edge cached by the first add.
+        if (!world.add<Velocity>(b, 6, 6)) return false;
+        if (world.num_archetypes() != 2) return false;
+
+        // Replaces the existing component.
+        if (!world.add<Velocity>(b, 7, 7)) return false;
+
+        if (!world.remove<Velocity>(a)) return false;
+        if (!world.remove<Frozen>(a)) return false;
+
+        Position const *pa = *world.get<Position>(a);
+        Position const *pb = *world.get<Position>(b);
+        Velocity const *vb = *world.get<Velocity>(b);
+        return !world.has<Velocity>(a) && pa->x == 1 && pb->x == 2 && vb->x == 7;
+    }();
+    static_assert(result);
+}
+
+PL_STATIC_ASSERTION_TEST(test_worldQuery)
+{
+    constexpr auto result = []
+    {
+        TestWorld world;
+        for (int i = 0; i < 10; ++i) (void) world.create(Position{i, 0}, Velocity{1, 2});
+        for (int i = 0; i < 5; ++i)  (void) world.create(Position{i, 0});
+
+        auto moving = world.query<Position, Velocity const>();
+        (void) moving.for_each([](Position &p, Velocity const &v)
+        {
+            p.x += v.x;
+            p.y += v.y;
+        });
+
+        // Archetypes created after the query are picked up by its next iteration.
+        (void) world.create(Position{100, 0}, Velocity{1, 1}, Frozen{});
+        if (*moving.count() != 11) return false;
+
+        int sum = 0;
+        std::size_t chunks = 0;
+        (void) world.query<Position const>().for_each_chunk([&](Span<Entity const> entities, Span<Position const> positions)
+        {
+            ++chunks;
+            for (std::size_t i = 0; i < entities.size(); ++i) sum += positions[i].x;
+        });
+        // 0 + ... + 9 moved by 1 each, 0 + ... + 4, and 100.
+        return sum == 55 + 10 + 100 && chunks == 3;
+    }();
+    static_assert(result);
+}
+} // namespace
+} // namespace pl_test
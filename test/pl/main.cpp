@@ -1,6 +1,9 @@
 #include <iostream>
 
+import pl.core.test;
+
+// Static assertion tests have already passed by the time this is compiled, so only runtime tests are left.
 int main()
 {
-    std::cout << "Hello, World!\n";
+    return pl_test::runTests(std::clog) == 0 ? 0 : 1;
 }
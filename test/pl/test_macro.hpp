@@ -2,3 +2,8 @@
 
 #define PL_STATIC_ASSERTION_TEST(name) \
 [[maybe_unused]] void name()
+
+#define PL_TEST(name) \
+bool name(); \
+::pl_test::TestRegistration const name##_registration(#name, name); \
+bool name()
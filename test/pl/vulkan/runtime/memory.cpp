@@ -0,0 +1,273 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vulkan/vulkan.h>
+#include <pl/macro.hpp>
+#include <pl/test_macro.hpp>
+
+module pl.core.test;
+
+import pl.core;
+import pl.vulkan;
+
+namespace pl_test
+{
+namespace
+{
+using namespace pl;
+using namespace pl::vulkan;
+
+// An instance and a device without any surface, which is all DeviceMemoryAllocator needs,
+// so that these tests also run on headless machines with a software driver such as lavapipe.
+class HeadlessDevice
+{
+public:
+    HeadlessDevice() = default;
+
+    HeadlessDevice           (HeadlessDevice const &) = delete;
+    HeadlessDevice &operator=(HeadlessDevice const &) = delete;
+
+    ~HeadlessDevice()
+    {
+        if (_device)   vkDestroyDevice(_device, {});
+        if (_instance) vkDestroyInstance(_instance, {});
+    }
+
+    // Returns false if there is no Vulkan driver, or no device, in which case the tests are skipped.
+    [[nodiscard]]
+    bool init() noexcept
+    {
+        VkApplicationInfo applicationInfo = {
+            .sType              = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+            .pNext              = {},
+            .pApplicationName   = "libpl_test",
+            .applicationVersion = 0,
+            .pEngineName        = {},
+            .engineVersion      = 0,
+            .apiVersion         = VK_API_VERSION_1_1,
+        };
+        VkInstanceCreateInfo instanceInfo = {
+            .sType                   = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+            .pNext                   = {},
+            .flags                   = 0,
+            .pApplicationInfo        = &applicationInfo,
+            .enabledLayerCount       = 0,
+            .ppEnabledLayerNames     = {},
+            .enabledExtensionCount   = 0,
+            .ppEnabledExtensionNames = {},
+        };
+        if (vkCreateInstance(&instanceInfo, {}, &_instance) != VK_SUCCESS)
+        {
+            _instance = {};
+            return false;
+        }
+
+        std::uint32_t numDevices = 1;
+        VkResult result = vkEnumeratePhysicalDevices(_instance, &numDevices, &_physicalDevice);
+        if ((result != VK_SUCCESS && result != VK_INCOMPLETE) || numDevices == 0) return false;
+
+        // Any queue will do, the tests never submit work.
+        float priority = 1.0f;
+        VkDeviceQueueCreateInfo queueInfo = {
+            .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .pNext            = {},
+            .flags            = 0,
+            .queueFamilyIndex = 0,
+            .queueCount       = 1,
+            .pQueuePriorities = &priority,
+        };
+        VkDeviceCreateInfo deviceInfo = {
+            .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .pNext                   = {},
+            .flags                   = 0,
+            .queueCreateInfoCount    = 1,
+            .pQueueCreateInfos       = &queueInfo,
+            .enabledLayerCount       = 0,
+            .ppEnabledLayerNames     = {},
+            .enabledExtensionCount   = 0,
+            .ppEnabledExtensionNames = {},
+            .pEnabledFeatures        = {},
+        };
+        if (vkCreateDevice(_physicalDevice, &deviceInfo, {}, &_device) != VK_SUCCESS)
+        {
+            _device = {};
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] VkPhysicalDevice physicalDevice() const noexcept { return _physicalDevice; }
+    [[nodiscard]] VkDevice         device()         const noexcept { return _device;         }
+
+private:
+    VkInstance       _instance       = {};
+    VkPhysicalDevice _physicalDevice = {};
+    VkDevice         _device         = {};
+};
+
+// Mirrors the block size DeviceMemoryAllocator picks for a memory type.
+[[nodiscard]]
+VkDeviceSize blockSizeOf(VkPhysicalDevice physicalDevice, std::uint32_t memoryType) noexcept
+{
+    VkPhysicalDeviceMemoryProperties properties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &properties);
+    VkDeviceSize heapSize = properties.memoryHeaps[properties.memoryTypes[memoryType].heapIndex].size;
+    return heapSize > DeviceMemoryAllocator::smallHeapSize ? DeviceMemoryAllocator::largeHeapBlockSize : heapSize / 8;
+}
+
+[[nodiscard]]
+bool overlaps(DeviceAllocation const &a, DeviceAllocation const &b) noexcept
+{
+    return a.memory == b.memory && a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+
+constexpr std::uint32_t anyMemoryType = ~std::uint32_t(0);
+
+PL_TEST(test_deviceMemoryAlignmentAndGranularity)
+{
+    HeadlessDevice headless;
+    if (!headless.init())
+    {
+        std::clog << "test_deviceMemoryAlignmentAndGranularity skipped, there is no Vulkan device\n";
+        return true;
+    }
+
+    DeviceMemoryAllocator allocator;
+    if (!allocator.init(headless.physicalDevice(), headless.device())) return false;
+    PL_DEFER(allocator.deinit());
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(headless.physicalDevice(), &properties);
+    VkDeviceSize granularity = std::max<VkDeviceSize>(properties.limits.bufferImageGranularity, 1);
+
+    // The size is not a multiple of the alignment, so every allocation but the first would be misaligned
+    // unless it were padded.
+    constexpr std::size_t  numAllocations = 8;
+    constexpr VkDeviceSize alignment      = 256;
+    DeviceAllocation linear[numAllocations];
+    for (DeviceAllocation &allocation : linear)
+    {
+        RE<DeviceAllocation, SimpleError> result =
+            allocator.alloc({.size = 100, .alignment = alignment, .memoryTypeBits = anyMemoryType},
+                MemoryUsage::deviceLocal, ResourceKind::linear);
+        if (!result || result->offset % alignment != 0 || result->size < 100) return false;
+        allocation = *result;
+    }
+
+    RE<DeviceAllocation, SimpleError> optimal =
+        allocator.alloc({.size = 100, .alignment = 1, .memoryTypeBits = anyMemoryType},
+            MemoryUsage::deviceLocal, ResourceKind::optimal);
+    if (!optimal) return false;
+
+    bool ok = true;
+    for (std::size_t i = 0; i < numAllocations; ++i)
+    {
+        for (std::size_t j = i + 1; j < numAllocations; ++j)
+            ok = ok && !overlaps(linear[i], linear[j]);
+
+        // Linear and optimal neighbours never share a granularity page.
+        DeviceAllocation const &a = linear[i];
+        if (a.memory == optimal->memory && granularity > 1)
+        {
+            ok = ok
+                && (a.offset + a.size - 1) / granularity != optimal->offset / granularity
+                && (optimal->offset + optimal->size - 1) / granularity != a.offset / granularity;
+        }
+        ok = ok && !overlaps(a, *optimal);
+    }
+
+    for (DeviceAllocation const &allocation : linear) allocator.free(allocation);
+    allocator.free(*optimal);
+    return ok && allocator.totalStats().numAllocations == 0 && allocator.totalStats().allocatedBytes == 0;
+}
+
+PL_TEST(test_deviceMemoryDedicatedAndEmptyBlocks)
+{
+    HeadlessDevice headless;
+    if (!headless.init())
+    {
+        std::clog << "test_deviceMemoryDedicatedAndEmptyBlocks skipped, there is no Vulkan device\n";
+        return true;
+    }
+
+    DeviceMemoryAllocator allocator;
+    if (!allocator.init(headless.physicalDevice(), headless.device())) return false;
+    PL_DEFER(allocator.deinit());
+
+    Opt<std::uint32_t> memoryType = allocator.findMemoryType(anyMemoryType, MemoryUsage::deviceLocal);
+    if (!memoryType) return false;
+    VkDeviceSize blockSize = blockSizeOf(headless.physicalDevice(), *memoryType);
+
+    // More than half a block gets its own VkDeviceMemory.
+    RE<DeviceAllocation, SimpleError> dedicated =
+        allocator.alloc({.size = blockSize / 2 + 1, .alignment = 1, .memoryTypeBits = anyMemoryType},
+            MemoryUsage::deviceLocal, ResourceKind::linear);
+    if (!dedicated || dedicated->block != DeviceMemoryAllocator::dedicatedBlock || dedicated->offset != 0)
+        return false;
+    if (allocator.stats(*memoryType).numBlocks != 1) return false;
+    allocator.free(*dedicated);
+    if (allocator.stats(*memoryType).numBlocks != 0 || allocator.stats(*memoryType).blockBytes != 0) return false;
+
+    // Four quarters fill a block, so these spread over three blocks.
+    constexpr std::size_t numQuarters = 12;
+    DeviceAllocation quarters[numQuarters];
+    for (DeviceAllocation &quarter : quarters)
+    {
+        RE<DeviceAllocation, SimpleError> result =
+            allocator.alloc({.size = blockSize / 4, .alignment = 1, .memoryTypeBits = anyMemoryType},
+                MemoryUsage::deviceLocal, ResourceKind::linear);
+        if (!result || result->block == DeviceMemoryAllocator::dedicatedBlock) return false;
+        quarter = *result;
+    }
+    if (allocator.stats(*memoryType).numBlocks < 3) return false;
+
+    // Emptied blocks are returned to the driver, except for the last one.
+    for (DeviceAllocation const &quarter : quarters) allocator.free(quarter);
+    DeviceMemoryStats const &stats = allocator.stats(*memoryType);
+    return stats.numBlocks == 1 && stats.blockBytes == blockSize
+        && stats.numAllocations == 0 && stats.allocatedBytes == 0;
+}
+
+PL_TEST(test_deviceMemoryBuffer)
+{
+    HeadlessDevice headless;
+    if (!headless.init())
+    {
+        std::clog << "test_deviceMemoryBuffer skipped, there is no Vulkan device\n";
+        return true;
+    }
+
+    DeviceMemoryAllocator allocator;
+    if (!allocator.init(headless.physicalDevice(), headless.device())) return false;
+    PL_DEFER(allocator.deinit());
+
+    VkBufferCreateInfo bufferInfo = {
+        .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext                 = {},
+        .flags                 = 0,
+        .size                  = 64 * 1024,
+        .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices   = {},
+    };
+    RE<Buffer, SimpleError> buffer = allocator.createBuffer(bufferInfo, MemoryUsage::upload);
+    if (!buffer || !buffer->allocation.mapped) return false;
+
+    std::uint32_t memoryType = buffer->allocation.memoryType;
+    if (allocator.stats(memoryType).numAllocations != 1
+     || allocator.stats(memoryType).allocatedBytes < bufferInfo.size) return false;
+
+    // Upload memory stays mapped, and writes to it only need a flush if it is not coherent.
+    buffer->allocation.mapped[0] = std::byte(1);
+    buffer->allocation.mapped[bufferInfo.size - 1] = std::byte(2);
+    if (!allocator.flush(buffer->allocation)) return false;
+
+    allocator.destroyBuffer(*buffer);
+    DeviceMemoryStats const &stats = allocator.stats(memoryType);
+    return stats.numAllocations == 0 && stats.allocatedBytes == 0;
+}
+} // namespace
+} // namespace pl_test